@@ -69,6 +69,7 @@ class C4LChunk;
 class C4League;
 class C4LoaderScreen;
 class C4LSector;
+class C4LSectorList;
 class C4LSectors;
 class C4MainMenu;
 class C4MapCreatorS2;
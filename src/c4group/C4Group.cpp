@@ -59,6 +59,7 @@ int iC4GroupRewindFilePtrNoWarn=0;
 char C4Group_TempPath[_MAX_PATH+1]="";
 char C4Group_Ignore[_MAX_PATH+1]="cvs;CVS;Thumbs.db;.orig;.svn";
 const char **C4Group_SortList = nullptr;
+int C4Group_FileVer2 = C4GroupFileVer2;
 bool (*C4Group_ProcessCallback)(const char *, int)=nullptr;
 
 void C4Group_SetProcessCallback(bool (*fnCallback)(const char *, int))
@@ -71,6 +72,11 @@ void C4Group_SetSortList(const char **ppSortList)
 	C4Group_SortList = ppSortList;
 }
 
+void C4Group_SetFileVersion(int iVer2)
+{
+	C4Group_FileVer2 = iVer2;
+}
+
 void C4Group_SetTempPath(const char *szPath)
 {
 	if (!szPath || !szPath[0]) C4Group_TempPath[0]=0;
@@ -429,9 +435,12 @@ struct C4Group::P
 	int FilePtr = 0;
 	int MotherOffset = 0;
 	int EntryOffset = 0;
+	bool RandomAccess = false; // group data can be seeked to directly (plain indexed group file or child of one)
 	bool Modified = false;
 	C4GroupEntry *FirstEntry = nullptr;
 	BYTE *pInMemEntry = nullptr; size_t iInMemEntrySize = 0; // for reading from entries prefetched into memory
+	StdCopyBuf UnpackedEntry; // last accessed compressed entry of an indexed group
+	std::shared_ptr<CStdFileMapping> Mapping; // of the group file, for LoadEntryView
 #ifdef _DEBUG
 	StdStrBuf sPrevAccessedEntry;
 #endif
@@ -487,6 +496,7 @@ void C4Group::Init()
 	new_p->StdOutput = p->StdOutput;
 
 	InplaceReconstruct(&Head);
+	Head.Ver2 = C4Group_FileVer2;
 	p = std::move(new_p);
 }
 
@@ -604,8 +614,12 @@ bool C4Group::OpenRealGrpFile()
 	int cnt,file_entries;
 	C4GroupEntryCore corebuf;
 
-	// Open StdFile
-	if (!p->StdFile.Open(GetName(),true)) return Error("OpenRealGrpFile: Cannot open standard file");
+	// Open StdFile: Classic groups are compressed as a whole, indexed groups are plain files
+	if (!p->StdFile.Open(GetName(),true))
+	{
+		if (!p->StdFile.Open(GetName(),false)) return Error("OpenRealGrpFile: Cannot open standard file");
+		p->RandomAccess = true;
+	}
 
 	// Read header
 	if (!p->StdFile.Read((BYTE*)&Head,sizeof(C4GroupHeader))) return Error("OpenRealGrpFile: Error reading header");
@@ -614,10 +628,12 @@ bool C4Group::OpenRealGrpFile()
 
 	// Check Header
 	if (!SEqual(Head.id,C4GroupFileID)
-	    || (Head.Ver1!=C4GroupFileVer1) || (Head.Ver2>C4GroupFileVer2))
+	    || (Head.Ver1!=C4GroupFileVer1) || (Head.Ver2>C4GroupFileVer2Indexed)
+	    || (p->RandomAccess && Head.Ver2!=C4GroupFileVer2Indexed))
 		return Error("OpenRealGrpFile: Invalid header");
 
 	// Read Entries
+	C4GroupEntry *centry = nullptr;
 	file_entries=Head.Entries;
 	Head.Entries=0; // Reset, will be recounted by AddEntry
 	for (cnt=0; cnt<file_entries; cnt++)
@@ -635,11 +651,24 @@ bool C4Group::OpenRealGrpFile()
 		              nullptr, false, false,
 		              !!corebuf.Executable))
 			return Error("OpenRealGrpFile: Cannot add entry");
+		centry = centry ? centry->Next : p->FirstEntry;
+		SetIndexedCore(centry, corebuf);
 	}
 
 	return true;
 }
 
+void C4Group::SetIndexedCore(C4GroupEntry *centry, const C4GroupEntryCore &core)
+{
+	// Only indexed groups store compressed sizes and checksums; offsets are recomputed for the others
+	if (Head.Ver2 != C4GroupFileVer2Indexed) return;
+	centry->Packed = core.Packed;
+	centry->StoredSize = core.StoredSize;
+	centry->Offset = core.Offset;
+	centry->HasCRC = core.HasCRC;
+	centry->CRC = core.CRC;
+}
+
 bool C4Group::AddEntry(C4GroupEntry::EntryStatus status,
                        bool childgroup,
                        const char *fname,
@@ -775,9 +804,9 @@ bool C4Group::Close()
 
 	if (p->StdOutput) printf("Writing group file...\n");
 
-	// Set new version
+	// Set new version (indexed groups stay indexed)
 	Head.Ver1=C4GroupFileVer1;
-	Head.Ver2=C4GroupFileVer2;
+	if (Head.Ver2!=C4GroupFileVer2Indexed) Head.Ver2=C4GroupFileVer2;
 
 	// Automatic sort
 	SortByList(C4Group_SortList);
@@ -834,28 +863,40 @@ bool C4Group::Save(bool fReOpen)
 	}
 
 	// Create the new (temp) group file
+	// Indexed groups are not compressed as a whole; children are moved to the mother as regular group files, though.
+	bool fIndexed = (Head.Ver2 == C4GroupFileVer2Indexed);
 	CStdFile tfile;
-	if (!tfile.Create(szTempFileName,true,false,fToMemory))
+	if (!tfile.Create(szTempFileName,!fIndexed || p->Mother,false,fToMemory))
 		{  delete [] save_core; return Error("Close: ..."); }
 
-	// Save header and core list
-	C4GroupHeader headbuf = Head;
-	MemScramble((BYTE*)&headbuf,sizeof(C4GroupHeader));
-	if (!tfile.Write((BYTE*)&headbuf,sizeof(C4GroupHeader))
-	    || !tfile.Write((BYTE*)save_core,Head.Entries*sizeof(C4GroupEntryCore)))
-		{ tfile.Close(); delete [] save_core; return Error("Close: ..."); }
-	delete [] save_core;
-
-	// Save Entries to temp file
-	int iTotalSize=0,iSizeDone=0;
-	for (centry=p->FirstEntry; centry; centry=centry->Next) iTotalSize+=centry->Size;
-	for (centry=p->FirstEntry; centry; centry=centry->Next)
-		if (AppendEntry2StdFile(centry,tfile))
-			{ iSizeDone+=centry->Size; if (iTotalSize && p->fnProcessCallback) p->fnProcessCallback(centry->FileName,100*iSizeDone/iTotalSize); }
-		else
-		{
-			tfile.Close(); return false;
-		}
+	if (fIndexed)
+	{
+		// Indexed: cores depend on the compressed entry sizes
+		bool fSuccess = SaveIndexedContents(tfile, save_core, fToMemory || iContentsSize < C4GroupSwapThreshold);
+		delete [] save_core;
+		if (!fSuccess) { tfile.Close(); return false; }
+	}
+	else
+	{
+		// Save header and core list
+		C4GroupHeader headbuf = Head;
+		MemScramble((BYTE*)&headbuf,sizeof(C4GroupHeader));
+		if (!tfile.Write((BYTE*)&headbuf,sizeof(C4GroupHeader))
+		    || !tfile.Write((BYTE*)save_core,Head.Entries*sizeof(C4GroupEntryCore)))
+			{ tfile.Close(); delete [] save_core; return Error("Close: ..."); }
+		delete [] save_core;
+
+		// Save Entries to temp file
+		int iTotalSize=0,iSizeDone=0;
+		for (centry=p->FirstEntry; centry; centry=centry->Next) iTotalSize+=centry->Size;
+		for (centry=p->FirstEntry; centry; centry=centry->Next)
+			if (AppendEntry2StdFile(centry,tfile))
+				{ iSizeDone+=centry->Size; if (iTotalSize && p->fnProcessCallback) p->fnProcessCallback(centry->FileName,100*iSizeDone/iTotalSize); }
+			else
+			{
+				tfile.Close(); return false;
+			}
+	}
 
 	// Write
 	StdBuf *pBuf;
@@ -895,6 +936,107 @@ bool C4Group::Save(bool fReOpen)
 	return true;
 }
 
+bool C4Group::SaveIndexedContents(CStdFile &hTarget, C4GroupEntryCore *save_core, bool fToMemory)
+{
+	// Pack entry data to a temp file first, because the core list preceding it
+	// holds the offsets and sizes after compression
+	char szDataFileName[_MAX_FNAME+1] = "";
+	if (!fToMemory)
+	{
+		if (C4Group_TempPath[0]) { SCopy(C4Group_TempPath,szDataFileName,_MAX_FNAME); SAppend(GetFilename(GetName()),szDataFileName,_MAX_FNAME); }
+		else SCopy(GetName(),szDataFileName,_MAX_FNAME);
+		SAppend(".dat",szDataFileName,_MAX_FNAME);
+		MakeTempFilename(szDataFileName);
+	}
+	CStdFile dfile;
+	if (!dfile.Create(szDataFileName,false,false,fToMemory))
+		return Error("Close: Cannot create temp file");
+
+	int iTotalSize=0,iSizeDone=0;
+	int32_t iDataSize=0;
+	C4GroupEntry *centry;
+	for (centry=p->FirstEntry; centry; centry=centry->Next) iTotalSize+=centry->Size;
+	int cscore=0;
+	bool fSuccess=true;
+	for (centry=p->FirstEntry; fSuccess && centry; centry=centry->Next)
+	{
+		if (centry->Status == C4GroupEntry::C4GRES_Deleted) continue;
+		C4GroupEntryCore &core = save_core[cscore++];
+		core.Offset = iDataSize;
+		core.Packed = false; core.HasCRC = false; core.CRC = 0;
+		if (centry->ChildGroup)
+		{
+			// Child groups are stored as they are so they can be opened in place
+			fSuccess = AppendEntry2StdFile(centry,dfile);
+			core.StoredSize = centry->Size;
+		}
+		else if (centry->Status == C4GroupEntry::C4GRES_InGroup && centry->Packed)
+		{
+			// Keep already compressed data
+			StdBuf packed; packed.New(centry->StoredSize);
+			fSuccess = SetFilePtr(centry->Offset) && Read(packed.getMData(), packed.getSize())
+			           && dfile.Write(packed.getData(), packed.getSize());
+			core.Packed = true; core.StoredSize = centry->StoredSize;
+			core.HasCRC = centry->HasCRC; core.CRC = centry->CRC;
+		}
+		else
+		{
+			// Get contents and compress them if that saves a significant amount of space
+			// (already compressed data is better left as it is so it can be mapped into memory)
+			CStdFile mfile; StdBuf *pBuf = nullptr;
+			fSuccess = mfile.Create(nullptr,false,false,true) && AppendEntry2StdFile(centry,mfile);
+			mfile.Close(&pBuf);
+			if (!fSuccess) { delete pBuf; break; }
+			core.Size = pBuf->getSize();
+			core.HasCRC = true;
+			core.CRC = crc32(0, static_cast<const Bytef *>(pBuf->getData()), pBuf->getSize());
+			uLongf iPackedSize = compressBound(pBuf->getSize());
+			StdBuf packed; packed.New(iPackedSize);
+			if (pBuf->getSize()
+			    && compress2(static_cast<Bytef *>(packed.getMData()), &iPackedSize, static_cast<const Bytef *>(pBuf->getData()), pBuf->getSize(), Z_DEFAULT_COMPRESSION) == Z_OK
+			    && iPackedSize < pBuf->getSize() - pBuf->getSize() / 8)
+			{
+				core.Packed = true; core.StoredSize = iPackedSize;
+				fSuccess = dfile.Write(packed.getData(), iPackedSize);
+			}
+			else
+			{
+				core.StoredSize = pBuf->getSize();
+				fSuccess = !pBuf->getSize() || dfile.Write(pBuf->getData(), pBuf->getSize());
+			}
+			delete pBuf;
+		}
+		iDataSize += core.StoredSize;
+		iSizeDone+=centry->Size; if (iTotalSize && p->fnProcessCallback) p->fnProcessCallback(centry->FileName,100*iSizeDone/iTotalSize);
+	}
+	StdBuf *pData = nullptr;
+	dfile.Close(fToMemory ? &pData : nullptr);
+
+	// Save header, core list and data
+	C4GroupHeader headbuf = Head;
+	MemScramble((BYTE*)&headbuf,sizeof(C4GroupHeader));
+	if (fSuccess)
+		fSuccess = hTarget.Write((BYTE*)&headbuf,sizeof(C4GroupHeader))
+		           && hTarget.Write((BYTE*)save_core,Head.Entries*sizeof(C4GroupEntryCore));
+	if (fSuccess && fToMemory)
+		fSuccess = !pData->getSize() || hTarget.Write(pData->getData(), pData->getSize());
+	else if (fSuccess)
+	{
+		BYTE buf[CStdFileBufSize];
+		fSuccess = dfile.Open(szDataFileName);
+		for (int32_t iLeft = iDataSize; fSuccess && iLeft > 0; iLeft -= sizeof(buf))
+		{
+			size_t iChunk = std::min<size_t>(iLeft, sizeof(buf));
+			fSuccess = dfile.Read(buf, iChunk) && hTarget.Write(buf, iChunk);
+		}
+		dfile.Close();
+	}
+	delete pData;
+	if (!fToMemory) EraseFile(szDataFileName);
+	if (!fSuccess) return Error("Close: Cannot write indexed group data");
+	return true;
+}
+
 void C4Group::Clear()
 {
 	if (p)
@@ -930,6 +1072,14 @@ bool C4Group::AppendEntry2StdFile(C4GroupEntry *centry, CStdFile &hTarget)
 	{
 
 	case C4GroupEntry::C4GRES_InGroup: // Copy from group to std file
+		if (centry->Packed)
+		{
+			StdBuf buf;
+			if (!UnpackEntry(centry, buf)) return false;
+			if (!hTarget.Write(buf.getData(), buf.getSize()))
+				return Error("AE2S: Cannot write to target file");
+			break;
+		}
 		if (!SetFilePtr(centry->Offset))
 			return Error("AE2S: Cannot set file pointer");
 		for (csize=centry->Size; csize>0; csize--)
@@ -973,8 +1123,10 @@ bool C4Group::AppendEntry2StdFile(C4GroupEntry *centry, CStdFile &hTarget)
 				}
 
 		// Append disk source to target file
+		// (Indexed group files are not compressed as a whole)
 		if (!hSource.Open(szFileSource, !!centry->ChildGroup))
-			return Error("AE2S: Cannot open on-disk file");
+			if (!centry->ChildGroup || !hSource.Open(szFileSource, false))
+				return Error("AE2S: Cannot open on-disk file");
 		for (csize=centry->Size; csize>0; csize--)
 		{
 			if (!hSource.Read(&fbuf,1))
@@ -1010,6 +1162,23 @@ bool C4Group::AppendEntry2StdFile(C4GroupEntry *centry, CStdFile &hTarget)
 	return true;
 }
 
+bool C4Group::UnpackEntry(C4GroupEntry *centry, StdBuf &rBuf)
+{
+	// Read compressed data
+	StdBuf packed; packed.New(centry->StoredSize);
+	if (!SetFilePtr(centry->Offset) || !Read(packed.getMData(), packed.getSize()))
+		return Error("UnpackEntry: Cannot read entry");
+	// Inflate
+	rBuf.New(centry->Size);
+	uLongf iSize = rBuf.getSize();
+	if (uncompress(static_cast<Bytef *>(rBuf.getMData()), &iSize, static_cast<const Bytef *>(packed.getData()), packed.getSize()) != Z_OK
+	    || iSize != rBuf.getSize())
+		{ rBuf.Clear(); return Error("UnpackEntry: Corrupt entry data"); }
+	if (centry->HasCRC && crc32(0, static_cast<const Bytef *>(rBuf.getData()), rBuf.getSize()) != centry->CRC)
+		{ rBuf.Clear(); return Error("UnpackEntry: Checksum mismatch"); }
+	return true;
+}
+
 void C4Group::ResetSearch(bool reload_contents)
 {
 	switch (p->SourceType)
@@ -1088,6 +1257,33 @@ bool C4Group::SetFilePtr(int iOffset)
 	if (p->SourceType==P::ST_Unpacked)
 		return Error("SetFilePtr not implemented for Folders");
 
+	// Raw access: do not serve reads from a previously accessed in-memory entry
+	p->pInMemEntry = nullptr;
+
+	// Indexed group file: seek directly
+	if (p->RandomAccess)
+	{
+		if (p->Mother && p->Mother->p->SourceType==P::ST_Packed)
+		{
+			if (!p->Mother->SetFilePtr(p->MotherOffset + p->EntryOffset + iOffset)) return false;
+		}
+		else
+		{
+			CStdFile *pFile = &p->StdFile;
+			// Child of a folder: the mother has the plain file open
+			if (p->Mother)
+			{
+				if (!p->Mother->EnsureChildFilePtr(this)) return false;
+				pFile = &p->Mother->p->StdFile;
+			}
+			else if (p->FilePtr == iOffset)
+				return true;
+			if (pFile->Seek(p->EntryOffset + iOffset, SEEK_SET)) return Error("SetFilePtr: Cannot seek");
+		}
+		p->FilePtr = iOffset;
+		return true;
+	}
+
 	// ensure mother is at correct pos
 	if (p->Mother) p->Mother->EnsureChildFilePtr(this);
 
@@ -1662,11 +1858,18 @@ bool C4Group::OpenAsChild(C4Group *pMother,
 
 	// Check Header
 	if (!SEqual(Head.id,C4GroupFileID)
-	    || (Head.Ver1!=C4GroupFileVer1) || (Head.Ver2>C4GroupFileVer2))
+	    || (Head.Ver1!=C4GroupFileVer1) || (Head.Ver2>C4GroupFileVer2Indexed))
 		{ CloseExclusiveMother(); Clear(); return Error("OpenAsChild: Invalid Header"); }
 
+	// Child data can be seeked to if the mother's can (packed mother) or if it is a plain file (folder mother)
+	if (p->Mother->p->SourceType == P::ST_Packed)
+		p->RandomAccess = p->Mother->p->RandomAccess;
+	else
+		p->RandomAccess = !p->Mother->p->StdFile.IsCompressed();
+
 	// Read Entries
 	C4GroupEntryCore corebuf;
+	C4GroupEntry *pNewEntry = nullptr;
 	int file_entries=Head.Entries;
 	Head.Entries=0; // Reset, will be recounted by AddEntry
 	for (int cnt=0; cnt<file_entries; cnt++)
@@ -1679,6 +1882,8 @@ bool C4Group::OpenAsChild(C4Group *pMother,
 		              nullptr, nullptr, false, false,
 		              !!corebuf.Executable))
 			{ CloseExclusiveMother(); Clear(); return Error("OpenAsChild: Insufficient memory"); }
+		pNewEntry = pNewEntry ? pNewEntry->Next : p->FirstEntry;
+		SetIndexedCore(pNewEntry, corebuf);
 	}
 
 	ResetSearch();
@@ -1756,6 +1961,15 @@ bool C4Group::SetFilePtr2Entry(const char *szName, bool NeedsToBeAGroup)
 
 	case P::ST_Packed:
 		if ((!centry) || (centry->Status != C4GroupEntry::C4GRES_InGroup)) return false;
+		// Compressed entry of an indexed group: unpack and read from memory
+		if (centry->Packed)
+		{
+			if (NeedsToBeAGroup) return false;
+			if (!UnpackEntry(centry, p->UnpackedEntry)) return false;
+			p->pInMemEntry = static_cast<BYTE *>(p->UnpackedEntry.getMData());
+			p->iInMemEntrySize = p->UnpackedEntry.getSize();
+			return true;
+		}
 		return SetFilePtr(centry->Offset);
 
 	case P::ST_Unpacked: {
@@ -1763,6 +1977,8 @@ bool C4Group::SetFilePtr2Entry(const char *szName, bool NeedsToBeAGroup)
 		char path[_MAX_FNAME+1]; SCopy(GetName(),path,_MAX_FNAME);
 		AppendBackslash(path); SAppend(szName,path);
 		bool fSuccess = p->StdFile.Open(path, NeedsToBeAGroup);
+		// Indexed group files are not compressed as a whole
+		if (!fSuccess && NeedsToBeAGroup) fSuccess = p->StdFile.Open(path, false);
 		return fSuccess;
 	}
 
@@ -1929,6 +2145,63 @@ bool C4Group::LoadEntry(const char *szEntryName, StdBuf * Buf)
 	return true;
 }
 
+bool C4Group::LoadEntryView(const char *szEntryName, C4GroupEntryView *pView)
+{
+	pView->Clear();
+	StdStrBuf fname;
+	if (!FindEntry(szEntryName, &fname)) return Error("LoadEntryView: Not found");
+	// Refer to the file contents directly if possible, copy otherwise
+	if (MapEntry(fname.getData(), pView)) return true;
+	return LoadEntry(fname.getData(), &pView->Buf);
+}
+
+bool C4Group::MapEntry(const char *szName, C4GroupEntryView *pView)
+{
+	// Files in folders are mapped individually
+	if (p->SourceType == P::ST_Unpacked)
+	{
+		char path[_MAX_FNAME+1]; SCopy(GetName(),path,_MAX_FNAME);
+		AppendBackslash(path); SAppend(szName,path);
+		if (DirectoryExists(path)) return false;
+		if (!(pView->Mapping = CStdFileMapping::Open(path))) return false;
+		pView->Buf.Ref(pView->Mapping->getData(), pView->Mapping->getSize());
+		return true;
+	}
+	// Group files: only uncompressed entries of plain indexed files
+	C4GroupEntry *centry = GetEntry(szName);
+	if (p->SourceType != P::ST_Packed || !p->RandomAccess || !centry || centry->Packed || centry->Status != C4GroupEntry::C4GRES_InGroup)
+		return false;
+	if (!centry->Size) return false;
+	// Find the group that has the file and the entry position in it
+	size_t iOffset = centry->Offset;
+	C4Group *pGrp = this;
+	for (;;)
+	{
+		iOffset += pGrp->p->EntryOffset;
+		C4Group *pMother = pGrp->p->Mother;
+		if (pMother && pMother->p->SourceType == P::ST_Packed)
+			{ iOffset += pGrp->p->MotherOffset; pGrp = pMother; continue; }
+		if (!pGrp->p->Mapping)
+		{
+			if (pMother)
+			{
+				// Child of a folder
+				char path[_MAX_FNAME+1];
+				SCopy(pMother->GetName(),path,_MAX_FNAME); AppendBackslash(path); SAppend(GetFilename(pGrp->GetName()),path,_MAX_FNAME);
+				pGrp->p->Mapping = CStdFileMapping::Open(path);
+			}
+			else
+				pGrp->p->Mapping = CStdFileMapping::Open(pGrp->GetName());
+			if (!pGrp->p->Mapping) return false;
+		}
+		break;
+	}
+	if (iOffset + centry->Size > pGrp->p->Mapping->getSize()) return false;
+	pView->Mapping = pGrp->p->Mapping;
+	pView->Buf.Ref(pView->Mapping->getData() + iOffset, centry->Size);
+	return true;
+}
+
 bool C4Group::LoadEntryString(const char *szEntryName, StdStrBuf *Buf)
 {
 	size_t size;
@@ -2049,6 +2322,8 @@ bool C4Group::EnsureChildFilePtr(C4Group *pChild)
 	// group file
 	if (p->SourceType == P::ST_Packed)
 	{
+		// the child reads raw data through us
+		p->pInMemEntry = nullptr;
 		// check if FilePtr has to be moved
 		if (p->FilePtr != pChild->p->MotherOffset + pChild->p->EntryOffset +  pChild->p->FilePtr)
 			// move it to the position the child thinks it is
@@ -2117,6 +2392,11 @@ uint32_t C4Group::CalcCRC32(C4GroupEntry *pEntry)
 	}
 	else if (!pEntry->Size)
 		CRC = 0;
+	else if (pEntry->Status == C4GroupEntry::C4GRES_InGroup && pEntry->HasCRC)
+	{
+		// indexed groups store the checksum of the contents
+		CRC = crc32(pEntry->CRC, reinterpret_cast<BYTE *>(pEntry->FileName), SLen(pEntry->FileName));
+	}
 	else
 	{
 		BYTE *pData = nullptr; bool fOwnData; CStdFile f;
@@ -2165,6 +2445,7 @@ bool C4Group::OpenChild(const char* strEntry)
 	// Create a memory copy of ourselves
 	C4Group *pOurselves = new C4Group;
 	*pOurselves->p = *p;
+	pOurselves->p->pInMemEntry = nullptr; // might point into our unpacked entry buffer
 
 	// Open a child from the memory copy
 	C4Group hChild;
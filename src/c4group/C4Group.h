@@ -26,8 +26,8 @@
 #include "c4group/CStdFile.h"
 
 // C4Group-Rewind-warning:
-// The current C4Group-implementation cannot handle random file access very well,
-// because all files are written within a single zlib-stream.
+// Classic group files (version 1.2) are written within a single zlib-stream, so they
+// cannot handle random file access very well.
 // For every out-of-order-file accessed a group-rewind must be performed, and every
 // single file up to the accessed file unpacked. As a workaround, all C4Groups are
 // packed in a file order matching the reading order of the engine.
@@ -41,8 +41,9 @@
 // sort order lists in C4Components.h accordingly, and enforce a reading order for that
 // component.
 //
-// Maybe some day, someone will write a C4Group-implementation that is probably capable of
-// random access...
+// Indexed group files (version 1.3) avoid the problem: The file itself is not compressed,
+// entries are compressed individually and the entry list up front holds their offsets,
+// stored sizes and checksums, so every entry can be seeked to directly.
 #ifdef _DEBUG
 extern int iC4GroupRewindFilePtrNoWarn;
 #define C4GRP_DISABLE_REWINDWARN ++iC4GroupRewindFilePtrNoWarn;
@@ -52,7 +53,7 @@ extern int iC4GroupRewindFilePtrNoWarn;
 #define C4GRP_ENABLE_REWINDWARN ;
 #endif
 
-const int C4GroupFileVer1=1, C4GroupFileVer2=2;
+const int C4GroupFileVer1=1, C4GroupFileVer2=2, C4GroupFileVer2Indexed=3;
 
 const int C4GroupMaxError = 100;
 
@@ -64,6 +65,7 @@ bool C4Group_TestIgnore(const char *szFilename);
 void C4Group_SetTempPath(const char *szPath);
 const char* C4Group_GetTempPath();
 void C4Group_SetSortList(const char **ppSortList);
+void C4Group_SetFileVersion(int iVer2); // format of newly created groups: C4GroupFileVer2 or C4GroupFileVer2Indexed
 void C4Group_SetProcessCallback(bool (*fnCallback)(const char *, int));
 bool C4Group_IsGroup(const char *szFilename);
 bool C4Group_CopyItem(const char *szSource, const char *szTarget, bool fNoSort=false, bool fResetAttributes=false);
@@ -92,10 +94,10 @@ struct C4GroupEntryCore
 {
 	char FileName[260] = { 0 };
 	int32_t Packed = 0, ChildGroup = 0;
-	int32_t Size = 0, reserved1 = 0, Offset = 0;
+	int32_t Size = 0, StoredSize = 0, Offset = 0; // StoredSize differs from Size for Packed entries of indexed groups
 	int32_t reserved2 = 0;
-	char reserved3 = '\0';
-	unsigned int reserved4 = 0;
+	char HasCRC = '\0';
+	unsigned int CRC = 0; // crc32 of the uncompressed contents (indexed groups only)
 	char Executable = '\0';
 	BYTE fbuf[26] = { 0 };
 };
@@ -128,6 +130,22 @@ public:
 	void Set(const DirectoryIterator & iter, const char * szPath);
 };
 
+// Read-only contents of a group entry, as returned by C4Group::LoadEntryView. Refers
+// directly into a memory mapping of the file if the entry is stored uncompressed in an
+// indexed group file or is a file in a folder; holds a copy otherwise.
+class C4GroupEntryView
+{
+	friend class C4Group;
+	std::shared_ptr<CStdFileMapping> Mapping;
+	StdBuf Buf;
+public:
+	const StdBuf &GetBuf() const { return Buf; }
+	const void *getData() const { return Buf.getData(); }
+	size_t getSize() const { return Buf.getSize(); }
+	bool IsMapped() const { return !!Mapping; }
+	void Clear() { Buf.Clear(); Mapping.reset(); }
+};
+
 class C4Group : public CStdStream
 {
 	struct P;
@@ -174,6 +192,7 @@ public:
 	               size_t *ipSize=nullptr, int iAppendZeros=0);
 	bool LoadEntry(const char *szEntryName, StdBuf * Buf);
 	bool LoadEntry(const StdStrBuf & name, StdBuf * Buf) { return LoadEntry(name.getData(), Buf); }
+	bool LoadEntryView(const char *szEntryName, C4GroupEntryView *pView); // zero-copy where possible; see C4GroupEntryView
 	bool LoadEntryString(const char *szEntryName, StdStrBuf * Buf);
 	bool LoadEntryString(const StdStrBuf & name, StdStrBuf * Buf) { return LoadEntryString(name.getData(), Buf); }
 	bool FindEntry(const char *szWildCard,
@@ -245,6 +264,10 @@ private:
 	bool AddEntryOnDisk(const char *szFilename, const char *szAddAs=nullptr, bool fMove=false);
 	bool SetFilePtr2Entry(const char *szName, bool NeedsToBeAGroup = false);
 	bool AppendEntry2StdFile(C4GroupEntry *centry, CStdFile &stdfile);
+	bool UnpackEntry(C4GroupEntry *centry, StdBuf &rBuf);
+	bool MapEntry(const char *szName, C4GroupEntryView *pView);
+	void SetIndexedCore(C4GroupEntry *centry, const C4GroupEntryCore &core);
+	bool SaveIndexedContents(CStdFile &hTarget, C4GroupEntryCore *save_core, bool fToMemory);
 	C4GroupEntry *SearchNextEntry(const char *szName);
 	C4GroupEntry *GetNextFolderEntry();
 	uint32_t CalcCRC32(C4GroupEntry *pEntry);
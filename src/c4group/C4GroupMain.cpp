@@ -103,7 +103,10 @@ void PrintGroupInternals(C4Group &grp, int indent_level = 0)
 		printf("%*s  Packed: %d\n", indent, "", p->Packed);
 		printf("%*s  ChildGroup: %d\n", indent, "", p->ChildGroup);
 		printf("%*s  Size: %d\n", indent, "", p->Size);
+		printf("%*s  StoredSize: %d\n", indent, "", p->StoredSize);
 		printf("%*s  Offset: %d\n", indent, "", p->Offset);
+		if (p->HasCRC)
+			printf("%*s  CRC: %08X\n", indent, "", p->CRC);
 		printf("%*s  Executable: %d\n", indent, "", p->Executable);
 		if (p->ChildGroup != 0)
 		{
@@ -326,6 +329,41 @@ bool ProcessGroup(const char *FilenamePar)
 					case 'z':
 						PrintGroupInternals(hGroup);
 						break;
+						// Convert to other group file version
+					case 'c':
+						{
+							int iVer2 = 0;
+							if (iArg + 1 < argc) iVer2 = atoi(argv[iArg + 1]);
+							if (iVer2 != C4GroupFileVer2 && iVer2 != C4GroupFileVer2Indexed)
+							{
+								fprintf(stderr, "Convert failed: version must be %d (classic) or %d (indexed)\n", C4GroupFileVer2, C4GroupFileVer2Indexed);
+								break;
+							}
+							++iArg;
+							Log("Converting...");
+							// Close
+							if (!hGroup.Close())
+							{
+								fprintf(stderr, "Closing failed: %s\n", hGroup.GetError());
+							}
+							// Explode and pack again in the new format
+							else if (!C4Group_ExplodeDirectory(szFilename))
+							{
+								fprintf(stderr, "Unpack failed\n");
+							}
+							else
+							{
+								C4Group_SetFileVersion(iVer2);
+								bool fPacked = C4Group_PackDirectory(szFilename);
+								C4Group_SetFileVersion(C4GroupFileVer2);
+								if (!fPacked)
+									fprintf(stderr, "Pack failed\n");
+								// Reopen
+								else if (!hGroup.Open(szFilename))
+									fprintf(stderr, "Reopen failed: %s\n", hGroup.GetError());
+							}
+						}
+						break;
 						// Undefined
 					default:
 						fprintf(stderr, "Unknown command: %s\n", argv[iArg]);
@@ -537,6 +575,7 @@ int main(int argc, char *argv[])
 		printf("          -y [ppid] Apply update (waiting for ppid to terminate first)\n");
 		printf("          -g [source] [target] [title] Make update\n");
 		printf("          -s Sort\n");
+		printf("          -c [2|3] Convert to classic (2) or indexed (3) group format\n");
 		printf("\n");
 		printf("Options:  -v Verbose -r Recursive\n");
 		printf("          -i Register shell -u Unregister shell\n");
@@ -544,6 +583,7 @@ int main(int argc, char *argv[])
 		printf("\n");
 		printf("Examples: c4group pack.ocg -x\n");
 		printf("          c4group update.ocu -g ver1.ocf ver2.ocf New_Version\n");
+		printf("          c4group Objects.ocd -c 3\n");
 		printf("          c4group -i\n");
 	}
 
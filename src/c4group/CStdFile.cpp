@@ -28,6 +28,9 @@
 #include "zlib/gzio.h"
 
 #include <sys/stat.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
 
 CStdFile::CStdFile()
 {
@@ -309,6 +312,10 @@ int CStdFile::Seek(long int offset, int whence)
 {
 	// seek in file by offset and stdio-style SEEK_* constants. Only implemented for uncompressed files.
 	assert(!hgzFile);
+	// the file position is past any buffered data
+	if (ModeWrite) { if (!Flush()) return -1; }
+	else if (whence == SEEK_CUR) offset -= BufferLoad - BufferPtr;
+	ClearBuffer();
 	return fseek(hFile, offset, whence);
 }
 
@@ -316,7 +323,47 @@ long int CStdFile::Tell()
 {
 	// get current file pos. Only implemented for uncompressed files.
 	assert(!hgzFile);
-	return ftell(hFile);
+	if (ModeWrite) return ftell(hFile) + BufferLoad;
+	return ftell(hFile) - (BufferLoad - BufferPtr);
+}
+
+std::shared_ptr<CStdFileMapping> CStdFileMapping::Open(const char *szFilename)
+{
+	void *pData;
+	size_t iSize;
+#ifdef _WIN32
+	HANDLE hFile = CreateFileW(GetWideChar(szFilename), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (hFile == INVALID_HANDLE_VALUE) return nullptr;
+	LARGE_INTEGER liSize;
+	if (!GetFileSizeEx(hFile, &liSize) || !liSize.QuadPart) { CloseHandle(hFile); return nullptr; }
+	iSize = static_cast<size_t>(liSize.QuadPart);
+	HANDLE hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(hFile);
+	if (!hMapping) return nullptr;
+	// the view keeps the mapping object alive
+	pData = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(hMapping);
+	if (!pData) return nullptr;
+#else
+	int fd = open(szFilename, O_RDONLY|O_CLOEXEC);
+	if (fd == -1) return nullptr;
+	struct stat st;
+	if (fstat(fd, &st) || !S_ISREG(st.st_mode) || !st.st_size) { close(fd); return nullptr; }
+	iSize = st.st_size;
+	pData = mmap(nullptr, iSize, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (pData == MAP_FAILED) return nullptr;
+#endif
+	return std::shared_ptr<CStdFileMapping>(new CStdFileMapping(static_cast<BYTE *>(pData), iSize));
+}
+
+CStdFileMapping::~CStdFileMapping()
+{
+#ifdef _WIN32
+	UnmapViewOfFile(pData);
+#else
+	munmap(pData, iSize);
+#endif
 }
 
 int UncompressedFileSize(const char *szFilename)
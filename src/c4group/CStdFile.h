@@ -66,6 +66,7 @@ public:
 	int Seek(long int offset, int whence); // seek in file by offset and stdio-style SEEK_* constants. Only implemented for uncompressed files.
 	long int Tell(); // get current file pos. Only implemented for uncompressed files.
 	bool IsOpen() const { return hFile || hgzFile; }
+	bool IsCompressed() const { return !!hgzFile; }
 	// flush contents to disk
 	inline bool Flush() { if (ModeWrite && BufferLoad) return SaveBuffer(); else return true; }
 	size_t AccessedEntrySize() const override;
@@ -75,6 +76,23 @@ protected:
 	bool SaveBuffer();
 };
 
+// Read-only memory mapping of a whole file. Views into it share ownership, so the
+// mapping stays valid as long as any of them is alive.
+class CStdFileMapping
+{
+public:
+	CStdFileMapping(const CStdFileMapping &) = delete;
+	CStdFileMapping &operator=(const CStdFileMapping &) = delete;
+	~CStdFileMapping();
+	static std::shared_ptr<CStdFileMapping> Open(const char *szFileName); // nullptr if the file cannot be mapped (or is empty)
+	const BYTE *getData() const { return pData; }
+	size_t getSize() const { return iSize; }
+private:
+	CStdFileMapping(BYTE *pData, size_t iSize) : pData(pData), iSize(iSize) { }
+	BYTE *pData;
+	size_t iSize;
+};
+
 int UncompressedFileSize(const char *szFileName);
 bool GetFileCRC(const char *szFilename, uint32_t *pCRC32);
 bool GetFileSHA1(const char *szFilename, BYTE *pSHA1);
@@ -47,6 +47,7 @@ public:
 	int32_t DefRec;
 	int32_t MMTimer;  // use multimedia-timers
 	int32_t ScrollSmooth; // view movement smoothing
+	int32_t DefCache; // if set: keep parsed definition data in the user path to speed up loading (see C4DefCache)
 	int32_t ConfigResetSafety; // safety value: If this value is screwed, the config got corrupted and must be reset
 	// Determined at run-time
 	StdCopyStrBuf ExePath;
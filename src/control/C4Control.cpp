@@ -749,8 +749,8 @@ void C4ControlSyncCheck::Set()
 	ControlTick = ::Control.ControlTick;
 	RandomCount = ::RandomCount;
 	AllCrewPosX = GetAllCrewPosX();
-	PXSCount = ::PXS.Count;
-	MassMoverIndex = ::MassMover.CreatePtr;
+	PXSCount = ::PXS.GetCount();
+	MassMoverIndex = ::MassMover.CreateCount;
 	ObjectCount = ::Objects.ObjectCount();
 	ObjectEnumerationIndex = C4PropListNumbered::GetEnumerationIndex();
 	SectShapeSum = ::Objects.Sectors.getShapeSum();
@@ -186,9 +186,9 @@ bool C4GameSave::SaveLandscape()
 
 bool C4GameSave::SaveRuntimeData()
 {
-	// Game.txt data (general runtime data and objects)
+	// Game.txt/Game.ocb data (general runtime data and objects)
 	C4ValueNumbers numbers;
-	if (!Game.SaveData(*pSaveGroup, false, IsExact(), IsSynced(), &numbers))
+	if (!Game.SaveData(*pSaveGroup, false, IsExact(), IsSynced(), GetSaveBinaryRuntimeData(), &numbers))
 		{ Log(LoadResStr("IDS_ERR_SAVE_RUNTIMEDATA")); return false; }
 	// scenario sections (exact only)
 	if (IsExact()) if (!SaveScenarioSections())
@@ -465,6 +465,20 @@ bool C4GameSave::Close()
 	return fSuccess;
 }
 
+C4Group *C4GameSave::ReleaseGroup()
+{
+	// only owned groups can be handed over
+	if (!pSaveGroup || !fOwnGroup) return nullptr;
+	// sort group
+	const char *szSortOrder = GetSortOrder();
+	if (szSortOrder) pSaveGroup->Sort(szSortOrder);
+	// caller is responsible for closing it now
+	C4Group *pGroup = pSaveGroup;
+	pSaveGroup = nullptr;
+	fOwnGroup = false;
+	return pGroup;
+}
+
 
 // *** C4GameSaveSavegame
 
@@ -67,6 +67,7 @@ protected:
 	virtual bool GetSaveScriptPlayers() { return IsExact(); }       // return whether joined script players shall be saved into SavePlayerInfos
 	virtual bool GetSaveUserPlayerFiles() { return IsExact(); }       // return whether .ocp files of joined user players shall be put into the scenario
 	virtual bool GetSaveScriptPlayerFiles() { return IsExact(); }       // return whether .ocp files of joined script players shall be put into the scenario
+	virtual bool GetSaveBinaryRuntimeData() { return false; }     // return whether runtime data is saved in binary form, which only the same engine build can load
 
 	// savegame specializations
 	virtual void AdjustCore(C4Scenario &rC4S) {}         // set specific C4S values
@@ -105,6 +106,7 @@ public:
 	bool Save(C4Group &hToGroup, bool fKeepGroup);      // save game directly to target group
 	bool SaveDesc(C4Group &hToGroup);                   // save scenario desc to file
 	bool Close();                      // close scenario group
+	C4Group *ReleaseGroup();           // sort and hand over the group created by Save(filename) unclosed, so it can be packed elsewhere
 
 	C4Group *GetGroup() { return pSaveGroup; } // get scenario saving group; only open between calls to Save() and Close()
 };
@@ -179,6 +181,7 @@ protected:
 	bool GetKeepTitle() override { return false; }     // always delete title files (not used in dynamics)
 	bool GetSaveDesc() override { return false; }      // no desc in dynamics
 	bool GetCreateSmallFile() override { return true; }// return whether file size should be minimized
+	bool GetSaveBinaryRuntimeData() override { return true; } // dynamics are only loaded by clients of the same build
 
 	bool GetCopyScenario() override { return false; }    // network dynamics do not base on normal scenario
 	// savegame specializations
@@ -23,6 +23,7 @@
 
 #include "C4Version.h"
 #include "editor/C4Console.h"
+#include "game/C4Benchmark.h"
 #include "game/C4FullScreen.h"
 #include "game/C4GraphicsSystem.h"
 #include "graphics/C4Draw.h"
@@ -36,6 +37,7 @@
 #endif
 #include "gui/C4Startup.h"
 #include "landscape/C4Particles.h"
+#include "lib/C4Trace.h"
 #include "network/C4Network2.h"
 #include "network/C4Network2IRC.h"
 #include "platform/C4GamePadCon.h"
@@ -125,6 +127,14 @@ bool C4Application::DoInit(int argc, char * argv[])
 	// Parse command line
 	ParseCommandLine(argc, argv);
 
+#ifdef USE_CONSOLE
+	// Benchmarks run unattended and must not quit when stdin is closed
+	if (::Benchmark.IsActive()) Remove(&InProc);
+#endif
+
+	// Trace everything from here on if desired
+	if (!TraceFile.empty()) C4Trace::Start();
+
 	// Open additional logs that depend on command line
 	OpenExtraLogs();
 
@@ -220,6 +230,8 @@ void C4Application::ParseCommandLine(int argc, char * argv[])
 			{"league", no_argument, &Config.Network.LeagueServerSignUp, 1},
 			{"nosignup", no_argument, &Config.Network.MasterServerSignUp, 0},
 			{"signup", no_argument, &Config.Network.MasterServerSignUp, 1},
+			{"defcache", no_argument, &Config.General.DefCache, 1},
+			{"nodefcache", no_argument, &Config.General.DefCache, 0},
 			
 			{"debugrecread", required_argument, nullptr, 'K'},
 			{"debugrecwrite", required_argument, nullptr, 'w'},
@@ -240,6 +252,10 @@ void C4Application::ParseCommandLine(int argc, char * argv[])
 			{"join", required_argument, nullptr, 'j'},
 			{"language", required_argument, nullptr, 'L'},
 			{"scenpar", required_argument, nullptr, 'S'},
+			{"trace", required_argument, nullptr, 'T'},
+			{"benchmark", required_argument, nullptr, 'B'},
+			{"benchmark-seed", required_argument, nullptr, 'E'},
+			{"benchmark-output", required_argument, nullptr, 'O'},
 
 			{"observe", no_argument, nullptr, 'o'},
 			{"nonetwork", no_argument, nullptr, 'N'},
@@ -345,6 +361,12 @@ void C4Application::ParseCommandLine(int argc, char * argv[])
 			Game.StartupScenarioParameters.SetValue(sopt.getData(), val, false);
 			}
 			break;
+		// hot path trace output file
+		case 'T': TraceFile = optarg; break;
+		// headless benchmark: number of frames, seed and report file
+		case 'B': ::Benchmark.Frames = std::max(atoi(optarg), 0); break;
+		case 'E': ::Benchmark.Seed = atoi(optarg); break;
+		case 'O': ::Benchmark.OutputFile.Copy(optarg); break;
 		// debug configs
 		case 'h':
 			Game.NetworkActive = true;
@@ -368,6 +390,9 @@ void C4Application::ParseCommandLine(int argc, char * argv[])
 		Config.Network.LeagueServerSignUp = false;
 	if (Game.fObserve || Game.fLobby)
 		Game.NetworkActive = true;
+	// benchmarks run a local game without lobby
+	if (::Benchmark.IsActive())
+		Game.NetworkActive = Game.fLobby = Game.fObserve = false;
 
 	while (optind < argc)
 	{
@@ -574,6 +599,12 @@ bool C4Application::ProcessCallback(const char *szMessage, int iProcess)
 
 void C4Application::Clear()
 {
+	// write trace started by command line
+	if (!TraceFile.empty() && C4Trace::IsEnabled())
+	{
+		C4Trace::Stop();
+		C4Trace::WriteChromeTrace(TraceFile.c_str());
+	}
 	Game.Clear();
 	NextMission.clear();
 	// stop timer
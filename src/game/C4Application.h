@@ -77,6 +77,8 @@ public:
 	std::string IncomingUpdate;
 	// set by ParseCommandLine, for manually invoking an update check by command line or url
 	int CheckForUpdates{false};
+	// set by ParseCommandLine; hot path trace is recorded from startup and written to this file
+	std::string TraceFile;
 
 	bool FullScreenMode();
 	int GetConfigWidth()  { return (!FullScreenMode()) ? Config.Graphics.WindowX : Config.Graphics.ResX; }
@@ -0,0 +1,154 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2016, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+// Headless tick benchmark
+
+#include "C4Include.h"
+#include "game/C4Benchmark.h"
+
+#include "game/C4Application.h"
+#include "game/C4Game.h"
+#include "landscape/C4MassMover.h"
+#include "landscape/C4PXS.h"
+#include "lib/C4Random.h"
+#include "object/C4GameObjects.h"
+
+C4Benchmark Benchmark;
+
+void C4Benchmark::Default()
+{
+	Frames = 0;
+	Seed = 1;
+	OutputFile.Clear();
+	for (Section &s : Sections)
+	{
+		s.Count = 0;
+		s.Total = s.Max = Clock::duration::zero();
+	}
+	FramesDone = 0;
+	FrameTimes.clear();
+}
+
+const char *C4Benchmark::GetSectionName(C4BenchmarkSection section)
+{
+	switch (section)
+	{
+	case C4BS_Control:     return "Control";
+	case C4BS_ExecObjects: return "ExecObjects";
+	case C4BS_CrossCheck:  return "CrossCheck";
+	case C4BS_Effects:     return "Effects";
+	case C4BS_PXS:         return "PXS";
+	case C4BS_MassMover:   return "MassMover";
+	case C4BS_Weather:     return "Weather";
+	case C4BS_Landscape:   return "Landscape";
+	case C4BS_Players:     return "Players";
+	case C4BS_Messages:    return "Messages";
+	case C4BS_PathFinder:  return "PathFinder";
+	case C4BS_Count:       break;
+	}
+	return "Unknown";
+}
+
+void C4Benchmark::BeginFrame()
+{
+	if (!IsActive() || IsDone()) return;
+	FrameStartTime = Clock::now();
+	if (!FramesDone)
+	{
+		StartTime = FrameStartTime;
+		FrameTimes.reserve(Frames);
+		LogF("Benchmark: Running %d frames (seed %d)", (int) Frames, (int) Seed);
+	}
+}
+
+void C4Benchmark::EndFrame()
+{
+	if (!IsActive() || IsDone()) return;
+	FrameTimes.push_back(Clock::now() - FrameStartTime);
+	if (++FramesDone < Frames) return;
+	// all frames done: report and quit
+	WriteReport();
+	Application.Quit();
+}
+
+static double ToMs(C4Benchmark::Clock::duration d)
+{
+	return std::chrono::duration<double, std::milli>(d).count();
+}
+
+static void AppendJSONString(StdStrBuf &buf, const char *s)
+{
+	buf.AppendChar('"');
+	for (; *s; ++s)
+	{
+		if (*s == '"' || *s == '\\')
+			buf.AppendChar('\\');
+		if (static_cast<unsigned char>(*s) < 0x20)
+			buf.AppendFormat("\\u%04x", static_cast<unsigned int>(*s));
+		else
+			buf.AppendChar(*s);
+	}
+	buf.AppendChar('"');
+}
+
+StdStrBuf C4Benchmark::GetReport() const
+{
+	StdStrBuf buf;
+	buf.Append("{\n\t\"scenario\": ");
+	AppendJSONString(buf, Game.ScenarioFilename);
+	buf.AppendFormat(",\n\t\"seed\": %d,\n\t\"frames\": %d,\n", (int) Seed, (int) FramesDone);
+	buf.AppendFormat("\t\"wall_ms\": %.3f,\n", FramesDone ? ToMs(Clock::now() - StartTime) : 0.0);
+	// frame time distribution
+	std::vector<Clock::duration> sorted(FrameTimes);
+	std::sort(sorted.begin(), sorted.end());
+	Clock::duration total = Clock::duration::zero();
+	for (Clock::duration d : sorted) total += d;
+	auto percentile = [&sorted](int p) { return sorted.empty() ? 0.0 : ToMs(sorted[(sorted.size() - 1) * p / 100]); };
+	buf.AppendFormat("\t\"frame_ms\": { \"mean\": %.4f, \"min\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f },\n",
+	                 sorted.empty() ? 0.0 : ToMs(total) / sorted.size(), percentile(0), percentile(50), percentile(95), percentile(99), percentile(100));
+	// subsystems
+	buf.Append("\t\"sections\": {");
+	for (int i = 0; i < C4BS_Count; ++i)
+	{
+		const Section &s = Sections[i];
+		buf.Append(i ? ",\n\t\t" : "\n\t\t");
+		AppendJSONString(buf, GetSectionName(C4BenchmarkSection(i)));
+		buf.AppendFormat(": { \"calls\": %u, \"total_ms\": %.3f, \"mean_us\": %.3f, \"max_us\": %.3f }",
+		                 s.Count, ToMs(s.Total), s.Count ? ToMs(s.Total) * 1000 / s.Count : 0.0, ToMs(s.Max) * 1000);
+	}
+	buf.Append("\n\t},\n");
+	// sync state, so runs of different builds can be checked for identical simulation
+	buf.AppendFormat("\t\"sync\": { \"frame\": %d, \"random_count\": %d, \"objects\": %d, \"enumeration_index\": %d, \"pxs\": %d, \"mass_mover\": %d, \"sector_shape_sum\": %d }\n",
+	                 (int) Game.FrameCounter, (int) ::RandomCount, (int) ::Objects.ObjectCount(), (int) C4PropListNumbered::GetEnumerationIndex(),
+	                 (int) ::PXS.GetCount(), (int) ::MassMover.CreateCount, (int) ::Objects.Sectors.getShapeSum());
+	buf.Append("}\n");
+	return buf;
+}
+
+bool C4Benchmark::WriteReport() const
+{
+	StdStrBuf report = GetReport();
+	if (!OutputFile.getLength())
+	{
+		Log(report.getData());
+		return true;
+	}
+	if (!report.SaveToFile(OutputFile.getData()))
+	{
+		LogF("Benchmark: Could not write report to %s", OutputFile.getData());
+		return false;
+	}
+	LogF("Benchmark: Report written to %s", OutputFile.getData());
+	return true;
+}
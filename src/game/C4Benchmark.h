@@ -0,0 +1,107 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2016, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+// Headless tick benchmark: runs a fixed number of frames of a scenario with a
+// fixed random seed at full speed and writes per-subsystem timings as JSON.
+
+#ifndef INC_C4Benchmark
+#define INC_C4Benchmark
+
+#include <chrono>
+
+// Timed sections of C4Game::Execute. Sections may nest (e.g. CrossCheck is
+// contained in ExecObjects); each one is accumulated independently.
+enum C4BenchmarkSection
+{
+	C4BS_Control = 0,
+	C4BS_ExecObjects,
+	C4BS_CrossCheck,
+	C4BS_Effects,
+	C4BS_PXS,
+	C4BS_MassMover,
+	C4BS_Weather,
+	C4BS_Landscape,
+	C4BS_Players,
+	C4BS_Messages,
+	C4BS_PathFinder,
+	C4BS_Count
+};
+
+class C4Benchmark
+{
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	C4Benchmark() { Default(); }
+	~C4Benchmark() = default;
+
+	// set by command line
+	int32_t Frames;          // number of frames to run; zero if benchmark is not active
+	int32_t Seed;            // random seed passed to C4Game::FixRandom
+	StdCopyStrBuf OutputFile; // JSON report is written here; logged if empty
+
+	void Default();
+	bool IsActive() const { return Frames > 0; }
+	bool IsDone() const { return FramesDone >= Frames; }
+
+	// Called by C4Game::Execute around every executed frame
+	void BeginFrame();
+	void EndFrame();
+
+	void AddSectionTime(C4BenchmarkSection section, Clock::duration time)
+	{
+		Section &s = Sections[section];
+		++s.Count;
+		s.Total += time;
+		if (time > s.Max) s.Max = time;
+	}
+
+	StdStrBuf GetReport() const;
+	bool WriteReport() const;
+
+	static const char *GetSectionName(C4BenchmarkSection section);
+
+private:
+	struct Section
+	{
+		uint32_t Count;
+		Clock::duration Total, Max;
+	} Sections[C4BS_Count];
+
+	int32_t FramesDone;
+	Clock::time_point StartTime, FrameStartTime;
+	std::vector<Clock::duration> FrameTimes;
+};
+
+extern C4Benchmark Benchmark;
+
+// Accumulates the time until it goes out of scope into one section if the benchmark is active
+class C4BenchmarkTimer
+{
+public:
+	C4BenchmarkTimer(C4BenchmarkSection section) : section(section), active(::Benchmark.IsActive())
+	{
+		if (active) start = C4Benchmark::Clock::now();
+	}
+	~C4BenchmarkTimer()
+	{
+		if (active) ::Benchmark.AddSectionTime(section, C4Benchmark::Clock::now() - start);
+	}
+private:
+	C4BenchmarkSection section;
+	bool active;
+	C4Benchmark::Clock::time_point start;
+};
+
+#endif // INC_C4Benchmark
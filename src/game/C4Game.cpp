@@ -31,6 +31,7 @@
 #include "control/C4RoundResults.h"
 #include "editor/C4Console.h"
 #include "game/C4Application.h"
+#include "game/C4Benchmark.h"
 #include "game/C4FullScreen.h"
 #include "game/C4GraphicsSystem.h"
 #include "game/C4Viewport.h"
@@ -57,6 +58,7 @@
 #include "landscape/fow/C4FoW.h"
 #include "lib/C4Random.h"
 #include "lib/C4Stat.h"
+#include "lib/C4Trace.h"
 #include "lib/StdMesh.h"
 #include "network/C4League.h"
 #include "network/C4Network2Dialogs.h"
@@ -287,6 +289,9 @@ bool C4Game::PreInit()
 	Extra.InitGroup();
 
 	RandomSeed = time(nullptr);
+	// Benchmarks always run with the same seed
+	if (::Benchmark.IsActive())
+		RandomSeed = ::Benchmark.Seed;
 	// Randomize
 	FixRandom(RandomSeed);
 	// Timer flags
@@ -580,6 +585,9 @@ void C4Game::Clear()
 	Title.Clear();
 	Names.Clear();
 	GameText.Clear();
+	GameBinaryLoaded = false;
+	PlayerRuntimeData.clear();
+	ScriptGUIsSaved.reset();
 	RecordDumpFile.Clear();
 	RecordStream.Clear();
 
@@ -694,16 +702,17 @@ C4ST_NEW(GEStats,           "C4Game::Execute pGlobalEffects->Execute")
 C4ST_NEW(PXSStat,           "C4Game::Execute PXS.Execute")
 C4ST_NEW(DynPartStat,       "C4Game::Execute Particles.Execute")
 C4ST_NEW(MassMoverStat,     "C4Game::Execute MassMover.Execute")
+C4ST_NEW(PathFinderStat,    "C4Game::Execute PathFinder.ExecuteQueries")
 C4ST_NEW(WeatherStat,       "C4Game::Execute Weather.Execute")
 C4ST_NEW(PlayersStat,       "C4Game::Execute Players.Execute")
 C4ST_NEW(LandscapeStat,     "C4Game::Execute Landscape.Execute")
 C4ST_NEW(MusicSystemStat,   "C4Game::Execute MusicSystem.Execute")
 C4ST_NEW(MessagesStat,      "C4Game::Execute Messages.Execute")
 
-#define EXEC_S(Expressions, Stat) \
-  { C4ST_START(Stat) Expressions C4ST_STOP(Stat) }
+#define EXEC_S(Expressions, Stat, BenchmarkSection) \
+  { C4ST_START(Stat) { C4BenchmarkTimer BenchmarkTimer(BenchmarkSection); C4TraceScope TraceScope("Game", C4Benchmark::GetSectionName(BenchmarkSection)); Expressions } C4ST_STOP(Stat) }
 
-#define EXEC_S_DR(Expressions, Stat, DebugRecName) { if (Config.General.DebugRec) AddDbgRec(RCT_Block, DebugRecName, 6); EXEC_S(Expressions, Stat) }
+#define EXEC_S_DR(Expressions, Stat, BenchmarkSection, DebugRecName) { if (Config.General.DebugRec) AddDbgRec(RCT_Block, DebugRecName, 6); EXEC_S(Expressions, Stat, BenchmarkSection) }
 #define EXEC_DR(Expressions, DebugRecName) { if (Config.General.DebugRec) AddDbgRec(RCT_Block, DebugRecName, 6); Expressions }
 
 bool C4Game::Execute() // Returns true if the game is over
@@ -717,7 +726,7 @@ bool C4Game::Execute() // Returns true if the game is over
 
 	// Prepare control
 	bool fControl;
-	EXEC_S(     fControl = Control.Prepare();     , ControlStat )
+	EXEC_S(     fControl = Control.Prepare();     , ControlStat         , C4BS_Control )
 	if (!fControl) return false; // not ready yet: wait
 
 	// Halt
@@ -730,6 +739,9 @@ bool C4Game::Execute() // Returns true if the game is over
 	Control.Execute();
 	if (!IsRunning) return false;
 
+	::Benchmark.BeginFrame();
+	C4TraceScope FrameTrace("Game", "Frame");
+
 	// Ticks
 	EXEC_DR(    Ticks();                                                , "Ticks")
 
@@ -742,21 +754,24 @@ bool C4Game::Execute() // Returns true if the game is over
 
 	// Game
 
-	EXEC_S(     ExecObjects();                    , ExecObjectsStat )
+	EXEC_S(     ExecObjects();                    , ExecObjectsStat     , C4BS_ExecObjects )
 	EXEC_S_DR(  C4Effect::Execute(&ScriptEngine.pGlobalEffects);
 	            C4Effect::Execute(&GameScript.pScenarioEffects);
-	                                              , GEStats             , "GEEx\0");
-	EXEC_S_DR(  PXS.Execute();                    , PXSStat             , "PXSEx")
-	EXEC_S_DR(  MassMover.Execute();              , MassMoverStat       , "MMvEx")
-	EXEC_S_DR(  Weather.Execute();                , WeatherStat         , "WtrEx")
-	EXEC_S_DR(  Landscape.Execute();              , LandscapeStat       , "LdsEx")
-	EXEC_S_DR(  Players.Execute();                , PlayersStat         , "PlrEx")
-	EXEC_S_DR(  ::Messages.Execute();             , MessagesStat        , "MsgEx")
+	                                              , GEStats             , C4BS_Effects        , "GEEx\0");
+	EXEC_S_DR(  PXS.Execute();                    , PXSStat             , C4BS_PXS            , "PXSEx")
+	EXEC_S_DR(  MassMover.Execute();              , MassMoverStat       , C4BS_MassMover      , "MMvEx")
+	EXEC_S_DR(  Weather.Execute();                , WeatherStat         , C4BS_Weather        , "WtrEx")
+	EXEC_S_DR(  Landscape.Execute();              , LandscapeStat       , C4BS_Landscape      , "LdsEx")
+	EXEC_S_DR(  Players.Execute();                , PlayersStat         , C4BS_Players        , "PlrEx")
+	EXEC_S_DR(  ::Messages.Execute();             , MessagesStat        , C4BS_Messages       , "MsgEx")
 
 	EXEC_DR(    MouseControl.Execute();                                 , "Input")
 
 	EXEC_DR(    GameOverCheck();                                        , "Misc\0")
 
+	// Path finding queries of this frame, so none are pending between frames
+	EXEC_S_DR(  PathFinder.ExecuteQueries();      , PathFinderStat      , C4BS_PathFinder     , "PFdEx")
+
 	Control.DoSyncCheck();
 
 	// Evaluation; Game over dlg
@@ -779,6 +794,8 @@ bool C4Game::Execute() // Returns true if the game is over
 		Landscape.DoRelights();
 	}
 
+	::Benchmark.EndFrame();
+
 	return true;
 }
 
@@ -1144,7 +1161,7 @@ C4Object* C4Game::FindConstuctionSiteBlock(int32_t tx, int32_t ty, int32_t wdt,
 	C4Rect rect1,rect2;
 	rect1.x=tx; rect1.y=ty; rect1.Wdt=wdt; rect1.Hgt=hgt;
 	C4LArea Area(&::Objects.Sectors, tx, ty, wdt, hgt); C4LSector *pSector;
-	for (C4ObjectList *pObjs = Area.FirstObjectShapes(&pSector); pSector; pObjs = Area.NextObjectShapes(pObjs, &pSector))
+	for (C4LSectorList *pObjs = Area.FirstObjectShapes(&pSector); pSector; pObjs = Area.NextObjectShapes(pObjs, &pSector))
 		for (C4Object *cObj : *pObjs)
 			if (cObj->Status && !cObj->Contained)
 				if (cObj->OCF & OCF_Exclusive)
@@ -1341,7 +1358,11 @@ void C4Game::ExecObjects() // Every Tick1 by Execute
 		AddDbgRec(RCT_Block, "ObjCC", 6);
 
 	// Cross check objects
-	Objects.CrossCheck();
+	{
+		C4BenchmarkTimer BenchmarkTimer(C4BS_CrossCheck);
+		C4TraceScope TraceScope("Game", "CrossCheck");
+		Objects.CrossCheck();
+	}
 
 	if (Config.General.DebugRec)
 		AddDbgRec(RCT_Block, "ObjRs", 6);
@@ -1444,6 +1465,7 @@ void C4GameSec1Timer::OnSec1Timer()
 void C4Game::Default()
 {
 	PointersDenumerated = false;
+	GameBinaryLoaded = false;
 	IsRunning = false;
 	FrameCounter=0;
 	GameOver=GameOverDlgShown=InitialPlayersJoined=false;
@@ -1636,7 +1658,7 @@ void C4Game::DrawCrewOverheadText(C4TargetFacet &cgo, int32_t iPlayer)
 void C4Game::Ticks()
 {
 	// Frames
-	FrameCounter++; GameGo = FullSpeed;
+	FrameCounter++; GameGo = FullSpeed || ::Benchmark.IsActive();
 	// Ticks
 	if (++iTick2==2)       iTick2=0;
 	if (++iTick3==3)       iTick3=0;
@@ -1648,7 +1670,7 @@ void C4Game::Ticks()
 	// FPS / time
 	cFPS++; TimeGo = true;
 	// Frame skip
-	if (FrameCounter % FrameSkip) DoSkipFrame = true;
+	if (FrameCounter % FrameSkip || ::Benchmark.IsActive()) DoSkipFrame = true;
 	// Control
 	Control.Ticks();
 	// Full speed
@@ -1723,23 +1745,56 @@ void C4Game::CompileFunc(StdCompiler *pComp, CompileSettings comp, C4ValueNumber
 			}
 			else
 			{
-				C4Value *val = new C4Value(ScriptGuiRoot->ToC4Value());
-				pComp->Value(mkNamingAdapt(mkParAdapt(*val, numbers), "ScriptGUIs", C4VNull));
+				if (!ScriptGUIsSaved) ScriptGUIsSaved = std::make_unique<C4Value>(ScriptGuiRoot->ToC4Value());
+				pComp->Value(mkNamingAdapt(mkParAdapt(*ScriptGUIsSaved, numbers), "ScriptGUIs", C4VNull));
 			}
 			pComp->NameEnd();
 		}
 	}
 
-	if (comp.fPlayers)
+	if (comp.fPlayers && pComp->hasNaming())
 	{
 		assert(pComp->isSerializer());
 		// player parsing: Parse all players
 		// This doesn't create any players, but just parses existing by their ID
 		// Primary player ininitialization (also setting ID) is done by player info list
-		// Won't work this way for binary mode!
 		for (C4Player *pPlr=Players.First; pPlr; pPlr=pPlr->Next)
 			pComp->Value(mkNamingAdapt(mkParAdapt(*pPlr, numbers), FormatString("Player%d", pPlr->ID).getData()));
 	}
+	else if (comp.fPlayers)
+	{
+		// binary mode: Players are stored as buffers by their ID, which are compiled
+		// when the player is restored (see C4Player::LoadRuntimeData)
+		int32_t iPlayerCount = 0;
+		if (pComp->isSerializer())
+		{
+			PlayerRuntimeData.clear();
+			for (C4Player *pPlr=Players.First; pPlr; pPlr=pPlr->Next)
+				PlayerRuntimeData[pPlr->ID] = DecompileToBuf<StdCompilerBinWrite>(mkParAdapt(*pPlr, numbers));
+			iPlayerCount = PlayerRuntimeData.size();
+		}
+		pComp->Value(iPlayerCount);
+		if (pComp->isSerializer())
+		{
+			for (auto &PlayerData : PlayerRuntimeData)
+			{
+				int32_t iID = PlayerData.first;
+				pComp->Value(iID);
+				pComp->Value(PlayerData.second);
+			}
+			PlayerRuntimeData.clear();
+		}
+		else
+		{
+			PlayerRuntimeData.clear();
+			for (int32_t i = 0; i < iPlayerCount; i++)
+			{
+				int32_t iID = 0;
+				pComp->Value(iID);
+				pComp->Value(PlayerRuntimeData[iID]);
+			}
+		}
+	}
 
 	// Section load: Clear existing prop list numbering to make room for the new objects
 	// Numbers will be re-acquired in C4GameObjects::PostLoad
@@ -1750,10 +1805,57 @@ void C4Game::CompileFunc(StdCompiler *pComp, CompileSettings comp, C4ValueNumber
 	pComp->Value(mkNamingAdapt(mkParAdapt(ScriptEngine, comp.init_mode == IM_Section, numbers), "Script"));
 }
 
+namespace
+{
+	// Binary runtime data: A header identifying the engine build and how the
+	// data has been compiled, followed by the data itself. Binary data has no
+	// names to resolve, so it can only be read with exactly the same layout.
+	const uint32_t C4GameBinaryId = 0x4247434f; // "OCGB"
+	const int32_t C4GameBinaryVersion = 1; // increase on changes to the binary-specific parts of the layout
+
+	class C4GameBinaryData
+	{
+	private:
+		C4Game &Game;
+		C4Game::CompileSettings Settings;
+		C4ValueNumbers *numbers;
+
+	public:
+		C4GameBinaryData(C4Game &Game, C4Game::CompileSettings Settings, C4ValueNumbers *numbers)
+				: Game(Game), Settings(Settings), numbers(numbers) { }
+
+		void CompileFunc(StdCompiler *pComp)
+		{
+			// header
+			uint32_t iId = C4GameBinaryId;
+			int32_t iVersion = C4GameBinaryVersion;
+			StdCopyStrBuf Build(C4VERSION " " C4REVISION);
+			pComp->Value(iId);
+			if (iId != C4GameBinaryId)
+				pComp->excCorrupt("not binary game data");
+			pComp->Value(iVersion);
+			pComp->Value(Build);
+			if (iVersion != C4GameBinaryVersion || Build != C4VERSION " " C4REVISION)
+				pComp->excCorrupt("binary game data of engine %s version %d cannot be loaded", Build.getData(), (int) iVersion);
+			// layout
+			int32_t iInitMode = Settings.init_mode;
+			bool fExact = Settings.fExact, fSync = Settings.fSync;
+			pComp->Value(iInitMode); pComp->Value(fExact); pComp->Value(fSync);
+			pComp->Value(Settings.fPlayers);
+			if (iInitMode != Settings.init_mode || fExact != Settings.fExact || fSync != Settings.fSync)
+				pComp->excCorrupt("binary game data has been saved in a different mode");
+			// data
+			pComp->Value(mkParAdapt(Game, Settings, numbers));
+		}
+	};
+}
+
 bool C4Game::CompileRuntimeData(C4Group &hGroup, InitMode init_mode, bool exact, bool sync, C4ValueNumbers * numbers)
 {
 	::Objects.Clear(init_mode != IM_Section);
 	GameText.Load(hGroup,C4CFN_Game);
+	GameBinaryLoaded = false;
+	PlayerRuntimeData.clear();
 	CompileSettings Settings(init_mode, false, exact, sync);
 	// C4Game is not defaulted on compilation.
 	// Loading of runtime data overrides only certain values.
@@ -1764,21 +1866,45 @@ bool C4Game::CompileRuntimeData(C4Group &hGroup, InitMode init_mode, bool exact,
 		    mkParAdapt(*this, Settings, numbers),
 		    GameText.GetDataBuf(), C4CFN_Game))
 			return false;
-		// Objects
-		int32_t iObjects = Objects.ObjectCount();
-		if (iObjects) { LogF(LoadResStr("IDS_PRC_OBJECTSLOADED"),iObjects); }
 	}
+	else
+	{
+		// binary runtime data? Players are kept by ID until they are restored.
+		StdBuf GameBinary;
+		if (!hGroup.LoadEntry(C4CFN_GameBinary, &GameBinary))
+			return true;
+		C4GameBinaryData Data(*this, Settings, numbers);
+		if (!CompileFromBuf_LogWarn<StdCompilerBinRead>(Data, GameBinary, C4CFN_GameBinary))
+			return false;
+		GameBinaryLoaded = true;
+	}
+	// Objects
+	int32_t iObjects = Objects.ObjectCount();
+	if (iObjects) { LogF(LoadResStr("IDS_PRC_OBJECTSLOADED"),iObjects); }
 	// Success
 	return true;
 }
 
-bool C4Game::SaveData(C4Group &hGroup, bool fSaveSection, bool fSaveExact, bool fSaveSync, C4ValueNumbers * numbers)
+bool C4Game::SaveData(C4Group &hGroup, bool fSaveSection, bool fSaveExact, bool fSaveSync, bool fSaveBinary, C4ValueNumbers * numbers)
 {
-	if (fSaveExact)
+	if (fSaveExact && fSaveBinary)
+	{
+		// Binary data is much faster to write and read, but can only be loaded by the same engine build
+		hGroup.Delete(C4CFN_Game);
+		C4GameBinaryData Data(*this, CompileSettings(fSaveSection ? IM_Section : IM_Normal, !fSaveSection, true, fSaveSync), numbers);
+		StdBuf Buf;
+		bool fSuccess = DecompileToBuf_Log<StdCompilerBinWrite>(Data, &Buf, C4CFN_GameBinary);
+		ScriptGUIsSaved.reset();
+		if (!fSuccess) return false;
+		return hGroup.Add(C4CFN_GameBinary,Buf,false,true);
+	}
+	else if (fSaveExact)
 	{
+		hGroup.Delete(C4CFN_GameBinary);
 		StdStrBuf Buf;
 		// Decompile (without players for scenario sections)
 		DecompileToBuf_Log<StdCompilerINIWrite>(mkParAdapt(*this, CompileSettings(fSaveSection ? IM_Section : IM_Normal, !fSaveSection && fSaveExact, fSaveExact, fSaveSync), numbers), &Buf, "Game");
+		ScriptGUIsSaved.reset();
 
 		// Empty? All default save a Game.txt anyway because it is used to signal the engine to not load Objects.c
 		if (!Buf.getLength()) Buf.Copy(" ");
@@ -1790,6 +1916,7 @@ bool C4Game::SaveData(C4Group &hGroup, bool fSaveSection, bool fSaveExact, bool
 	{
 		// Clear any exact game data in case scenario is saved from savegame resume
 		hGroup.Delete(C4CFN_Game);
+		hGroup.Delete(C4CFN_GameBinary);
 
 		// Save objects to file using system scripts
 		int32_t objects_file_handle = ::ScriptEngine.CreateUserFile();
@@ -2282,7 +2409,7 @@ bool C4Game::InitGame(C4Group &hGroup, InitMode init_mode, bool fLoadSky, C4Valu
 	PointersDenumerated = true;
 
 	// scenario objects script
-	if (!GameText.GetData() && pScenarioObjectsScript && pScenarioObjectsScript->GetPropList())
+	if (!HasRuntimeData() && pScenarioObjectsScript && pScenarioObjectsScript->GetPropList())
 		pScenarioObjectsScript->GetPropList()->Call(PSF_InitializeObjects);
 
 	// Environment
@@ -2522,9 +2649,9 @@ bool C4Game::InitPlayers(C4ValueNumbers * numbers)
 			}
 		}
 	}
-	// Console and no real players: halt
+	// Console and no real players: halt (unless benchmarking, which runs without players)
 	if (Console.Active)
-		if (!fLobby)
+		if (!fLobby && !::Benchmark.IsActive())
 			if (!(PlayerInfos.GetActivePlayerCount(false) - PlayerInfos.GetActiveScriptPlayerCount(true, false)))
 				++HaltCount;
 	return true;
@@ -2537,6 +2664,8 @@ bool C4Game::InitControl()
 	{
 		RandomSeed = C4S.Head.RandomSeed;
 	}
+	if (::Benchmark.IsActive())
+		RandomSeed = ::Benchmark.Seed;
 	// Randomize
 	FixRandom(RandomSeed);
 
@@ -3542,7 +3671,7 @@ bool C4Game::LoadScenarioSection(const char *szSection, DWORD dwFlags)
 		{
 			C4ValueNumbers numbers;
 			// objects: do not save info objects or inactive objects
-			if (!SaveData(*pGrp,true,false, false, &numbers))
+			if (!SaveData(*pGrp,true,false, false, false, &numbers))
 			{
 				DebugLog("LoadScenarioSection: Error saving objects");
 				return false;
@@ -39,7 +39,6 @@ public:
 		IM_Section = 1,
 		IM_ReInit = 2
 	};
-private:
 	// used as StdCompiler-parameter
 	struct CompileSettings
 	{
@@ -51,6 +50,7 @@ private:
 		CompileSettings(InitMode init_mode, bool fPlayers, bool fExact, bool fSync)
 				: init_mode(init_mode), fPlayers(fPlayers), fExact(fExact), fSync(fSync) { }
 	};
+private:
 
 	// struct of keyboard set and indexed control key
 	struct C4KeySetCtrl
@@ -77,6 +77,9 @@ public:
 	C4ComponentHost     Title;
 	C4ComponentHost     Names;
 	C4ComponentHost     GameText;
+	bool                GameBinaryLoaded; // runtime data has been loaded from C4CFN_GameBinary instead of GameText
+	std::map<int32_t, StdCopyBuf> PlayerRuntimeData; // binary runtime data of players by ID, compiled when they are restored
+	std::unique_ptr<C4Value> ScriptGUIsSaved; // script GUIs converted for saving; kept until the value numbers are written and over both passes of binary compilers
 	C4LangStringTable   MainSysLangStringTable, ScenarioLangStringTable;
 	StdStrBuf           PlayerNames;
 	C4Control          &Input; // shortcut
@@ -268,7 +271,8 @@ protected:
 	bool PlaceInEarth(C4ID id);
 public:
 	void CompileFunc(StdCompiler *pComp, CompileSettings comp, C4ValueNumbers *);
-	bool SaveData(C4Group &hGroup, bool fSaveSection, bool fSaveExact, bool fSaveSync, C4ValueNumbers *);
+	bool SaveData(C4Group &hGroup, bool fSaveSection, bool fSaveExact, bool fSaveSync, bool fSaveBinary, C4ValueNumbers *);
+	bool HasRuntimeData() { return GameText.GetData() || GameBinaryLoaded; }
 protected:
 	bool CompileRuntimeData(C4Group &hGroup, InitMode init_mode, bool exact, bool sync, C4ValueNumbers *);
 
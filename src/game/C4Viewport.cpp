@@ -232,6 +232,9 @@ void C4Viewport::Draw(C4TargetFacet &cgo0, bool fDrawGame, bool fDrawOverlay)
 	{
 		// --- activate FoW here ---
 
+		// Relight landscape changes, which also invalidates the FoW in the changed area
+		::Landscape.DoRelights();
+
 		// Render FoW only if active for player
 		C4Player *pPlr = ::Players.Get(Player);
 		C4FoWRegion* pFoW = nullptr;
@@ -514,7 +514,8 @@ void C4DrawTransform::CompileFunc(StdCompiler *pComp)
 	}
 	pComp->Separator();
 	pComp->Value(FlipDir);
-	if (!deserializing && mat[6] == 0 && mat[7] == 0 && mat[8] == 1) return;
+	// omit default last row, unless the compiler cannot detect that (binary)
+	if (!deserializing && pComp->hasNaming() && mat[6] == 0 && mat[7] == 0 && mat[8] == 1) return;
 	// because of backwards-compatibility, the last row comes after flipdir
 	for (i = 6; i < 9; ++i)
 	{
@@ -20,6 +20,7 @@
 
 #include "C4ForbidLibraryCompilation.h"
 #include "lib/C4Rect.h"
+#include "platform/StdSync.h"
 
 // blitting modes
 #define C4GFXBLIT_NORMAL          0 // regular blit
@@ -46,6 +47,8 @@ class CStdGLCtx;
 extern CStdGL *pGL;
 #endif
 
+class CPNGFile;
+
 const int C4SF_Tileable = 1;
 const int C4SF_MipMap   = 2;
 const int C4SF_Unlocked = 4;
@@ -124,6 +127,8 @@ public:
 	bool SavePNG(const char *szFilename, bool fSaveAlpha, bool fSaveOverlayOnly, bool use_background_thread);
 	bool Read(CStdStream &hGroup, const char * extension, int iFlags);
 	bool ReadPNG(CStdStream &hGroup, int iFlags);
+	bool ReadPNG(const BYTE *pData, size_t iSize, int iFlags);
+	bool ReadPNG(CPNGFile &png, int iFlags); // from an already decoded image
 	bool ReadJPEG(CStdStream &hGroup, int iFlags);
 	bool ReadBMP(CStdStream &hGroup, int iFlags);
 
@@ -178,6 +183,34 @@ private:
 	friend class C4TexMgr;
 };
 
+// PNG images decoded ahead of time by background threads (see C4DefList::PreloadImages),
+// waiting to be picked up by the loader that would otherwise decode them itself
+class C4DecodedImageCache
+{
+private:
+	struct Image
+	{
+		std::unique_ptr<CPNGFile> png;
+		size_t iSourceSize; // size of the png file, to detect entries that changed in the meantime
+	};
+	std::map<std::string, Image> Images; // by full entry name
+	size_t iDecodedSize{0}; // memory held by all images
+	CStdCSec ImagesCSec;
+
+public:
+	C4DecodedImageCache();
+	~C4DecodedImageCache();
+
+	static const size_t MaxDecodedSize = 256 * 1024 * 1024;
+
+	bool Add(const char *szEntryName, size_t iSourceSize, std::unique_ptr<CPNGFile> png); // thread safe; fails if the memory limit is reached
+	std::unique_ptr<CPNGFile> Take(C4Group &hGroup, const char *szEntryName); // get and remove image of given group entry, if present
+	void Clear();
+	bool IsEmpty();
+};
+
+extern C4DecodedImageCache DecodedImages;
+
 // texture management
 class C4TexMgr
 {
@@ -123,7 +123,21 @@ bool C4Surface::Load(C4Group &hGroup, const char *szFilename, bool, bool fNoErrI
 		if (!fNoErrIfNotFound) LogF("%s: %s%c%s", LoadResStr("IDS_PRC_FILENOTFOUND"), hGroup.GetFullName().getData(), (char) DirectorySeparator, szFilename);
 		return false;
 	}
-	bool fSuccess = Read(hGroup, GetExtension(szFilename), iFlags);
+	bool fSuccess;
+	// PNGs are decoded from memory: read them straight from the group file if possible
+	if (SEqualNoCase(GetExtension(szFilename), "png"))
+	{
+		std::unique_ptr<CPNGFile> png = ::DecodedImages.Take(hGroup, szFilename);
+		if (png)
+			fSuccess = ReadPNG(*png, iFlags);
+		else
+		{
+			C4GroupEntryView view;
+			fSuccess = hGroup.LoadEntryView(szFilename, &view) && ReadPNG(static_cast<const BYTE *>(view.getData()), view.getSize(), iFlags);
+		}
+	}
+	else
+		fSuccess = Read(hGroup, GetExtension(szFilename), iFlags);
 	// loading error? log!
 	if (!fSuccess)
 		LogF("%s: %s%c%s", LoadResStr("IDS_ERR_NOFILE"), hGroup.GetFullName().getData(), (char) DirectorySeparator, szFilename);
@@ -155,12 +169,23 @@ bool C4Surface::ReadPNG(CStdStream &hGroup, int iFlags)
 	// load file into mem
 	hGroup.Read((void *) pData, iSize);
 	// load as png file
-	CPNGFile png;
-	bool fSuccess=png.Load(pData, iSize);
+	bool fSuccess=ReadPNG(pData, iSize, iFlags);
 	// free data
 	delete [] pData;
+	return fSuccess;
+}
+
+bool C4Surface::ReadPNG(const BYTE *pData, size_t iSize, int iFlags)
+{
+	// load as png file
+	CPNGFile png;
 	// abort if loading wasn't successful
-	if (!fSuccess) return false;
+	if (!png.Load(pData, iSize)) return false;
+	return ReadPNG(png, iFlags);
+}
+
+bool C4Surface::ReadPNG(CPNGFile &png, int iFlags)
+{
 	// create surface(s) - do not create an 8bit-buffer!
 	if (!Create(png.iWdt, png.iHgt, iFlags)) return false;
 	// lock for writing data
@@ -206,8 +231,65 @@ bool C4Surface::ReadPNG(CStdStream &hGroup, int iFlags)
 	// unlock
 	texture->Unlock();
 	Unlock();
-	// return if successful
-	return fSuccess;
+	// success
+	return true;
+}
+
+/* Decoded image cache */
+
+C4DecodedImageCache DecodedImages;
+
+C4DecodedImageCache::C4DecodedImageCache() = default;
+C4DecodedImageCache::~C4DecodedImageCache() = default;
+
+static size_t GetDecodedSize(const CPNGFile &png)
+{
+	return png.iWdt * png.iHgt * (png.iClrType == PNG_COLOR_TYPE_RGB_ALPHA ? 4 : 3);
+}
+
+bool C4DecodedImageCache::Add(const char *szEntryName, size_t iSourceSize, std::unique_ptr<CPNGFile> png)
+{
+	size_t iSize = GetDecodedSize(*png);
+	CStdLock ImagesLock(&ImagesCSec);
+	if (iDecodedSize + iSize > MaxDecodedSize) return false;
+	Image &image = Images[szEntryName];
+	if (image.png) return false; // decoded twice?
+	image.png = std::move(png);
+	image.iSourceSize = iSourceSize;
+	iDecodedSize += iSize;
+	return true;
+}
+
+std::unique_ptr<CPNGFile> C4DecodedImageCache::Take(C4Group &hGroup, const char *szEntryName)
+{
+	CStdLock ImagesLock(&ImagesCSec);
+	if (Images.empty()) return nullptr;
+	std::string name(hGroup.GetFullName().getData());
+	name += DirectorySeparator;
+	name += szEntryName;
+	auto it = Images.find(name);
+	if (it == Images.end()) return nullptr;
+	std::unique_ptr<CPNGFile> png = std::move(it->second.png);
+	size_t iSourceSize = it->second.iSourceSize;
+	Images.erase(it);
+	iDecodedSize -= GetDecodedSize(*png);
+	// file changed since decoding? Then the caller should load it again
+	size_t iSize;
+	if (!hGroup.FindEntry(szEntryName, nullptr, &iSize) || iSize != iSourceSize) return nullptr;
+	return png;
+}
+
+void C4DecodedImageCache::Clear()
+{
+	CStdLock ImagesLock(&ImagesCSec);
+	Images.clear();
+	iDecodedSize = 0;
+}
+
+bool C4DecodedImageCache::IsEmpty()
+{
+	CStdLock ImagesLock(&ImagesCSec);
+	return Images.empty();
 }
 
 bool C4Surface::SavePNG(C4Group &hGroup, const char *szFilename, bool fSaveAlpha, bool fSaveOverlayOnly)
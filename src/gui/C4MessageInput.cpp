@@ -25,6 +25,7 @@
 #include "graphics/C4GraphicsResource.h"
 #include "gui/C4Gui.h"
 #include "gui/C4GameLobby.h"
+#include "lib/C4Trace.h"
 #include "object/C4Object.h"
 #include "player/C4Player.h"
 #include "player/C4PlayerList.h"
@@ -567,6 +568,7 @@ bool C4MessageInput::ProcessCommand(const char *szCommand)
 		{
 			LogF("/fast [x] - %s", LoadResStr("IDS_TEXT_SETTOFASTMODESKIPPINGXFRA"));
 			LogF("/slow - %s", LoadResStr("IDS_TEXT_SETTONORMALSPEEDMODE"));
+			LogF("/trace [filename] - %s", LoadResStr("IDS_TEXT_STARTORSTOPRECORDINGAHOT"));
 			LogF("/chart - %s", LoadResStr("IDS_TEXT_DISPLAYNETWORKSTATISTICS"));
 			LogF("/nodebug - %s", LoadResStr("IDS_TEXT_PREVENTDEBUGMODEINTHISROU"));
 			LogF("/script [script] - %s", LoadResStr("IDS_TEXT_EXECUTEASCRIPTCOMMAND"));
@@ -711,6 +713,20 @@ bool C4MessageInput::ProcessCommand(const char *szCommand)
 		return true;
 	}
 
+	// start or stop recording a hot path trace
+	if (SEqual(szCmdName, "trace"))
+	{
+		if (!C4Trace::IsEnabled())
+		{
+			C4Trace::Start();
+			Log("Trace: Recording started");
+			return true;
+		}
+		C4Trace::Stop();
+		const char *szTraceFile = *pCmdPar ? pCmdPar : !Application.TraceFile.empty() ? Application.TraceFile.c_str() : Config.AtUserDataPath("Trace.json");
+		return C4Trace::WriteChromeTrace(szTraceFile);
+	}
+
 	if (SEqual(szCmdName, "nodebug"))
 	{
 		if (!Game.IsRunning) return false;
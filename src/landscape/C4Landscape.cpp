@@ -42,6 +42,7 @@
 #include "landscape/C4Weather.h"
 #include "landscape/fow/C4FoW.h"
 #include "lib/C4Random.h"
+#include "lib/C4Trace.h"
 #include "lib/StdColors.h"
 #include "object/C4Def.h"
 #include "object/C4FindObject.h"
@@ -61,7 +62,22 @@ struct C4Landscape::P
 	bool Pix2Light[C4M_MaxTexIndex];
 	int32_t PixCntPitch = 0;
 	std::vector<uint8_t> PixCnt;
-	std::array<C4Rect, C4LS_MaxRelights> Relights;
+	// revision of the last solidity change in each block; never reset, so revisions stay comparable across landscapes
+	uint32_t SolidRevision = 0;
+	int32_t SolidRevisionPitch = 0;
+	std::vector<uint32_t> SolidRevisions;
+	// Occupancy pyramid: solid and semi-solid pixel counts per tile. Level 0 uses tiles of
+	// 16x16 pixels, every further level merges 2x2 tiles of the one below, up to a single tile.
+	struct OccupancyLevel
+	{
+		int32_t Shift, Wdt, Hgt;
+		std::vector<int32_t> Solid, SemiSolid;
+	};
+	std::vector<OccupancyLevel> Occupancy;
+	// tiles changed since the last relight, row by row; marked per pixel and processed once per frame
+	int32_t RelightTilesPitch = 0;
+	std::vector<uint8_t> RelightTiles;
+	bool RelightsPending = false;
 	mutable std::array<std::unique_ptr<uint8_t[]>, C4M_MaxTexIndex> BridgeMatConversion; // NoSave //
 
 	LandscapeMode mode = LandscapeMode::Undefined;
@@ -69,6 +85,11 @@ struct C4Landscape::P
 	int32_t MapWidth = 0, MapHeight = 0, MapZoom = 0;
 	std::array<DWORD, C4MaxMaterial> MatCount{}; // NoSave //
 	std::array<DWORD, C4MaxMaterial> EffectiveMatCount{}; // NoSave //
+	// Per column pixel counts of the materials that can convert by temperature,
+	// so that ExecuteScan can skip columns in which nothing would happen
+	std::array<int32_t, C4MaxMaterial> TempConvSlot{}; // NoSave // 1 + index into a column's counts, or 0 if the material never converts
+	int32_t TempConvNum = 0; // NoSave //
+	std::vector<DWORD> ColumnTempConvCount; // NoSave //
 
 	bool NoScan = false; // ExecuteScan() disabled
 	int32_t ScanX = 0, ScanSpeed = 2; // SyncClearance-NoSave //
@@ -79,11 +100,21 @@ struct C4Landscape::P
 	C4Sky Sky;
 	std::unique_ptr<C4MapCreatorS2> pMapCreator; // map creator for script-generated maps
 	bool fMapChanged = false;
-	std::unique_ptr<BYTE[]> pInitial; // Initial landscape after creation - used for diff
-	std::unique_ptr<BYTE[]> pInitialBkg; // Initial bkg landscape after creation - used for diff
+	// version of the last pixel write in each tile; never reset, like the solid revisions
+	uint32_t TileVersion = 0;
+	int32_t TilePitch = 0;
+	std::vector<uint32_t> TileVersions;
+	// Initial landscape after creation - used for diff. Kept copy-on-write: a tile's foreground
+	// and background pixels are copied right before the first write to it after SaveInitial,
+	// so tiles that never change cost nothing. Empty if no initial landscape was saved.
+	std::vector<std::unique_ptr<BYTE[]>> InitialTiles;
 	std::unique_ptr<C4FoW> pFoW;
 
 	void ClearMatCount();
+	void CountTempConv(int32_t x, int32_t mat, int32_t change)
+	{
+		if (TempConvSlot[mat]) ColumnTempConvCount[x * TempConvNum + TempConvSlot[mat] - 1] += change;
+	}
 
 	void ExecuteScan(C4Landscape *);
 	int32_t DoScan(C4Landscape *, int32_t x, int32_t y, int32_t mat, int32_t dir);
@@ -101,6 +132,32 @@ struct C4Landscape::P
 	bool CreateMapS2(C4Group &ScenFile, CSurface8*& sfcMap, CSurface8*& sfcMapBkg); // create map by def file
 	bool Mat2Pal(); // assign material colors to landscape palette
 	void UpdatePixCnt(const C4Landscape *, const C4Rect &Rect, bool fCheck = false);
+	void MarkSolidChanged(int32_t x, int32_t y) { if (!SolidRevisions.empty()) SolidRevisions[(y >> C4LS_SolidRevisionShift) * SolidRevisionPitch + (x >> C4LS_SolidRevisionShift)] = ++SolidRevision; }
+	void MarkSolidChanged(C4Rect Rect);
+	void TouchTile(int32_t x, int32_t y)
+	{
+		if (TileVersions.empty()) return;
+		int32_t iTile = (y >> C4LS_TileShift) * TilePitch + (x >> C4LS_TileShift);
+		if (!InitialTiles.empty() && !InitialTiles[iTile]) SaveInitialTile(iTile);
+		TileVersions[iTile] = ++TileVersion;
+	}
+	void TouchTiles(C4Rect Rect);
+	void SaveInitialTile(int32_t iTile);
+	bool GetDiff(CSurface8 &sfcDiff, CSurface8 &sfcDiffBkg, bool &rfChanged, bool &rfChangedBkg) const; // pixels changed since SaveInitial; all others set to C4M_MaxTexIndex
+	void InitOccupancy();
+	void UpdateOccupancy(C4Rect Rect);
+	void ChangeOccupancy(int32_t x, int32_t y, int32_t iSolid, int32_t iSemiSolid)
+	{
+		if (!iSolid && !iSemiSolid) return;
+		for (OccupancyLevel &level : Occupancy)
+		{
+			int32_t i = (y >> level.Shift) * level.Wdt + (x >> level.Shift);
+			level.Solid[i] += iSolid; level.SemiSolid[i] += iSemiSolid;
+		}
+	}
+	int32_t CountOccupancy(bool fSemiSolid, const C4Rect &Rect) const;
+	int32_t CountOccupancy(bool fSemiSolid, int32_t iLevel, int32_t tx, int32_t ty, const C4Rect &Rect) const;
+	void MarkRelight(C4Rect Rect);
 	void UpdateMatCnt(const C4Landscape *, C4Rect Rect, bool fPlus);
 	void PrepareChange(const C4Landscape *d, const C4Rect &BoundingBox);
 	void FinishChange(C4Landscape *d, C4Rect BoundingBox);
@@ -129,8 +186,9 @@ struct C4Landscape::P
 
 namespace
 {
+	template<typename Callback>
 	bool ForLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
-		std::function<bool(int32_t, int32_t)> fnCallback,
+		Callback fnCallback,
 		int32_t *lastx = nullptr, int32_t *lasty = nullptr)
 	{
 		int d, dx, dy, aincr, bincr, xincr, yincr, x, y;
@@ -217,26 +275,37 @@ void C4Landscape::P::ExecuteScan(C4Landscape *d)
 {
 	int32_t cy, mat;
 
-	// Check: Scan needed?
+	// Check: Scan needed? Collect the column count slots of all materials that would convert.
 	const int32_t iTemperature = ::Weather.GetTemperature();
+	std::array<int32_t, C4MaxMaterial> active_slots;
+	int32_t active_num = 0;
 	for (mat = 0; mat < ::MaterialMap.Num; mat++)
 		if (MatCount[mat])
 		{
-			if (::MaterialMap.Map[mat].BelowTempConvertTo &&
-				iTemperature < ::MaterialMap.Map[mat].BelowTempConvert)
-				break;
-			else if (::MaterialMap.Map[mat].AboveTempConvertTo &&
-				iTemperature > ::MaterialMap.Map[mat].AboveTempConvert)
-				break;
+			if ((::MaterialMap.Map[mat].BelowTempConvertTo &&
+				iTemperature < ::MaterialMap.Map[mat].BelowTempConvert) ||
+				(::MaterialMap.Map[mat].AboveTempConvertTo &&
+				iTemperature > ::MaterialMap.Map[mat].AboveTempConvert))
+			{
+				assert(TempConvSlot[mat]);
+				active_slots[active_num++] = TempConvSlot[mat] - 1;
+			}
 		}
-	if (mat >= ::MaterialMap.Num)
+	if (!active_num)
 		return;
 
 	if (DEBUGREC_MATSCAN && Config.General.DebugRec)
 		AddDbgRec(RCT_MatScan, &ScanX, sizeof(ScanX));
 
-	for (int32_t cnt = 0; cnt < ScanSpeed; cnt++)
+	for (int32_t cnt = 0; cnt < ScanSpeed; cnt++, ScanX = (ScanX + 1 < Width ? ScanX + 1 : 0))
 	{
+		// DoScan does nothing unless the column contains a material that converts
+		const DWORD *column_count = &ColumnTempConvCount[ScanX * TempConvNum];
+		bool convertible = false;
+		for (int32_t i = 0; i < active_num && !convertible; i++)
+			convertible = column_count[active_slots[i]] != 0;
+		if (!convertible)
+			continue;
 
 		// Scan landscape column: sectors down
 		int32_t last_mat = -1;
@@ -255,12 +324,6 @@ void C4Landscape::P::ExecuteScan(C4Landscape *d)
 			}
 			last_mat = mat;
 		}
-
-		// Scan advance & rewind
-		ScanX++;
-		if (ScanX >= Width)
-			ScanX = 0;
-
 	}
 
 }
@@ -396,26 +459,44 @@ void C4Landscape::Draw(C4TargetFacet &cgo, C4FoWRegion *pLight)
 
 bool C4Landscape::DoRelights()
 {
-	if (!p->pLandscapeRender) return true;
-	for (int32_t i = 0; i < C4LS_MaxRelights; i++)
-	{
-		if (!p->Relights[i].Wdt)
-			break;
-		// Remove all solid masks in the (twice!) extended region around the change
-		C4Rect SolidMaskRect = p->pLandscapeRender->GetAffectedRect(p->Relights[i]);
-		C4SolidMask * pSolid;
-		for (pSolid = C4SolidMask::Last; pSolid; pSolid = pSolid->Prev)
-			pSolid->RemoveTemporary(SolidMaskRect);
-		// Perform the update
-		p->pLandscapeRender->Update(p->Relights[i], this);
-		if (p->pFoW) p->pFoW->Ambient.UpdateFromLandscape(*this, p->Relights[i]);
-		// Restore Solidmasks
-		for (pSolid = C4SolidMask::First; pSolid; pSolid = pSolid->Next)
-			pSolid->PutTemporary(SolidMaskRect);
-		C4SolidMask::CheckConsistency();
-		// Clear slot
-		p->Relights[i].Default();
-	}
+	C4TraceScope TraceScope("Landscape", "DoRelights");
+	if (!p->pLandscapeRender || !p->RelightsPending) return true;
+	p->RelightsPending = false;
+	int32_t iPitch = p->RelightTilesPitch, iTilesHgt = p->RelightTiles.size() / iPitch;
+	uint8_t *pTiles = p->RelightTiles.data();
+	for (int32_t ty = 0; ty < iTilesHgt; ty++)
+		for (int32_t tx = 0; tx < iPitch; tx++)
+		{
+			if (!pTiles[ty * iPitch + tx])
+				continue;
+			// Coalesce the run of changed tiles in this row, extended over the following rows
+			// in which the same run changed as well
+			int32_t tx2 = tx, ty2 = ty;
+			while (tx2 + 1 < iPitch && pTiles[ty * iPitch + tx2 + 1]) ++tx2;
+			while (ty2 + 1 < iTilesHgt && std::find(pTiles + (ty2 + 1) * iPitch + tx, pTiles + (ty2 + 1) * iPitch + tx2 + 1, 0) == pTiles + (ty2 + 1) * iPitch + tx2 + 1) ++ty2;
+			for (int32_t y = ty; y <= ty2; y++)
+				std::fill(pTiles + y * iPitch + tx, pTiles + y * iPitch + tx2 + 1, 0);
+			C4Rect Relight(tx << C4LS_RelightTileShift, ty << C4LS_RelightTileShift, (tx2 - tx + 1) << C4LS_RelightTileShift, (ty2 - ty + 1) << C4LS_RelightTileShift);
+			Relight.Intersect(C4Rect(0, 0, GetWidth(), GetHeight()));
+			tx = tx2;
+			// Remove all solid masks in the (twice!) extended region around the change
+			C4Rect SolidMaskRect = p->pLandscapeRender->GetAffectedRect(Relight);
+			std::vector<C4SolidMask *> SolidMasks;
+			C4SolidMask::GetPutMasks(SolidMaskRect, SolidMasks);
+			for (auto pSolid = SolidMasks.rbegin(); pSolid != SolidMasks.rend(); ++pSolid)
+				(*pSolid)->RemoveTemporary(SolidMaskRect);
+			// Perform the update
+			p->pLandscapeRender->Update(Relight, this);
+			if (p->pFoW)
+			{
+				p->pFoW->Invalidate(Relight);
+				p->pFoW->Ambient.UpdateFromLandscape(*this, Relight);
+			}
+			// Restore Solidmasks
+			for (C4SolidMask *pSolid : SolidMasks)
+				pSolid->PutTemporary(SolidMaskRect);
+			C4SolidMask::CheckConsistency();
+		}
 	return true;
 }
 
@@ -480,6 +561,8 @@ static std::vector<int32_t> GetRectangle(int32_t tx, int32_t ty, int32_t wdt, in
 	return vertices;
 }
 
+#include <chrono>
+long long DbgPolyNs = 0;
 static C4Rect getBoundingBox(int *vtcs, int length)
 {
 	C4Rect BoundingBox(vtcs[0], vtcs[1], 1, 1);
@@ -492,6 +575,7 @@ static C4Rect getBoundingBox(int *vtcs, int length)
 
 void C4Landscape::ClearFreeRect(int32_t tx, int32_t ty, int32_t wdt, int32_t hgt)
 {
+	C4TraceScope TraceScope("Landscape", "ClearFreeRect");
 	std::vector<int32_t> vertices(GetRectangle(tx, ty, wdt, hgt));
 	C4Rect r(tx, ty, wdt, hgt);
 	p->PrepareChange(this, r);
@@ -519,6 +603,7 @@ void C4Landscape::BlastFree(int32_t tx, int32_t ty, int32_t rad, int32_t caused_
 
 void C4Landscape::ShakeFree(int32_t tx, int32_t ty, int32_t rad)
 {
+	C4TraceScope TraceScope("Landscape", "ShakeFree");
 	std::vector<int32_t> vertices(GetRoundPolygon(tx, ty, rad, 50));
 	p->ForPolygon(this, &vertices[0], vertices.size() / 2, [this](int32_t x, int32_t y) { return p->ShakeFreePix(this, x, y); });
 }
@@ -560,6 +645,7 @@ void C4Landscape::P::PostFreeShape(C4ValueArray *dig_objects, C4Object *by_objec
 
 int32_t C4Landscape::DigFreeShape(int *vtcs, int length, C4Object *by_object, bool no_dig2objects, bool no_instability_check)
 {
+	C4TraceScope TraceScope("Landscape", "DigFreeShape");
 	using namespace std::placeholders;
 
 	C4Rect BoundingBox = getBoundingBox(vtcs, length);
@@ -603,6 +689,7 @@ int32_t C4Landscape::DigFreeShape(int *vtcs, int length, C4Object *by_object, bo
 
 void C4Landscape::BlastFreeShape(int *vtcs, int length, C4Object *by_object, int32_t by_player, int32_t iMaxDensity)
 {
+	C4TraceScope TraceScope("Landscape", "BlastFreeShape");
 	C4MaterialList *MaterialContents = nullptr;
 
 	C4Rect BoundingBox = getBoundingBox(vtcs, length);
@@ -829,8 +916,8 @@ bool C4Landscape::_SetPix2(int32_t x, int32_t y, BYTE fgPix, BYTE bgPix)
 	// count material
 	assert(!fgPix || MatValid(p->Pix2Mat[fgPix]));
 	int32_t omat = p->Pix2Mat[opix], nmat = p->Pix2Mat[fgPix];
-	if (opix) p->MatCount[omat]--;
-	if (fgPix) p->MatCount[nmat]++;
+	if (opix) { p->MatCount[omat]--; p->CountTempConv(x, omat, -1); }
+	if (fgPix) { p->MatCount[nmat]++; p->CountTempConv(x, nmat, +1); }
 	// count effective material
 	if (omat != nmat)
 	{
@@ -869,23 +956,18 @@ bool C4Landscape::_SetPix2(int32_t x, int32_t y, BYTE fgPix, BYTE bgPix)
 			}
 		}
 	}
+	// note solidity changes for cached path finding results
+	int32_t odens = p->Pix2Dens[opix], ndens = p->Pix2Dens[fgPix];
+	if (DensitySolid(ndens) != DensitySolid(odens))
+		p->MarkSolidChanged(x, y);
+	p->ChangeOccupancy(x, y, DensitySolid(ndens) - DensitySolid(odens), DensitySemiSolid(ndens) - DensitySemiSolid(odens));
 	// set 8bpp-surface only!
+	p->TouchTile(x, y);
 	p->Surface8->SetPix(x, y, fgPix);
 	p->Surface8Bkg->SetPix(x, y, bgPix);
-	// note for relight
+	// note for relight and FoW invalidation
 	if (p->pLandscapeRender)
-	{
-		C4Rect CheckRect = p->pLandscapeRender->GetAffectedRect(C4Rect(x, y, 1, 1));
-		for (int32_t i = 0; i < C4LS_MaxRelights; i++)
-			if (!p->Relights[i].Wdt || p->Relights[i].Overlap(CheckRect) || i + 1 >= C4LS_MaxRelights)
-			{
-				p->Relights[i].Add(CheckRect);
-				break;
-			}
-		// Invalidate FoW
-		if (p->pFoW)
-			p->pFoW->Invalidate(CheckRect);
-	}
+		p->MarkRelight(p->pLandscapeRender->GetAffectedRect(C4Rect(x, y, 1, 1)));
 	// success
 	return true;
 }
@@ -894,7 +976,15 @@ void C4Landscape::_SetPix2Tmp(int32_t x, int32_t y, BYTE fgPix, BYTE bgPix)
 {
 	// set 8bpp-surface only!
 	assert(x >= 0 && y >= 0 && x < GetWidth() && y < GetHeight());
-	if (fgPix != Transparent) p->Surface8->SetPix(x, y, fgPix);
+	p->TouchTile(x, y);
+	if (fgPix != Transparent)
+	{
+		int32_t odens = p->Pix2Dens[_GetPix(x, y)], ndens = p->Pix2Dens[fgPix];
+		if (DensitySolid(ndens) != DensitySolid(odens))
+			p->MarkSolidChanged(x, y);
+		p->ChangeOccupancy(x, y, DensitySolid(ndens) - DensitySolid(odens), DensitySemiSolid(ndens) - DensitySemiSolid(odens));
+		p->Surface8->SetPix(x, y, fgPix);
+	}
 	if (bgPix != Transparent) p->Surface8Bkg->SetPix(x, y, bgPix);
 }
 
@@ -937,6 +1027,7 @@ void C4Landscape::CheckInstabilityRange(int32_t tx, int32_t ty)
 }
 void C4Landscape::DrawMaterialRect(int32_t mat, int32_t tx, int32_t ty, int32_t wdt, int32_t hgt)
 {
+	C4TraceScope TraceScope("Landscape", "DrawMaterialRect");
 	int32_t cx, cy;
 	for (cy = ty; cy < ty + hgt; cy++)
 		for (cx = tx; cx < tx + wdt; cx++)
@@ -946,6 +1037,7 @@ void C4Landscape::DrawMaterialRect(int32_t mat, int32_t tx, int32_t ty, int32_t
 
 void C4Landscape::RaiseTerrain(int32_t tx, int32_t ty, int32_t wdt)
 {
+	C4TraceScope TraceScope("Landscape", "RaiseTerrain");
 	int32_t cx, cy;
 	BYTE cpix;
 	for (cx = tx; cx < tx + wdt; cx++)
@@ -1223,6 +1315,7 @@ CPolyEdge QuickPolyBuf[QuickPolyBufSize];
 int32_t C4Landscape::P::ForPolygon(C4Landscape *d, int *vtcs, int length, const std::function<bool(int32_t, int32_t)> &callback,
 	C4MaterialList *mats_count, uint8_t col, uint8_t colBkg, uint8_t *conversion_table)
 {
+	auto dbgT0 = std::chrono::steady_clock::now();
 	// Variables for polygon drawer
 	int c, x1, x2, y;
 	int top = INT_MAX;
@@ -1348,6 +1441,7 @@ int32_t C4Landscape::P::ForPolygon(C4Landscape *d, int *vtcs, int length, const
 	// Clear scratch memory
 	if (!use_qpb) delete[] edgebuf;
 
+	DbgPolyNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - dbgT0).count();
 	return amount;
 }
 
@@ -1381,19 +1475,25 @@ void C4Landscape::Clear(bool fClearMapCreator, bool fClearSky, bool fClearRender
 	p->Surface8Bkg.reset();
 	p->Map.reset();
 	p->MapBkg.reset();
+	if (DbgPolyNs) LogF("polyms %lld", DbgPolyNs / 1000000); DbgPolyNs = 0;
 	// clear initial landscape
-	p->pInitial.reset();
-	p->pInitialBkg.reset();
+	p->InitialTiles.clear();
+	p->TileVersions.clear();
+	p->TilePitch = 0;
 	p->pFoW.reset();
-	// clear relight array
-	for (auto &relight : p->Relights)
-		relight.Default();
+	// clear relight tiles
+	p->RelightTiles.clear();
+	p->RelightTilesPitch = 0;
+	p->RelightsPending = false;
 	// clear scan
 	p->ScanX = 0;
 	p->mode = LandscapeMode::Undefined;
 	// clear pixel count
 	p->PixCnt.clear();
 	p->PixCntPitch = 0;
+	p->SolidRevisions.clear();
+	p->SolidRevisionPitch = 0;
+	p->Occupancy.clear();
 	// clear bridge material conversion temp buffers
 	for (auto &conv : p->BridgeMatConversion)
 		conv.reset();
@@ -1603,6 +1703,14 @@ bool C4Landscape::Init(C4Group &hGroup, bool fOverloadCurrent, bool fLoadSky, bo
 	int32_t PixCntWidth = (GetWidth() + 16) / 17;
 	p->PixCntPitch = (GetHeight() + 14) / 15;
 	p->PixCnt.resize(PixCntWidth * p->PixCntPitch);
+	// A new landscape counts as changed everywhere
+	p->SolidRevisionPitch = ((GetWidth() - 1) >> C4LS_SolidRevisionShift) + 1;
+	p->SolidRevisions.assign(p->SolidRevisionPitch * (((GetHeight() - 1) >> C4LS_SolidRevisionShift) + 1), ++p->SolidRevision);
+	p->InitOccupancy();
+	p->TilePitch = ((GetWidth() - 1) >> C4LS_TileShift) + 1;
+	p->TileVersions.assign(p->TilePitch * (((GetHeight() - 1) >> C4LS_TileShift) + 1), ++p->TileVersion);
+	p->RelightTilesPitch = ((GetWidth() - 1) >> C4LS_RelightTileShift) + 1;
+	p->RelightTiles.assign(p->RelightTilesPitch * (((GetHeight() - 1) >> C4LS_RelightTileShift) + 1), 0);
 
 	// map to big surface and sectionize it
 	// (not for shaders though - they require continous textures)
@@ -1681,6 +1789,7 @@ bool C4Landscape::Init(C4Group &hGroup, bool fOverloadCurrent, bool fLoadSky, bo
 
 	// Pixel count tracking from landscape zoom is incomplete, so recalculate it.
 	p->UpdatePixCnt(this, C4Rect(0, 0, GetWidth(), GetHeight()));
+	p->UpdateOccupancy(C4Rect(0, 0, GetWidth(), GetHeight()));
 	p->ClearMatCount();
 	p->UpdateMatCnt(this, C4Rect(0, 0, GetWidth(), GetHeight()), true);
 
@@ -1757,31 +1866,27 @@ bool C4Landscape::SaveDiff(C4Group &hGroup, bool fSyncSave) const
 
 bool C4Landscape::P::SaveDiffInternal(const C4Landscape *d, C4Group &hGroup, bool fSyncSave) const
 {
-	assert(pInitial && pInitialBkg);
-	if (!pInitial || !pInitialBkg) return false;
+	assert(!InitialTiles.empty());
+	if (InitialTiles.empty()) return false;
 
-	// If it shouldn't be sync-save: Clear all bytes that have not changed, i.e.
-	// set them to C4M_MaxTexIndex
-	bool fChanged = false, fChangedBkg = false;;
+	// If it shouldn't be sync-save: Save only the bytes that have changed, all
+	// others are set to C4M_MaxTexIndex
+	CSurface8 *pSave = Surface8.get(), *pSaveBkg = Surface8Bkg.get();
+	std::unique_ptr<CSurface8> pDiff, pDiffBkg;
+	bool fChanged = false, fChangedBkg = false;
 	if (!fSyncSave)
-		for (int y = 0; y < Height; y++)
-			for (int x = 0; x < Width; x++)
-			{
-				if (pInitial[y * Width + x] == Surface8->_GetPix(x, y))
-					Surface8->SetPix(x, y, C4M_MaxTexIndex);
-				else
-					fChanged = true;
-
-				if (pInitialBkg[y * Width + x] == Surface8Bkg->_GetPix(x, y))
-					Surface8Bkg->SetPix(x, y, C4M_MaxTexIndex);
-				else
-					fChangedBkg = true;
-			}
+	{
+		pDiff = std::make_unique<CSurface8>(Width, Height);
+		pDiffBkg = std::make_unique<CSurface8>(Width, Height);
+		if (!GetDiff(*pDiff, *pDiffBkg, fChanged, fChangedBkg))
+			return false;
+		pSave = pDiff.get(); pSaveBkg = pDiffBkg.get();
+	}
 
 	if (fSyncSave || fChanged)
 	{
 		// Save landscape surface
-		if (!Surface8->Save(Config.AtTempPath(C4CFN_TempLandscape)))
+		if (!pSave->Save(Config.AtTempPath(C4CFN_TempLandscape), Surface8->pPal))
 			return false;
 
 		// Move temp file to group
@@ -1793,7 +1898,7 @@ bool C4Landscape::P::SaveDiffInternal(const C4Landscape *d, C4Group &hGroup, boo
 	if (fSyncSave || fChangedBkg)
 	{
 		// Save landscape surface
-		if (!Surface8Bkg->Save(Config.AtTempPath(C4CFN_TempLandscapeBkg)))
+		if (!pSaveBkg->Save(Config.AtTempPath(C4CFN_TempLandscapeBkg), Surface8Bkg->pPal))
 			return false;
 
 		// Move temp file to group
@@ -1802,17 +1907,6 @@ bool C4Landscape::P::SaveDiffInternal(const C4Landscape *d, C4Group &hGroup, boo
 			return false;
 	}
 
-	// Restore landscape pixels
-	if (!fSyncSave)
-		for (int y = 0; y < Height; y++)
-			for (int x = 0; x < Width; x++)
-			{
-				if (Surface8->_GetPix(x, y) == C4M_MaxTexIndex)
-					Surface8->SetPix(x, y, pInitial[y * Width + x]);
-				if (Surface8Bkg->_GetPix(x, y) == C4M_MaxTexIndex)
-					Surface8Bkg->SetPix(x, y, pInitialBkg[y * Width + x]);
-			}
-
 	// Save changed map, too
 	if (fMapChanged && Map)
 		if (!d->SaveMap(hGroup)) return false;
@@ -1825,22 +1919,9 @@ bool C4Landscape::P::SaveDiffInternal(const C4Landscape *d, C4Group &hGroup, boo
 
 bool C4Landscape::SaveInitial()
 {
-
-	// Create array
-	p->pInitial = std::make_unique<BYTE[]>(GetWidth() * GetHeight());
-	p->pInitialBkg = std::make_unique<BYTE[]>(GetWidth() * GetHeight());
-
-	// Save material data
-	for (int y = 0; y < GetHeight(); y++)
-	{
-		const int pitch = y * GetWidth();
-		for (int x = 0; x < GetWidth(); x++)
-		{
-			p->pInitial[pitch + x] = p->Surface8->_GetPix(x, y);
-			p->pInitialBkg[pitch + x] = p->Surface8Bkg->_GetPix(x, y);
-		}
-	}
-
+	// Nothing is copied yet: every tile keeps its initial pixels until it is written to
+	p->InitialTiles.clear();
+	p->InitialTiles.resize(p->TileVersions.size());
 	return true;
 }
 
@@ -1928,11 +2009,17 @@ bool C4Landscape::ApplyDiff(C4Group &hGroup)
 	{
 		if (pDiff && pDiff->GetPix(x, y) != C4M_MaxTexIndex)
 			if (p->Surface8->_GetPix(x, y) != (byPix = pDiff->_GetPix(x, y)))
+			{
 				// material has changed here: readjust with new texture
+				p->TouchTile(x, y);
 				p->Surface8->SetPix(x, y, byPix);
+			}
 		if (pDiffBkg && pDiffBkg->GetPix(x, y) != C4M_MaxTexIndex)
 			if (p->Surface8Bkg->_GetPix(x, y) != (byPix = pDiffBkg->_GetPix(x, y)))
+			{
+				p->TouchTile(x, y);
 				p->Surface8Bkg->_SetPix(x, y, byPix);
+			}
 	}
 
 	// done
@@ -1948,6 +2035,14 @@ void C4Landscape::P::ClearMatCount()
 {
 	std::fill(MatCount.begin(), MatCount.end(), 0);
 	std::fill(EffectiveMatCount.begin(), EffectiveMatCount.end(), 0);
+	// assign column count slots to all materials that can convert by temperature
+	TempConvNum = 0;
+	for (int32_t mat = 0; mat < C4MaxMaterial; mat++)
+	{
+		bool converts = mat < ::MaterialMap.Num && (::MaterialMap.Map[mat].BelowTempConvertTo || ::MaterialMap.Map[mat].AboveTempConvertTo);
+		TempConvSlot[mat] = converts ? ++TempConvNum : 0;
+	}
+	ColumnTempConvCount.assign(Width * TempConvNum, 0);
 }
 
 void C4Landscape::Synchronize()
@@ -2462,6 +2557,22 @@ int32_t C4Landscape::GetMatHeight(int32_t x, int32_t y, int32_t iYDir, int32_t i
 // Nearest free above semi solid
 bool AboveSemiSolid(int32_t &rx, int32_t &ry)
 {
+	// Inside the landscape, look up the nearest changes in both directions through the occupancy pyramid
+	if (Inside<int32_t>(rx, 0, ::Landscape.GetWidth() - 1) && Inside<int32_t>(ry, 0, ::Landscape.GetHeight() - 1))
+	{
+		// Upwards: first free pixel above semi solid
+		int32_t cy1 = ::Landscape.FindInColumn(rx, ry, -1, true, true);
+		if (cy1 >= 0) cy1 = ::Landscape.FindInColumn(rx, cy1, -1, true, false);
+		// Downwards: first semi solid pixel below free
+		int32_t cy2 = ::Landscape.FindInColumn(rx, ry, +1, true, false);
+		if (cy2 < ::Landscape.GetHeight()) cy2 = ::Landscape.FindInColumn(rx, cy2, +1, true, true);
+		// Closer one wins; upwards on a tie
+		bool fUp = cy1 >= 0, fDown = cy2 < ::Landscape.GetHeight();
+		if (fUp && (!fDown || ry - cy1 <= cy2 - ry)) { ry = cy1; return true; }
+		if (fDown) { ry = cy2; return true; }
+		return false;
+	}
+
 	int32_t cy1 = ry, cy2 = ry;
 	bool UseUpwardsNextFree = false, UseDownwardsNextSolid = false;
 
@@ -3308,14 +3419,53 @@ bool C4Landscape::FindMatPathPush(int32_t &fx, int32_t &fy, int32_t mdens, int32
 
 int32_t C4Landscape::AreaSolidCount(int32_t x, int32_t y, int32_t wdt, int32_t hgt) const
 {
-	int32_t cx, cy, ascnt = 0;
+	if (wdt <= 0 || hgt <= 0) return 0;
+	// Pixels inside the landscape are counted by the occupancy pyramid
+	C4Rect Rect(x, y, wdt, hgt), InRect = Rect;
+	InRect.Intersect(C4Rect(0, 0, GetWidth(), GetHeight()));
+	int32_t ascnt = 0;
+	if (InRect.Wdt && InRect.Hgt)
+		ascnt = p->CountOccupancy(false, InRect);
+	if (InRect == Rect) return ascnt;
+	// Border pixels outside are checked one by one
+	int32_t cx, cy;
 	for (cy = y; cy < y + hgt; cy++)
 		for (cx = x; cx < x + wdt; cx++)
-			if (GBackSolid(cx, cy))
-				ascnt++;
+			if (!InRect.Contains(cx, cy))
+				if (GBackSolid(cx, cy))
+					ascnt++;
 	return ascnt;
 }
 
+int32_t C4Landscape::FindInColumn(int32_t x, int32_t y, int32_t iYDir, bool fSemiSolid, bool fWanted) const
+{
+	assert(x >= 0 && x < GetWidth() && (iYDir == 1 || iYDir == -1));
+	const int32_t iThreshold = fSemiSolid ? C4M_SemiSolid : C4M_Solid;
+	for (; y >= 0 && y < GetHeight(); y += iYDir)
+	{
+		// Skip the largest tile around the pixel that holds nothing but the unwanted state
+		int32_t iSkipLevel = -1;
+		for (int32_t iLevel = 0; iLevel < int32_t(p->Occupancy.size()); ++iLevel)
+		{
+			const P::OccupancyLevel &level = p->Occupancy[iLevel];
+			int32_t tx = x >> level.Shift, ty = y >> level.Shift;
+			int32_t iCount = (fSemiSolid ? level.SemiSolid : level.Solid)[ty * level.Wdt + tx];
+			if (fWanted ? iCount != 0 : iCount != (std::min((tx + 1) << level.Shift, GetWidth()) - (tx << level.Shift)) * (std::min((ty + 1) << level.Shift, GetHeight()) - (ty << level.Shift)))
+				break;
+			iSkipLevel = iLevel;
+		}
+		if (iSkipLevel >= 0)
+		{
+			int32_t iShift = p->Occupancy[iSkipLevel].Shift;
+			y = iYDir > 0 ? (((y >> iShift) + 1) << iShift) - 1 : (y >> iShift) << iShift;
+			continue;
+		}
+		if ((p->Pix2Dens[_GetPix(x, y)] >= iThreshold) == fWanted)
+			return y;
+	}
+	return iYDir > 0 ? GetHeight() : -1;
+}
+
 void C4Landscape::FindMatTop(int32_t mat, int32_t &x, int32_t &y, bool distant_first) const
 {
 	int32_t mslide, cslide, tslide, distant_x = 0;
@@ -3395,6 +3545,7 @@ bool C4Landscape::P::GetMapColorIndex(const char *szMaterial, const char *szText
 
 bool C4Landscape::DrawBrush(int32_t iX, int32_t iY, int32_t iGrade, const char *szMaterial, const char *szTexture, const char *szBackMaterial, const char *szBackTexture)
 {
+	C4TraceScope TraceScope("Landscape", "DrawBrush");
 	BYTE byCol, byColBkg;
 	// Get map color index by material-texture
 	if (!p->GetMapColorIndex(szMaterial, szTexture, byCol)) return false;
@@ -3469,6 +3620,7 @@ bool C4Landscape::P::DrawLineMap(int32_t iX, int32_t iY, int32_t iRadius, uint8_
 
 bool C4Landscape::DrawLine(int32_t iX1, int32_t iY1, int32_t iX2, int32_t iY2, int32_t iGrade, const char *szMaterial, const char *szTexture, const char *szBackMaterial, const char *szBackTexture)
 {
+	C4TraceScope TraceScope("Landscape", "DrawLine");
 	// Get map color index by material-texture
 	uint8_t line_color, line_color_bkg;
 	if (!p->GetMapColorIndex(szMaterial, szTexture, line_color)) return false;
@@ -3519,6 +3671,7 @@ bool C4Landscape::DrawLine(int32_t iX1, int32_t iY1, int32_t iX2, int32_t iY2, i
 
 bool C4Landscape::DrawBox(int32_t iX1, int32_t iY1, int32_t iX2, int32_t iY2, int32_t iGrade, const char *szMaterial, const char *szTexture, const char *szBackMaterial, const char *szBackTexture)
 {
+	C4TraceScope TraceScope("Landscape", "DrawBox");
 	// get upper-left/lower-right - corners
 	int32_t iX0 = std::min(iX1, iX2); int32_t iY0 = std::min(iY1, iY2);
 	iX2 = std::max(iX1, iX2); iY2 = std::max(iY1, iY2); iX1 = iX0; iY1 = iY0;
@@ -3565,6 +3718,7 @@ bool C4Landscape::DrawBox(int32_t iX1, int32_t iY1, int32_t iX2, int32_t iY2, in
 
 bool C4Landscape::DrawChunks(int32_t tx, int32_t ty, int32_t wdt, int32_t hgt, int32_t icntx, int32_t icnty, const char *szMaterial, const char *szTexture, bool bIFT)
 {
+	C4TraceScope TraceScope("Landscape", "DrawChunks");
 	BYTE byColor;
 	if (!p->GetMapColorIndex(szMaterial, szTexture, byColor)) return false;
 
@@ -3576,6 +3730,8 @@ bool C4Landscape::DrawChunks(int32_t tx, int32_t ty, int32_t wdt, int32_t hgt, i
 
 	C4Rect BoundingBox(tx - 5, ty - 5, wdt + 10, hgt + 10);
 	p->PrepareChange(this, BoundingBox);
+	// the clipper below includes its right and bottom edge
+	p->TouchTiles(C4Rect(BoundingBox.x, BoundingBox.y, BoundingBox.Wdt + 1, BoundingBox.Hgt + 1));
 
 	// assign clipper
 	p->Surface8->Clip(BoundingBox.x, BoundingBox.y, BoundingBox.x + BoundingBox.Wdt, BoundingBox.y + BoundingBox.Hgt);
@@ -3600,6 +3756,7 @@ bool C4Landscape::DrawChunks(int32_t tx, int32_t ty, int32_t wdt, int32_t hgt, i
 
 bool C4Landscape::DrawPolygon(int *vtcs, int length, const char *szMaterial, const char* szBackMaterial, bool fDrawBridge)
 {
+	C4TraceScope TraceScope("Landscape", "DrawPolygon");
 	if (length < 6) return false;
 	if (length % 2 == 1) return false;
 	// get texture
@@ -3866,6 +4023,7 @@ uint8_t *C4Landscape::P::GetBridgeMatConversion(const C4Landscape *d, int32_t fo
 
 bool C4Landscape::DrawQuad(int32_t iX1, int32_t iY1, int32_t iX2, int32_t iY2, int32_t iX3, int32_t iY3, int32_t iX4, int32_t iY4, const char *szMaterial, const char *szBackMaterial, bool fDrawBridge)
 {
+	C4TraceScope TraceScope("Landscape", "DrawQuad");
 	// set vertices
 	int32_t vtcs[8];
 	vtcs[0] = iX1; vtcs[1] = iY1;
@@ -3893,11 +4051,15 @@ void C4Landscape::P::PrepareChange(const C4Landscape *d, const C4Rect &BoundingB
 	C4Rect SolidMaskRect = BoundingBox;
 	if (pLandscapeRender)
 		SolidMaskRect = pLandscapeRender->GetAffectedRect(pLandscapeRender->GetAffectedRect(SolidMaskRect));
-	for (C4SolidMask * pSolid = C4SolidMask::Last; pSolid; pSolid = pSolid->Prev)
+	std::vector<C4SolidMask *> SolidMasks;
+	C4SolidMask::GetPutMasks(SolidMaskRect, SolidMasks);
+	for (auto pSolid = SolidMasks.rbegin(); pSolid != SolidMasks.rend(); ++pSolid)
 	{
-		pSolid->RemoveTemporary(SolidMaskRect);
+		(*pSolid)->RemoveTemporary(SolidMaskRect);
 	}
 	UpdateMatCnt(d, BoundingBox, false);
+	// the change may write directly to the surfaces
+	TouchTiles(BoundingBox);
 }
 
 void C4Landscape::P::FinishChange(C4Landscape *d, C4Rect BoundingBox)
@@ -3913,12 +4075,16 @@ void C4Landscape::P::FinishChange(C4Landscape *d, C4Rect BoundingBox)
 	C4Rect SolidMaskRect = BoundingBox;
 	if (pLandscapeRender)
 		SolidMaskRect = pLandscapeRender->GetAffectedRect(pLandscapeRender->GetAffectedRect(SolidMaskRect));
-	for (C4SolidMask * pSolid = C4SolidMask::First; pSolid; pSolid = pSolid->Next)
+	std::vector<C4SolidMask *> SolidMasks;
+	C4SolidMask::GetPutMasks(SolidMaskRect, SolidMasks);
+	for (C4SolidMask *pSolid : SolidMasks)
 	{
 		pSolid->Repair(SolidMaskRect);
 	}
 	C4SolidMask::CheckConsistency();
 	UpdatePixCnt(d, BoundingBox);
+	UpdateOccupancy(BoundingBox);
+	MarkSolidChanged(BoundingBox);
 	// update FoW
 	if (pFoW)
 	{
@@ -3934,6 +4100,7 @@ void C4Landscape::P::FinishChange(C4Landscape *d, C4Rect BoundingBox)
 
 bool C4Landscape::DrawMap(int32_t iX, int32_t iY, int32_t iWdt, int32_t iHgt, const char *szMapDef, bool ignoreSky)
 {
+	C4TraceScope TraceScope("Landscape", "DrawMap");
 	// safety
 	if (!szMapDef) return false;
 	// clip to landscape size
@@ -3964,6 +4131,7 @@ bool C4Landscape::DrawMap(int32_t iX, int32_t iY, int32_t iWdt, int32_t iHgt, co
 
 bool C4Landscape::DrawDefMap(int32_t iX, int32_t iY, int32_t iWdt, int32_t iHgt, const char *szMapDef, bool ignoreSky)
 {
+	C4TraceScope TraceScope("Landscape", "DrawDefMap");
 	// safety
 	if (!szMapDef || !p->pMapCreator) return false;
 	// clip to landscape size
@@ -4207,6 +4375,9 @@ void C4Landscape::UpdatePixMaps()
 	for (i = 0; i < C4M_MaxTexIndex; i++) p->Pix2Place[i] = MatValid(p->Pix2Mat[i]) ? ::MaterialMap.Map[p->Pix2Mat[i]].Placement : 0;
 	for (i = 0; i < C4M_MaxTexIndex; i++) p->Pix2Light[i] = MatValid(p->Pix2Mat[i]) && (::MaterialMap.Map[p->Pix2Mat[i]].Light>0);
 	p->Pix2Place[0] = 0;
+	// densities may have changed anywhere
+	p->MarkSolidChanged(C4Rect(0, 0, GetWidth(), GetHeight()));
+	p->UpdateOccupancy(C4Rect(0, 0, GetWidth(), GetHeight()));
 	// clear bridge mat conversion buffers
 	std::fill(p->BridgeMatConversion.begin(), p->BridgeMatConversion.end(), nullptr);
 }
@@ -4231,6 +4402,217 @@ bool C4Landscape::P::Mat2Pal()
 }
 
 
+void C4Landscape::P::MarkSolidChanged(C4Rect Rect)
+{
+	Rect.Intersect(C4Rect(0, 0, Width, Height));
+	if (!Rect.Wdt || !Rect.Hgt || SolidRevisions.empty()) return;
+	++SolidRevision;
+	for (int32_t y = Rect.y >> C4LS_SolidRevisionShift; y <= (Rect.y + Rect.Hgt - 1) >> C4LS_SolidRevisionShift; y++)
+		for (int32_t x = Rect.x >> C4LS_SolidRevisionShift; x <= (Rect.x + Rect.Wdt - 1) >> C4LS_SolidRevisionShift; x++)
+			SolidRevisions[y * SolidRevisionPitch + x] = SolidRevision;
+}
+
+void C4Landscape::P::TouchTiles(C4Rect Rect)
+{
+	Rect.Intersect(C4Rect(0, 0, Width, Height));
+	if (!Rect.Wdt || !Rect.Hgt || TileVersions.empty()) return;
+	++TileVersion;
+	for (int32_t y = Rect.y >> C4LS_TileShift; y <= (Rect.y + Rect.Hgt - 1) >> C4LS_TileShift; y++)
+		for (int32_t x = Rect.x >> C4LS_TileShift; x <= (Rect.x + Rect.Wdt - 1) >> C4LS_TileShift; x++)
+		{
+			int32_t iTile = y * TilePitch + x;
+			if (!InitialTiles.empty() && !InitialTiles[iTile]) SaveInitialTile(iTile);
+			TileVersions[iTile] = TileVersion;
+		}
+}
+
+void C4Landscape::P::SaveInitialTile(int32_t iTile)
+{
+	// foreground rows followed by background rows, each of full tile width
+	const int32_t iTileSize = 1 << C4LS_TileShift;
+	const int32_t tx = (iTile % TilePitch) << C4LS_TileShift, ty = (iTile / TilePitch) << C4LS_TileShift;
+	const int32_t iWdt = std::min(iTileSize, Width - tx), iHgt = std::min(iTileSize, Height - ty);
+	InitialTiles[iTile] = std::make_unique<BYTE[]>(2 * iTileSize * iTileSize);
+	BYTE *pTile = InitialTiles[iTile].get();
+	for (int32_t y = 0; y < iHgt; y++)
+	{
+		memcpy(pTile + y * iTileSize, Surface8->Bits + (ty + y) * Surface8->Pitch + tx, iWdt);
+		memcpy(pTile + (iTileSize + y) * iTileSize, Surface8Bkg->Bits + (ty + y) * Surface8Bkg->Pitch + tx, iWdt);
+	}
+}
+
+bool C4Landscape::P::GetDiff(CSurface8 &sfcDiff, CSurface8 &sfcDiffBkg, bool &rfChanged, bool &rfChangedBkg) const
+{
+	if (InitialTiles.empty() || !sfcDiff.Bits || !sfcDiffBkg.Bits) return false;
+	memset(sfcDiff.Bits, C4M_MaxTexIndex, sfcDiff.Pitch * sfcDiff.Hgt);
+	memset(sfcDiffBkg.Bits, C4M_MaxTexIndex, sfcDiffBkg.Pitch * sfcDiffBkg.Hgt);
+	rfChanged = rfChangedBkg = false;
+	// Only tiles that have been written to can differ from the initial landscape
+	const int32_t iTileSize = 1 << C4LS_TileShift;
+	for (size_t iTile = 0; iTile < InitialTiles.size(); ++iTile)
+	{
+		const BYTE *pTile = InitialTiles[iTile].get();
+		if (!pTile) continue;
+		const int32_t tx = (iTile % TilePitch) << C4LS_TileShift, ty = (iTile / TilePitch) << C4LS_TileShift;
+		const int32_t iWdt = std::min(iTileSize, Width - tx), iHgt = std::min(iTileSize, Height - ty);
+		for (int32_t y = 0; y < iHgt; y++)
+			for (int32_t x = 0; x < iWdt; x++)
+			{
+				BYTE byPix = Surface8->_GetPix(tx + x, ty + y);
+				if (pTile[y * iTileSize + x] != byPix)
+				{
+					sfcDiff._SetPix(tx + x, ty + y, byPix);
+					rfChanged = true;
+				}
+				byPix = Surface8Bkg->_GetPix(tx + x, ty + y);
+				if (pTile[(iTileSize + y) * iTileSize + x] != byPix)
+				{
+					sfcDiffBkg._SetPix(tx + x, ty + y, byPix);
+					rfChangedBkg = true;
+				}
+			}
+	}
+	return true;
+}
+
+void C4Landscape::P::MarkRelight(C4Rect Rect)
+{
+	Rect.Intersect(C4Rect(0, 0, Width, Height));
+	if (Rect.Wdt <= 0 || Rect.Hgt <= 0 || RelightTiles.empty()) return;
+	for (int32_t y = Rect.y >> C4LS_RelightTileShift; y <= (Rect.y + Rect.Hgt - 1) >> C4LS_RelightTileShift; y++)
+		for (int32_t x = Rect.x >> C4LS_RelightTileShift; x <= (Rect.x + Rect.Wdt - 1) >> C4LS_RelightTileShift; x++)
+			RelightTiles[y * RelightTilesPitch + x] = 1;
+	RelightsPending = true;
+}
+
+uint32_t C4Landscape::GetSolidRevision() const
+{
+	return p->SolidRevision;
+}
+
+uint32_t C4Landscape::GetSolidRevision(C4Rect Rect) const
+{
+	// Without a landscape, everything is always new
+	Rect.Intersect(C4Rect(0, 0, GetWidth(), GetHeight()));
+	if (p->SolidRevisions.empty()) return p->SolidRevision;
+	if (!Rect.Wdt || !Rect.Hgt) return 0;
+	uint32_t iRevision = 0;
+	for (int32_t y = Rect.y >> C4LS_SolidRevisionShift; y <= (Rect.y + Rect.Hgt - 1) >> C4LS_SolidRevisionShift; y++)
+		for (int32_t x = Rect.x >> C4LS_SolidRevisionShift; x <= (Rect.x + Rect.Wdt - 1) >> C4LS_SolidRevisionShift; x++)
+			iRevision = std::max(iRevision, p->SolidRevisions[y * p->SolidRevisionPitch + x]);
+	return iRevision;
+}
+
+uint32_t C4Landscape::GetTileVersion(C4Rect Rect) const
+{
+	// Without a landscape, everything is always new
+	Rect.Intersect(C4Rect(0, 0, GetWidth(), GetHeight()));
+	if (p->TileVersions.empty()) return p->TileVersion;
+	if (!Rect.Wdt || !Rect.Hgt) return 0;
+	uint32_t iVersion = 0;
+	for (int32_t y = Rect.y >> C4LS_TileShift; y <= (Rect.y + Rect.Hgt - 1) >> C4LS_TileShift; y++)
+		for (int32_t x = Rect.x >> C4LS_TileShift; x <= (Rect.x + Rect.Wdt - 1) >> C4LS_TileShift; x++)
+			iVersion = std::max(iVersion, p->TileVersions[y * p->TilePitch + x]);
+	return iVersion;
+}
+
+void C4Landscape::P::InitOccupancy()
+{
+	Occupancy.clear();
+	for (int32_t iShift = C4LS_OccupancyShift; ; ++iShift)
+	{
+		OccupancyLevel level;
+		level.Shift = iShift;
+		level.Wdt = ((Width - 1) >> iShift) + 1;
+		level.Hgt = ((Height - 1) >> iShift) + 1;
+		level.Solid.assign(level.Wdt * level.Hgt, 0);
+		level.SemiSolid.assign(level.Wdt * level.Hgt, 0);
+		Occupancy.push_back(std::move(level));
+		if (Occupancy.back().Wdt == 1 && Occupancy.back().Hgt == 1) break;
+	}
+}
+
+void C4Landscape::P::UpdateOccupancy(C4Rect Rect)
+{
+	Rect.Intersect(C4Rect(0, 0, Width, Height));
+	if (!Rect.Wdt || !Rect.Hgt || Occupancy.empty() || !Surface8) return;
+	// Recount the finest tiles from the pixels...
+	OccupancyLevel &base = Occupancy[0];
+	for (int32_t ty = Rect.y >> base.Shift; ty <= (Rect.y + Rect.Hgt - 1) >> base.Shift; ty++)
+		for (int32_t tx = Rect.x >> base.Shift; tx <= (Rect.x + Rect.Wdt - 1) >> base.Shift; tx++)
+		{
+			int32_t iSolid = 0, iSemiSolid = 0;
+			for (int32_t y = ty << base.Shift; y < std::min<int32_t>((ty + 1) << base.Shift, Height); y++)
+				for (int32_t x = tx << base.Shift; x < std::min<int32_t>((tx + 1) << base.Shift, Width); x++)
+				{
+					int32_t iDens = Pix2Dens[Surface8->_GetPix(x, y)];
+					iSolid += DensitySolid(iDens);
+					iSemiSolid += DensitySemiSolid(iDens);
+				}
+			base.Solid[ty * base.Wdt + tx] = iSolid;
+			base.SemiSolid[ty * base.Wdt + tx] = iSemiSolid;
+		}
+	// ...and sum them up in the levels above
+	for (size_t i = 1; i < Occupancy.size(); ++i)
+	{
+		const OccupancyLevel &lower = Occupancy[i - 1];
+		OccupancyLevel &level = Occupancy[i];
+		for (int32_t ty = Rect.y >> level.Shift; ty <= (Rect.y + Rect.Hgt - 1) >> level.Shift; ty++)
+			for (int32_t tx = Rect.x >> level.Shift; tx <= (Rect.x + Rect.Wdt - 1) >> level.Shift; tx++)
+			{
+				int32_t iSolid = 0, iSemiSolid = 0;
+				for (int32_t y = ty * 2; y < std::min<int32_t>(ty * 2 + 2, lower.Hgt); y++)
+					for (int32_t x = tx * 2; x < std::min<int32_t>(tx * 2 + 2, lower.Wdt); x++)
+					{
+						iSolid += lower.Solid[y * lower.Wdt + x];
+						iSemiSolid += lower.SemiSolid[y * lower.Wdt + x];
+					}
+				level.Solid[ty * level.Wdt + tx] = iSolid;
+				level.SemiSolid[ty * level.Wdt + tx] = iSemiSolid;
+			}
+	}
+}
+
+int32_t C4Landscape::P::CountOccupancy(bool fSemiSolid, const C4Rect &Rect) const
+{
+	// Rect must lie within the landscape
+	if (Occupancy.empty()) return 0;
+	return CountOccupancy(fSemiSolid, Occupancy.size() - 1, 0, 0, Rect);
+}
+
+int32_t C4Landscape::P::CountOccupancy(bool fSemiSolid, int32_t iLevel, int32_t tx, int32_t ty, const C4Rect &Rect) const
+{
+	const OccupancyLevel &level = Occupancy[iLevel];
+	int32_t iCount = (fSemiSolid ? level.SemiSolid : level.Solid)[ty * level.Wdt + tx];
+	if (!iCount) return 0;
+	C4Rect Tile(tx << level.Shift, ty << level.Shift, 1 << level.Shift, 1 << level.Shift);
+	Tile.Intersect(C4Rect(0, 0, Width, Height));
+	C4Rect Overlap = Tile;
+	Overlap.Intersect(Rect);
+	if (!Overlap.Wdt || !Overlap.Hgt) return 0;
+	// Tile completely counted or completely filled?
+	if (Overlap == Tile) return iCount;
+	if (iCount == Tile.Wdt * Tile.Hgt) return Overlap.Wdt * Overlap.Hgt;
+	// Count pixels of the finest tiles
+	if (!iLevel)
+	{
+		const int32_t iThreshold = fSemiSolid ? C4M_SemiSolid : C4M_Solid;
+		iCount = 0;
+		for (int32_t y = Overlap.y; y < Overlap.y + Overlap.Hgt; y++)
+			for (int32_t x = Overlap.x; x < Overlap.x + Overlap.Wdt; x++)
+				if (Pix2Dens[Surface8->_GetPix(x, y)] >= iThreshold)
+					++iCount;
+		return iCount;
+	}
+	// Descend into the tiles of the level below
+	const OccupancyLevel &lower = Occupancy[iLevel - 1];
+	iCount = 0;
+	for (int32_t y = ty * 2; y < std::min<int32_t>(ty * 2 + 2, lower.Hgt); y++)
+		for (int32_t x = tx * 2; x < std::min<int32_t>(tx * 2 + 2, lower.Wdt); x++)
+			iCount += CountOccupancy(fSemiSolid, iLevel - 1, x, y, Rect);
+	return iCount;
+}
+
 void C4Landscape::P::UpdatePixCnt(const C4Landscape *d, const C4Rect &Rect, bool fCheck)
 {
 	int32_t PixCntWidth = (Width + 16) / 17;
@@ -4271,6 +4653,7 @@ void C4Landscape::P::UpdateMatCnt(const C4Landscape *d, C4Rect Rect, bool fPlus)
 				{
 					// Normal material counting
 					MatCount[iMat] += iMul * (iHgt + 1);
+					CountTempConv(Rect.x + x, iMat, iMul * (iHgt + 1));
 					// Effective material counting enabled?
 					if (int32_t iMinHgt = ::MaterialMap.Map[iMat].MinHeightCount)
 					{
@@ -4297,6 +4680,7 @@ void C4Landscape::P::UpdateMatCnt(const C4Landscape *d, C4Rect Rect, bool fPlus)
 		{
 			// Normal material counting
 			MatCount[iMat] += iMul * (iHgt + 1);
+			CountTempConv(Rect.x + x, iMat, iMul * (iHgt + 1));
 			// Minimum height counting?
 			if (int32_t iMinHgt = ::MaterialMap.Map[iMat].MinHeightCount)
 			{
@@ -24,7 +24,10 @@
 
 const int32_t C4MaxMaterial = 125;
 
-const int32_t C4LS_MaxRelights = 50;
+const int32_t C4LS_RelightTileShift = 6; // relights and FoW invalidation are collected in tiles of 64x64 pixels
+const int32_t C4LS_SolidRevisionShift = 6; // solidity changes are tracked in blocks of 64x64 pixels
+const int32_t C4LS_OccupancyShift = 4; // the finest level of the occupancy pyramid counts pixels in tiles of 16x16
+const int32_t C4LS_TileShift = 6; // pixel writes are versioned and the initial landscape is kept copy-on-write in tiles of 64x64
 
 enum class LandscapeMode
 {
@@ -132,6 +135,10 @@ public:
 	int32_t GetMatHeight(int32_t x, int32_t y, int32_t iYDir, int32_t iMat, int32_t iMax) const;
 
 	int32_t AreaSolidCount(int32_t x, int32_t y, int32_t wdt, int32_t hgt) const;
+	int32_t FindInColumn(int32_t x, int32_t y, int32_t iYDir, bool fSemiSolid, bool fWanted) const; // first row from y on (inside the landscape) where the pixel is (semi)solid or not; -1 or GetHeight() if there is none
+	uint32_t GetSolidRevision() const; // raised with every change of pixel solidity
+	uint32_t GetSolidRevision(C4Rect Rect) const; // revision of the last solidity change within the rect
+	uint32_t GetTileVersion(C4Rect Rect) const; // version of the last pixel write (foreground or background) within the rect
 	int32_t ExtractMaterial(int32_t fx, int32_t fy, bool distant_first);
 	bool DrawMap(int32_t iX, int32_t iY, int32_t iWdt, int32_t iHgt, const char *szMapDef, bool ignoreSky = false); // creates and draws a map section using MapCreatorS2
 	bool ClipRect(int32_t &rX, int32_t &rY, int32_t &rWdt, int32_t &rHgt) const; // clip given rect by landscape size; return whether anything is left unclipped
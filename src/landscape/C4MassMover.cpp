@@ -37,6 +37,12 @@
 // running slower and smoother, overall MM counts are much lower,
 // hardly ever exceeding 1000.                          October 1997
 
+// The slot array has since been replaced by a compact list of active
+// movers. Movers created during a pass are collected separately and
+// merged in before the next pass, which keeps the triangular flow
+// described above. The list is grouped by landscape regions, so movers
+// of one lake are executed together on warm landscape memory.
+
 C4MassMoverSet::C4MassMoverSet()
 {
 	Default();
@@ -49,48 +55,79 @@ C4MassMoverSet::~C4MassMoverSet()
 
 void C4MassMoverSet::Clear()
 {
-
+	// Release memory of drained sets
+	Movers.clear(); Movers.shrink_to_fit();
+	Created.clear(); Created.shrink_to_fit();
+	RegroupBuffer.clear(); RegroupBuffer.shrink_to_fit();
+	RegionOffsets.clear(); RegionOffsets.shrink_to_fit();
+	Count=0;
 }
 
 void C4MassMoverSet::Execute()
 {
-	C4MassMover *cmm;
-	// Init counts
-	Count=0;
-	// Execute & count
 	for (int32_t speed = 2; speed>0; speed--)
 	{
-		cmm = &(Set[C4MassMoverChunk-1]);
-		for (int32_t cnt = 0; cnt<C4MassMoverChunk; cnt++,cmm--)
-			if (cmm->Mat!=MNone)
-				{ Count++; cmm->Execute(); }
+		// Merge new movers and drop ceased ones
+		Regroup();
+		// Movers created meanwhile go to Created and wait for the next pass
+		for (C4MassMover &mover : Movers)
+			if (mover.Mat!=MNone)
+				mover.Execute();
 	}
 }
 
 bool C4MassMoverSet::Create(int32_t x, int32_t y, bool fExecute)
 {
-	if (Count == C4MassMoverChunk) return false;
+	if (Count >= GetMaxCount()) return false;
 	if (Config.General.DebugRec)
 	{
 		C4RCMassMover rc;
 		rc.x=x; rc.y=y;
 		AddDbgRec(RCT_MMC, &rc, sizeof(rc));
 	}
-	int32_t cptr=CreatePtr;
-	do
+	// Execute before storing: the movers created by this one may grow the list
+	C4MassMover mover;
+	if (!mover.Init(x,y)) return false;
+	Count++; CreateCount++;
+	if (fExecute) mover.Execute();
+	if (mover.Mat!=MNone) Created.push_back(mover);
+	return true;
+}
+
+int32_t C4MassMoverSet::GetMaxCount() const
+{
+	return std::max<int32_t>(C4MassMoverChunk, ::Landscape.GetWidth() * ::Landscape.GetHeight() / C4MassMoverPixelsPerMover);
+}
+
+void C4MassMoverSet::Regroup()
+{
+	// Nothing ceased or created: order is unchanged
+	if (Created.empty() && Movers.size() == size_t(Count)) return;
+	// Stable counting sort by region. Lower regions go first, so falling
+	// liquid makes room for the liquid above it within the same pass.
+	const int32_t regionsX = std::max<int32_t>(1, ((::Landscape.GetWidth() - 1) >> C4MassMoverRegionShift) + 1);
+	const int32_t regionsY = std::max<int32_t>(1, ((::Landscape.GetHeight() - 1) >> C4MassMoverRegionShift) + 1);
+	auto GetRegion = [regionsX, regionsY](const C4MassMover &mover)
 	{
-		cptr++;
-		if (cptr>=C4MassMoverChunk) cptr=0;
-		if (Set[cptr].Mat==MNone)
-		{
-			if (!Set[cptr].Init(x,y)) return false;
-			CreatePtr=cptr;
-			if (fExecute) Set[cptr].Execute();
-			return true;
-		}
-	}
-	while (cptr!=CreatePtr);
-	return false;
+		int32_t rx = Clamp<int32_t>(mover.x >> C4MassMoverRegionShift, 0, regionsX - 1);
+		int32_t ry = Clamp<int32_t>(mover.y >> C4MassMoverRegionShift, 0, regionsY - 1);
+		return (regionsY - 1 - ry) * regionsX + rx;
+	};
+	RegionOffsets.assign(regionsX * regionsY + 1, 0);
+	for (const std::vector<C4MassMover> *list : { &Movers, &Created })
+		for (const C4MassMover &mover : *list)
+			if (mover.Mat!=MNone)
+				RegionOffsets[GetRegion(mover) + 1]++;
+	for (size_t region = 1; region < RegionOffsets.size(); region++)
+		RegionOffsets[region] += RegionOffsets[region - 1];
+	RegroupBuffer.resize(RegionOffsets.back());
+	for (const std::vector<C4MassMover> *list : { &Movers, &Created })
+		for (const C4MassMover &mover : *list)
+			if (mover.Mat!=MNone)
+				RegroupBuffer[RegionOffsets[GetRegion(mover)]++] = mover;
+	Movers.swap(RegroupBuffer);
+	Created.clear();
+	Count = Movers.size();
 }
 
 void C4MassMoverSet::Draw()
@@ -105,7 +142,6 @@ bool C4MassMover::Init(int32_t tx, int32_t ty)
 	// Check mat
 	Mat=GBackMat(tx,ty);
 	x=tx; y=ty;
-	::MassMover.Count++;
 	return (Mat!=MNone);
 }
 
@@ -182,30 +218,29 @@ bool C4MassMover::Corrosion(int32_t dx, int32_t dy)
 
 void C4MassMoverSet::Default()
 {
-	int32_t cnt;
-	for (cnt=0; cnt<C4MassMoverChunk; cnt++) Set[cnt].Mat=MNone;
+	Movers.clear();
+	Created.clear();
 	Count=0;
-	CreatePtr=0;
+	CreateCount=0;
 }
 
 bool C4MassMoverSet::Save(C4Group &hGroup)
 {
-	int32_t cnt;
-	// Consolidate
-	Consolidate();
-	// Recount
-	Count=0;
-	for (cnt=0; cnt<C4MassMoverChunk; cnt++)
-		if (Set[cnt].Mat!=MNone)
-			Count++;
 	// All empty: delete component
 	if (!Count)
 	{
 		hGroup.Delete(C4CFN_MassMover);
 		return true;
 	}
-	// Save set
-	if (!hGroup.Add(C4CFN_MassMover,Set,Count*sizeof(C4MassMover)))
+	// Save active movers in execution order
+	StdBuf Buf;
+	Buf.New(Count*sizeof(C4MassMover));
+	C4MassMover *pOut = getMBufPtr<C4MassMover>(Buf);
+	for (const std::vector<C4MassMover> *list : { &Movers, &Created })
+		for (const C4MassMover &mover : *list)
+			if (mover.Mat!=MNone)
+				*pOut++ = mover;
+	if (!hGroup.Add(C4CFN_MassMover,Buf,false,true))
 		return false;
 	// Success
 	return true;
@@ -219,52 +254,25 @@ bool C4MassMoverSet::Load(C4Group &hGroup)
 	if (!hGroup.AccessEntry(C4CFN_MassMover,&iBinSize)) return false;
 	if ((iBinSize % iMoverSize)!=0) return false;
 	// load new
-	Count = iBinSize / iMoverSize;
-	if (!hGroup.Read(Set,iBinSize)) return false;
+	Movers.resize(iBinSize / iMoverSize);
+	if (!hGroup.Read(Movers.data(),iBinSize)) { Movers.clear(); return false; }
+	Count = Movers.size();
 	return true;
 }
 
-void C4MassMoverSet::Consolidate()
-{
-	// Consolidate set
-	int32_t iSpot,iPtr,iConsolidated;
-	for (iSpot=-1,iPtr=0,iConsolidated=0; iPtr<C4MassMoverChunk; iPtr++)
-	{
-		// Empty: set new spot if needed
-		if (Set[iPtr].Mat==MNone)
-		{
-			if (iSpot==-1) iSpot=iPtr;
-		}
-		// Full: move down to empty spot if possible
-		else if (iSpot!=-1)
-		{
-			// Move to spot
-			Set[iSpot]=Set[iPtr];
-			Set[iPtr].Mat=MNone;
-			iConsolidated++;
-			// Advance empty spot (as far as ptr)
-			for (; iSpot<iPtr; iSpot++)
-				if (Set[iSpot].Mat==MNone)
-					break;
-			// No empty spot below ptr
-			if (iSpot==iPtr) iSpot=-1;
-		}
-	}
-	// Reset create ptr
-	CreatePtr=0;
-}
-
 void C4MassMoverSet::Synchronize()
 {
-	Consolidate();
+	Regroup();
+	CreateCount=0;
 }
 
 void C4MassMoverSet::Copy(C4MassMoverSet &rSet)
 {
 	Clear();
 	Count=rSet.Count;
-	CreatePtr=rSet.CreatePtr;
-	for (int32_t cnt=0; cnt<C4MassMoverChunk; cnt++) Set[cnt]=rSet.Set[cnt];
+	CreateCount=rSet.CreateCount;
+	Movers=rSet.Movers;
+	Created=rSet.Created;
 }
 
 C4MassMoverSet MassMover;
@@ -20,7 +20,11 @@
 #ifndef INC_C4MassMover
 #define INC_C4MassMover
 
-const int32_t C4MassMoverChunk = 10000;
+#include <vector>
+
+const int32_t C4MassMoverChunk = 10000; // minimum capacity, also for small landscapes
+const int32_t C4MassMoverPixelsPerMover = 32; // larger landscapes allow one mover per this many pixels
+const int32_t C4MassMoverRegionShift = 5; // movers are executed in regions of 32x32 pixels
 
 class C4MassMover
 {
@@ -41,9 +45,12 @@ public:
 	~C4MassMoverSet();
 public:
 	int32_t Count;
-	int32_t CreatePtr;
+	int32_t CreateCount; // movers created since the last synchronization; part of the sync check
 protected:
-	C4MassMover Set[C4MassMoverChunk];
+	std::vector<C4MassMover> Movers; // executed movers, grouped by region
+	std::vector<C4MassMover> Created; // movers created since the last grouping
+	std::vector<C4MassMover> RegroupBuffer;
+	std::vector<int32_t> RegionOffsets;
 public:
 	void Copy(C4MassMoverSet &rSet);
 	void Synchronize();
@@ -54,8 +61,9 @@ public:
 	bool Create(int32_t x, int32_t y, bool fExecute=false);
 	bool Load(C4Group &hGroup);
 	bool Save(C4Group &hGroup);
+	int32_t GetMaxCount() const;
 protected:
-	void Consolidate();
+	void Regroup();
 };
 
 extern C4MassMoverSet MassMover;
@@ -22,6 +22,7 @@
 
 #include "c4group/C4Components.h"
 #include "control/C4Record.h"
+#include "game/C4Game.h"
 #include "game/C4Physics.h"
 #include "graphics/C4Draw.h"
 #include "landscape/C4Weather.h"
@@ -157,41 +158,76 @@ C4PXSSystem::~C4PXSSystem()
 
 void C4PXSSystem::Default()
 {
-	Count=0;
+	Clear();
 }
 
 void C4PXSSystem::Clear()
 {
-	Count=0;
+	Mat.clear();
+	X.clear(); Y.clear();
+	XDir.clear(); YDir.clear();
+}
+
+C4PXS C4PXSSystem::Get(size_t i) const
+{
+	C4PXS pxs;
+	pxs.Mat = Mat[i];
+	pxs.x = X[i]; pxs.y = Y[i];
+	pxs.xdir = XDir[i]; pxs.ydir = YDir[i];
+	return pxs;
+}
+
+void C4PXSSystem::Set(size_t i, const C4PXS &pxs)
+{
+	Mat[i] = pxs.Mat;
+	X[i] = pxs.x; Y[i] = pxs.y;
+	XDir[i] = pxs.xdir; YDir[i] = pxs.ydir;
 }
 
-C4PXS* C4PXSSystem::New()
+void C4PXSSystem::Add(const C4PXS &pxs)
 {
-	if (Count < PXSMax)
-		return &PXS[Count++];
-	return nullptr;
+	Mat.push_back(pxs.Mat);
+	X.push_back(pxs.x); Y.push_back(pxs.y);
+	XDir.push_back(pxs.xdir); YDir.push_back(pxs.ydir);
+}
+
+void C4PXSSystem::Remove(size_t i)
+{
+	// Replace by the last one, like the fixed array always did
+	size_t last = Mat.size() - 1;
+	if (i != last) Set(i, Get(last));
+	Mat.pop_back();
+	X.pop_back(); Y.pop_back();
+	XDir.pop_back(); YDir.pop_back();
 }
 
 bool C4PXSSystem::Create(int32_t mat, C4Real ix, C4Real iy, C4Real ixdir, C4Real iydir)
 {
-	C4PXS *pxp;
 	if (!MatValid(mat)) return false;
-	if (!(pxp=New())) return false;
-	pxp->Mat=mat;
-	pxp->x=ix; pxp->y=iy;
-	pxp->xdir=ixdir; pxp->ydir=iydir;
+	if (GetCount() >= Game.C4S.Landscape.MaxPXS) return false;
+	C4PXS pxs;
+	pxs.Mat=mat;
+	pxs.x=ix; pxs.y=iy;
+	pxs.xdir=ixdir; pxs.ydir=iydir;
+	Add(pxs);
 	return true;
 }
 
 void C4PXSSystem::Execute()
 {
-	for (size_t i = 0; i < Count; i++)
+	// PXS are executed one by one in a copy, because material reactions may
+	// create new PXS and thus reallocate the arrays. New PXS are executed in
+	// the same frame.
+	for (size_t i = 0; i < Mat.size(); i++)
 	{
-		if (!PXS[i].Execute())
+		C4PXS pxs = Get(i);
+		if (!pxs.Execute())
 		{
-			assert(PXS[i].Mat == MNone);
-			PXS[i--] = PXS[--Count];
+			assert(pxs.Mat == MNone);
+			Remove(i--);
 		}
+		else
+			Set(i, pxs);
 	}
 }
 
@@ -211,11 +247,11 @@ void C4PXSSystem::Draw(C4TargetFacet &cgo)
 
 	float cgox = cgo.X - cgo.TargetX, cgoy = cgo.Y - cgo.TargetY;
 	// First pass: draw simple PXS (lines/pixels)
-	for (size_t i = 0; i < Count; i++)
+	for (size_t i = 0; i < Mat.size(); i++)
 	{
-		C4PXS *pxp = &PXS[i];
-		if (pxp->Mat != MNone && VisibleRect.Contains(fixtoi(pxp->x), fixtoi(pxp->y)))
+		if (Mat[i] != MNone && VisibleRect.Contains(fixtoi(X[i]), fixtoi(Y[i])))
 		{
+			C4PXS pxs = Get(i), *pxp = &pxs;
 			C4Material *pMat = &::MaterialMap.Map[pxp->Mat];
 			const DWORD dwMatClr = ::Landscape.GetPal()->GetClr((BYTE) (Mat2PixColDefault(pxp->Mat)));
 			if(pMat->PXSFace.Surface)
@@ -324,7 +360,7 @@ void C4PXSSystem::Cast(int32_t mat, int32_t num, int32_t tx, int32_t ty, int32_t
 
 bool C4PXSSystem::Save(C4Group &hGroup)
 {
-	if (Count == 0)
+	if (Mat.empty())
 	{
 		hGroup.Delete(C4CFN_PXS);
 		return true;
@@ -341,7 +377,10 @@ bool C4PXSSystem::Save(C4Group &hGroup)
 #endif
 	if (!hTempFile.Write(&iNumFormat, sizeof (iNumFormat)))
 		return false;
-	if (!hTempFile.Write(PXS, Count * sizeof(C4PXS)))
+	std::vector<C4PXS> records(Mat.size());
+	for (size_t i = 0; i < Mat.size(); i++)
+		records[i] = Get(i);
+	if (!hTempFile.Write(&records[0], records.size() * sizeof(C4PXS)))
 		return false;
 
 	if (!hTempFile.Close())
@@ -374,23 +413,21 @@ bool C4PXSSystem::Load(C4Group &hGroup)
 	else if (iBinSize % sizeof(C4PXS) != 0) return false;
 	// calc chunk count
 	PXSNum = iBinSize / sizeof(C4PXS);
-	if (PXSNum > PXSMax) return false;
-	if (!hGroup.Read(PXS, iBinSize)) return false;
-	// count the PXS, Peter!
-	Count = PXSNum;
+	std::vector<C4PXS> records(PXSNum);
+	if (PXSNum && !hGroup.Read(&records[0], iBinSize)) return false;
 	// convert num format, if neccessary
-	for (size_t i = 0; i < Count; i++)
+	for (C4PXS &pxs : records)
 	{
-		C4PXS *pxp = &PXS[i];
-		if (pxp->Mat != MNone)
+		if (pxs.Mat != MNone)
 		{
 			// convert number format
 #ifdef C4REAL_USE_FIXNUM
-			if (iNumForm == 2) { FLOAT_TO_FIXED(&pxp->x); FLOAT_TO_FIXED(&pxp->y); FLOAT_TO_FIXED(&pxp->xdir); FLOAT_TO_FIXED(&pxp->ydir); }
+			if (iNumForm == 2) { FLOAT_TO_FIXED(&pxs.x); FLOAT_TO_FIXED(&pxs.y); FLOAT_TO_FIXED(&pxs.xdir); FLOAT_TO_FIXED(&pxs.ydir); }
 #else
-			if (iNumForm == 1) { FIXED_TO_FLOAT(&pxp->x); FIXED_TO_FLOAT(&pxp->y); FIXED_TO_FLOAT(&pxp->xdir); FIXED_TO_FLOAT(&pxp->ydir); }
+			if (iNumForm == 1) { FIXED_TO_FLOAT(&pxs.x); FIXED_TO_FLOAT(&pxs.y); FIXED_TO_FLOAT(&pxs.xdir); FIXED_TO_FLOAT(&pxs.ydir); }
 #endif
 		}
+		Add(pxs);
 	}
 	return true;
 }
@@ -398,23 +435,17 @@ bool C4PXSSystem::Load(C4Group &hGroup)
 int32_t C4PXSSystem::GetCount(int32_t mat) const
 {
 	// count PXS of given material
-	int32_t result = 0;
-	for (size_t i = 0; i < Count; i++)
-	{
-		if (PXS[i].Mat == mat) ++result;
-	}
-	return result;
+	return std::count(Mat.begin(), Mat.end(), mat);
 }
 
 int32_t C4PXSSystem::GetCount(int32_t mat, int32_t x, int32_t y, int32_t wdt, int32_t hgt) const
 {
 	// count PXS of given material in given area
 	int32_t result = 0;
-	for (size_t i = 0; i < Count; i++)
+	for (size_t i = 0; i < Mat.size(); i++)
 	{
-		const C4PXS *pxp = &PXS[i];
-		if (pxp->Mat == mat || mat == MNone)
-			if (Inside(pxp->x, x, x + wdt - 1) && Inside(pxp->y, y, y + hgt - 1))
+		if (Mat[i] == mat || mat == MNone)
+			if (Inside(X[i], x, x + wdt - 1) && Inside(Y[i], y, y + hgt - 1))
 				++result;
 	}
 	return result;
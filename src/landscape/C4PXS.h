@@ -22,6 +22,8 @@
 
 #include "landscape/C4Material.h"
 
+// A single PXS; only used as a temporary during execution and as the record
+// format of the PXS component in savegames
 class C4PXS
 {
 	friend class C4PXSSystem;
@@ -33,17 +35,16 @@ protected:
 	void Deactivate();
 };
 
-const size_t PXSMax = 10000;
-
 class C4PXSSystem
 {
 public:
 	C4PXSSystem();
 	~C4PXSSystem();
-public:
-	size_t Count;
 protected:
-	C4PXS PXS[PXSMax];
+	// PXS data, stored as one array per field so that passes over all PXS
+	// only touch the fields they need
+	std::vector<int32_t> Mat;
+	std::vector<C4Real> X, Y, XDir, YDir;
 public:
 	void Default();
 	void Clear();
@@ -53,11 +54,14 @@ public:
 	bool Create(int32_t mat, C4Real ix, C4Real iy, C4Real ixdir=Fix0, C4Real iydir=Fix0);
 	bool Load(C4Group &hGroup);
 	bool Save(C4Group &hGroup);
-	int32_t GetCount() const { return Count; } // count all PXS
+	int32_t GetCount() const { return Mat.size(); } // count all PXS
 	int32_t GetCount(int32_t mat) const; // count PXS of given material
 	int32_t GetCount(int32_t mat, int32_t x, int32_t y, int32_t wdt, int32_t hgt) const; // count PXS of given material in given area. mat==-1 for all materials.
 protected:
-	C4PXS *New();
+	C4PXS Get(size_t i) const;
+	void Set(size_t i, const C4PXS &pxs);
+	void Add(const C4PXS &pxs);
+	void Remove(size_t i);
 };
 
 extern C4PXSSystem PXS;
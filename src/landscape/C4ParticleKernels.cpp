@@ -0,0 +1,159 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2013-2016, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+#include "C4Include.h"
+#include "landscape/C4ParticleKernels.h"
+
+namespace C4ParticleKernels
+{
+
+void Age(const float *lifetime, const float *startingLifetime, float *age, float *relativeAge, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		age[i] = startingLifetime[i] - lifetime[i];
+		relativeAge[i] = (startingLifetime[i] != 0.f) ? (1.0f - (lifetime[i] / startingLifetime[i])) : 0.f;
+	}
+}
+
+void Fill(float *values, float value, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+		values[i] = value;
+}
+
+void Add(float *values, const float *summands, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+		values[i] += summands[i];
+}
+
+void Multiply(float *values, const float *factors, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+		values[i] *= factors[i];
+}
+
+void Subtract(float *values, float subtrahend, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+		values[i] -= subtrahend;
+}
+
+void Linear(const float *relativeAge, float startValue, float endValue, float *values, size_t count)
+{
+	const float range = endValue - startValue;
+	for (size_t i = 0; i < count; ++i)
+		values[i] = startValue + range * relativeAge[i];
+}
+
+void KeyFrames(const float *relativeAge, const float *keyFrames, size_t keyFrameCount, float fallbackValue, float *values, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		const float age = relativeAge[i];
+		float value = fallbackValue;
+		// the first key frame lies before any possible age, so the search always starts interpolating at frame >= 1
+		for (size_t frame = 1; frame < keyFrameCount; ++frame)
+		{
+			if (age > keyFrames[frame * 2]) continue;
+
+			const float x1 = keyFrames[(frame - 1) * 2];
+			const float x2 = keyFrames[frame * 2];
+			const float y1 = keyFrames[(frame - 1) * 2 + 1];
+			const float y2 = keyFrames[frame * 2 + 1];
+			value = (age - x1) / (x2 - x1) * (y2 - y1) + y1;
+			break;
+		}
+		values[i] = value;
+	}
+}
+
+void Step(const float *age, float stepValue, float baseValue, float delay, float maxValue, float *values, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		float value = baseValue + stepValue * age[i] / delay;
+		if (maxValue != 0.0f && value > maxValue) value = maxValue;
+		values[i] = value;
+	}
+}
+
+void Speed(const float *speedX, const float *speedY, float startValue, float speedFactor, float *values, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+		values[i] = startValue + speedFactor * sqrtf(speedX[i] * speedX[i] + speedY[i] * speedY[i]);
+}
+
+void Move(float *position, const float *speed, const uint8_t *blocked, float timeDelta, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+		position[i] += blocked[i] ? 0.f : timeDelta * speed[i];
+}
+
+void QuadPositions(const float *x, const float *y, const float *sizeX, const float *sizeY, const float *rotation, const float *offsetX, const float *offsetY, const uint8_t *update, C4ParticleVertex *vertices, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (update && !update[i]) continue;
+		C4ParticleVertex *quad = &vertices[i * VerticesPerParticle];
+		const float centerX = x[i] + offsetX[i];
+		const float centerY = y[i] + offsetY[i];
+
+		if (rotation[i] == 0.f)
+		{
+			quad[0].x = centerX - sizeX[i];
+			quad[0].y = centerY + sizeY[i];
+			quad[1].x = centerX - sizeX[i];
+			quad[1].y = centerY - sizeY[i];
+			quad[2].x = centerX + sizeX[i];
+			quad[2].y = centerY + sizeY[i];
+			quad[3].x = centerX + sizeX[i];
+			quad[3].y = centerY - sizeY[i];
+		}
+		else
+		{
+			const float sine = sinf(rotation[i]);
+			const float cosine = cosf(rotation[i]);
+			const float sx = sizeX[i], sy = sizeY[i];
+
+			quad[0].x = centerX + ((-sx) * cosine - (+sy) * sine);
+			quad[0].y = centerY + ((-sx) *   sine + (+sy) * cosine);
+			quad[1].x = centerX + ((-sx) * cosine - (-sy) * sine);
+			quad[1].y = centerY + ((-sx) *   sine + (-sy) * cosine);
+			quad[2].x = centerX + ((+sx) * cosine - (+sy) * sine);
+			quad[2].y = centerY + ((+sx) *   sine + (+sy) * cosine);
+			quad[3].x = centerX + ((+sx) * cosine - (-sy) * sine);
+			quad[3].y = centerY + ((+sx) *   sine + (-sy) * cosine);
+		}
+	}
+}
+
+void QuadColors(const float *r, const float *g, const float *b, const float *alpha, C4ParticleVertex *vertices, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		C4ParticleVertex *quad = &vertices[i * VerticesPerParticle];
+		for (size_t vertex = 0; vertex < VerticesPerParticle; ++vertex)
+		{
+			quad[vertex].r = r[i];
+			quad[vertex].g = g[i];
+			quad[vertex].b = b[i];
+			quad[vertex].alpha = alpha[i];
+		}
+	}
+}
+
+}
@@ -0,0 +1,68 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2013-2016, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+// Loops over spans of particle attributes stored as structure-of-arrays.
+// They don't depend on the rest of the engine so that they can be benchmarked on their own,
+// and are kept simple enough for the compiler to vectorize them.
+
+#ifndef INC_C4ParticleKernels
+#define INC_C4ParticleKernels
+
+#include <cstddef>
+#include <cstdint>
+
+// one corner of a particle quad as it is uploaded to the graphics card
+struct C4ParticleVertex
+{
+	float x;
+	float y;
+
+	float u;
+	float v;
+
+	float r;
+	float g;
+	float b;
+	float alpha;
+};
+
+namespace C4ParticleKernels
+{
+	const size_t VerticesPerParticle = 4;
+
+	// age and relative age (0..1) after the lifetime has been updated; particles without a starting lifetime never age relatively
+	void Age(const float *lifetime, const float *startingLifetime, float *age, float *relativeAge, size_t count);
+
+	void Fill(float *values, float value, size_t count);
+	void Add(float *values, const float *summands, size_t count);
+	void Multiply(float *values, const float *factors, size_t count);
+	void Subtract(float *values, float subtrahend, size_t count);
+
+	// value providers
+	void Linear(const float *relativeAge, float startValue, float endValue, float *values, size_t count);
+	// keyFrames holds keyFrameCount pairs of (relative age, value), framed by a pair before 0 and after 1
+	void KeyFrames(const float *relativeAge, const float *keyFrames, size_t keyFrameCount, float fallbackValue, float *values, size_t count);
+	void Step(const float *age, float stepValue, float baseValue, float delay, float maxValue, float *values, size_t count);
+	void Speed(const float *speedX, const float *speedY, float startValue, float speedFactor, float *values, size_t count);
+
+	// moves all particles that are not blocked by the given speed
+	void Move(float *position, const float *speed, const uint8_t *blocked, float timeDelta, size_t count);
+
+	// sets up the corners of the particle quads; particles with update[i] == 0 are skipped if update is given
+	void QuadPositions(const float *x, const float *y, const float *sizeX, const float *sizeY, const float *rotation, const float *offsetX, const float *offsetY, const uint8_t *update, C4ParticleVertex *vertices, size_t count);
+	void QuadColors(const float *r, const float *g, const float *b, const float *alpha, C4ParticleVertex *vertices, size_t count);
+}
+
+#endif
@@ -33,6 +33,7 @@
 #include "script/C4Value.h"
 #include "script/C4ValueArray.h"
 #include <random>
+#include <thread>
 #endif
 
 
@@ -147,68 +148,9 @@ bool C4ParticleDef::Reload()
 }
 
 #ifndef USE_CONSOLE
-const int C4Particle::DrawingData::vertexCountPerParticle(4);
-
-void C4Particle::DrawingData::SetPosition(float x, float y, float size, float rotation, float stretch)
-{
-	if (size != originalSize || stretch != currentStretch)
-	{
-		currentStretch = stretch;
-		originalSize = std::max(size, 0.0001f); // a size of zero results in undefined behavior
-		sizeX = originalSize / aspect;
-		sizeY = originalSize * currentStretch;
-	}
-
-	if (rotation == 0.f)
-	{
-		vertices[0].x = x - sizeX + offsetX;
-		vertices[0].y = y + sizeY + offsetY;
-		vertices[1].x = x - sizeX + offsetX;
-		vertices[1].y = y - sizeY + offsetY;
-		vertices[2].x = x + sizeX + offsetX;
-		vertices[2].y = y + sizeY + offsetY;
-		vertices[3].x = x + sizeX + offsetX;
-		vertices[3].y = y - sizeY + offsetY;
-	}
-	else
-	{
-		float sine = sinf(rotation);
-		float cosine = cosf(rotation);
-
-		vertices[0].x = x + ((-sizeX) * cosine - (+sizeY) * sine) + offsetX;
-		vertices[0].y = y + ((-sizeX) *   sine + (+sizeY) * cosine) + offsetY;
-		vertices[1].x = x + ((-sizeX) * cosine - (-sizeY) * sine) + offsetX;
-		vertices[1].y = y + ((-sizeX) *   sine + (-sizeY) * cosine) + offsetY;
-		vertices[2].x = x + ((+sizeX) * cosine - (+sizeY) * sine) + offsetX;
-		vertices[2].y = y + ((+sizeX) *   sine + (+sizeY) * cosine) + offsetY;
-		vertices[3].x = x + ((+sizeX) * cosine - (-sizeY) * sine) + offsetX;
-		vertices[3].y = y + ((+sizeX) *   sine + (-sizeY) * cosine) + offsetY;
-	}
-}
-
-void C4Particle::DrawingData::SetPhase(int phase, C4ParticleDef *sourceDef)
-{
-	this->phase = phase;
-	phase = phase % sourceDef->Length;
-	int offsetY = phase / sourceDef->PhasesX;
-	int offsetX = phase % sourceDef->PhasesX;
-	float wdt = 1.0f / (float)sourceDef->PhasesX;
-	int numOfLines = sourceDef->Length / sourceDef->PhasesX;
-	float hgt = 1.0f / (float)numOfLines;
-
-	float x = wdt * (float)offsetX;
-	float y = hgt * (float)offsetY;
-	float xr = x + wdt;
-	float yr = y + hgt;
-
-	vertices[0].u = x; vertices[0].v = yr;
-	vertices[1].u = x; vertices[1].v = y;
-	vertices[2].u = xr; vertices[2].v = yr;
-	vertices[3].u = xr; vertices[3].v = y;
-}
-
 C4ParticleValueProvider & C4ParticleValueProvider::operator= (const C4ParticleValueProvider &other)
 {
+	if (this == &other) return *this;
 	startValue = other.startValue;
 	endValue = other.endValue;
 	currentValue = other.currentValue;
@@ -218,12 +160,9 @@ C4ParticleValueProvider & C4ParticleValueProvider::operator= (const C4ParticleVa
 	isConstant = other.isConstant;
 	keyFrameCount = other.keyFrameCount;
 	rng = other.rng;
+	randomSlot = other.randomSlot;
 
-	if (keyFrameCount > 0)
-	{
-		keyFrames.reserve(2 * keyFrameCount);
-		keyFrames.assign(other.keyFrames.begin(), other.keyFrames.end());
-	}
+	keyFrames.assign(other.keyFrames.begin(), other.keyFrames.end());
 
 	typeOfValueToChange = other.typeOfValueToChange;
 	switch (typeOfValueToChange)
@@ -243,6 +182,9 @@ C4ParticleValueProvider & C4ParticleValueProvider::operator= (const C4ParticleVa
 	}
 	
 	// copy the other's children, too
+	for (auto &child : childrenValueProviders)
+		delete child;
+	childrenValueProviders.clear();
 	for (std::vector<C4ParticleValueProvider*>::const_iterator iter = other.childrenValueProviders.begin(); iter != other.childrenValueProviders.end(); ++iter)
 	{
 		childrenValueProviders.push_back(new C4ParticleValueProvider(**iter)); // custom copy constructor usage
@@ -250,6 +192,40 @@ C4ParticleValueProvider & C4ParticleValueProvider::operator= (const C4ParticleVa
 	return (*this);
 }
 
+bool C4ParticleValueProvider::operator== (const C4ParticleValueProvider &other) const
+{
+	if (valueFunction != other.valueFunction || isConstant != other.isConstant) return false;
+	if (startValue != other.startValue || endValue != other.endValue || currentValue != other.currentValue) return false;
+	// compare the unions by their integer members so that all bits are taken into account
+	if (rerollInterval != other.rerollInterval || alreadyRolled != other.alreadyRolled) return false;
+	if (keyFrameCount != other.keyFrameCount || keyFrames != other.keyFrames) return false;
+	if (typeOfValueToChange != other.typeOfValueToChange) return false;
+	switch (typeOfValueToChange)
+	{
+	case VAL_TYPE_FLOAT:
+		if (floatValueToChange != other.floatValueToChange) return false;
+		break;
+	case VAL_TYPE_INT:
+		if (intValueToChange != other.intValueToChange) return false;
+		break;
+	case VAL_TYPE_KEYFRAMES:
+		if (keyFrameIndex != other.keyFrameIndex) return false;
+		break;
+	}
+	if (childrenValueProviders.size() != other.childrenValueProviders.size()) return false;
+	for (size_t i = 0; i < childrenValueProviders.size(); ++i)
+		if (*childrenValueProviders[i] != *other.childrenValueProviders[i]) return false;
+	return true;
+}
+
+void C4ParticleValueProvider::AssignRandomSlots(size_t &slotCount)
+{
+	if (IsRandom())
+		randomSlot = slotCount++;
+	for (auto &child : childrenValueProviders)
+		child->AssignRandomSlots(slotCount);
+}
+
 void C4ParticleValueProvider::SetParameterValue(int type, const C4Value &value, float C4ParticleValueProvider::*floatVal, int C4ParticleValueProvider::*intVal, size_t keyFrameIndex)
 {
 	// just an atomic data type
@@ -296,29 +272,29 @@ void C4ParticleValueProvider::SetParameterValue(int type, const C4Value &value,
 	}
 }
 
-void C4ParticleValueProvider::UpdatePointerValue(C4Particle *particle, C4ParticleValueProvider *parent)
+void C4ParticleValueProvider::UpdatePointerValue(C4ParticleBlock &block, size_t index, C4ParticleValueProvider *parent)
 {
 	switch (typeOfValueToChange)
 	{
 	case VAL_TYPE_FLOAT:
-		parent->*floatValueToChange = GetValue(particle);
+		parent->*floatValueToChange = GetValue(block, index);
 		break;
 	case VAL_TYPE_INT:
-		parent->*intValueToChange = (int) GetValue(particle);
+		parent->*intValueToChange = (int) GetValue(block, index);
 		break;
 	case VAL_TYPE_KEYFRAMES:
-		parent->keyFrames[keyFrameIndex] = GetValue(particle);
+		parent->keyFrames[keyFrameIndex] = GetValue(block, index);
 		break;
 	default:
 		assert (false);
 	}
 }
 
-void C4ParticleValueProvider::UpdateChildren(C4Particle *particle)
+void C4ParticleValueProvider::UpdateChildren(C4ParticleBlock &block, size_t index)
 {
 	for (std::vector<C4ParticleValueProvider*>::iterator iter = childrenValueProviders.begin(); iter != childrenValueProviders.end(); ++iter)
 	{
-		(*iter)->UpdatePointerValue(particle, this);
+		(*iter)->UpdatePointerValue(block, index, this);
 	}
 }
 
@@ -384,53 +360,83 @@ void C4ParticleValueProvider::Floatify(float denominator)
 	}
 }
 
-float C4ParticleValueProvider::GetValue(C4Particle *forParticle)
+float C4ParticleValueProvider::GetValue(C4ParticleBlock &block, size_t index)
 {
-	UpdateChildren(forParticle);
-	return (this->*valueFunction)(forParticle);
+	UpdateChildren(block, index);
+	return (this->*valueFunction)(block, index);
+}
+
+void C4ParticleValueProvider::GetValues(C4ParticleBlock &block, float *values)
+{
+	if (!block.count) return;
+
+	// children change the parameters for every single particle, so there is nothing to share
+	if (!childrenValueProviders.empty())
+	{
+		for (size_t i = 0; i < block.count; ++i)
+			values[i] = GetValue(block, i);
+		return;
+	}
+
+	if (valueFunction == &C4ParticleValueProvider::Const)
+		C4ParticleKernels::Fill(values, startValue, block.count);
+	else if (valueFunction == &C4ParticleValueProvider::Linear)
+		C4ParticleKernels::Linear(block.relativeAge, startValue, endValue, values, block.count);
+	else if (valueFunction == &C4ParticleValueProvider::KeyFrames)
+		C4ParticleKernels::KeyFrames(block.relativeAge, &keyFrames[0], keyFrameCount, startValue, values, block.count);
+	else if (valueFunction == &C4ParticleValueProvider::Step)
+		C4ParticleKernels::Step(block.age, startValue, currentValue, delay, maxValue, values, block.count);
+	else if (valueFunction == &C4ParticleValueProvider::Speed)
+		C4ParticleKernels::Speed(block.speedX, block.speedY, startValue, speedFactor, values, block.count);
+	else if (valueFunction == &C4ParticleValueProvider::Sin || valueFunction == &C4ParticleValueProvider::Cos || valueFunction == &C4ParticleValueProvider::Gravity)
+		// the same for all particles
+		C4ParticleKernels::Fill(values, (this->*valueFunction)(block, 0), block.count);
+	else
+	{
+		for (size_t i = 0; i < block.count; ++i)
+			values[i] = (this->*valueFunction)(block, i);
+	}
 }
 
-float C4ParticleValueProvider::Linear(C4Particle *forParticle)
+float C4ParticleValueProvider::Linear(C4ParticleBlock &block, size_t index)
 {
-	return startValue + (endValue - startValue) * forParticle->GetRelativeAge();
+	return startValue + (endValue - startValue) * block.relativeAge[index];
 }
 
-float C4ParticleValueProvider::Const(C4Particle *forParticle)
+float C4ParticleValueProvider::Const(C4ParticleBlock &block, size_t index)
 {
 	return startValue;
 }
 
-float C4ParticleValueProvider::Random(C4Particle *forParticle)
+float C4ParticleValueProvider::Random(C4ParticleBlock &block, size_t index)
 {
+	float &value = (*block.randomValues)[randomSlot][block.randomOffset + index];
 	// We need to roll again if..
 	const bool needToReevaluate =
-		// .. we haven't rolled yet
-		alreadyRolled == 0
-		// .. we are still in the intialization stage (and thus, this value provider could be an intialization term for multiple particles)
-		|| (forParticle->lifetime == forParticle->startingLifetime)
+		// .. we are still in the intialization stage (all random values are rolled when a particle is created)
+		(block.lifetime[index] == block.startingLifetime[index])
 		// .. or the reroll interval is set and expired.
-		|| (rerollInterval != 0 && ((int)forParticle->GetAge() % rerollInterval == 0));
+		|| (rerollInterval != 0 && ((int)block.age[index] % rerollInterval == 0));
 
 	if (needToReevaluate)
 	{
-		alreadyRolled = 1;
 		// Even for seeded PV_Random, each particle should behave differently.  Thus, we use a different
-		// stream for each one.  Since this is by no means synchronisation relevant and since the
-		// particles lie on the heap we just use the address here.
-		const std::uintptr_t ourAddress = reinterpret_cast<std::uintptr_t>(forParticle);
+		// stream for each one.  Since this is by no means synchronisation relevant, we just use the address
+		// of the particle's value here.
+		const std::uintptr_t ourAddress = reinterpret_cast<std::uintptr_t>(&value);
 		rng.set_stream(ourAddress);
 		// We need to advance the RNG a bit to make streams with the same seed diverge.
 		rng.advance(5);
 		std::uniform_real_distribution<float> distribution(std::min(startValue, endValue), std::max(startValue, endValue));
-		currentValue = distribution(rng);
+		value = distribution(rng);
 	}
-	return currentValue;
+	return value;
 }
 
-float C4ParticleValueProvider::Direction(C4Particle *forParticle)
+float C4ParticleValueProvider::Direction(C4ParticleBlock &block, size_t index)
 {
-	float distX = forParticle->currentSpeedX;
-	float distY = forParticle->currentSpeedY;
+	float distX = block.speedX[index];
+	float distY = block.speedY[index];
 
 	if (distX == 0.f) return distY > 0.f ? M_PI : 0.f;
 	if (distY == 0.f) return distX < 0.f ? 3.0f * M_PI_2 : M_PI_2;
@@ -438,64 +444,46 @@ float C4ParticleValueProvider::Direction(C4Particle *forParticle)
 	return startValue * (atan2(distY, distX) + (float)M_PI_2);
 }
 
-float C4ParticleValueProvider::Step(C4Particle *forParticle)
+float C4ParticleValueProvider::Step(C4ParticleBlock &block, size_t index)
 {
-	float value = currentValue + startValue * forParticle->GetAge() / delay;
+	float value = currentValue + startValue * block.age[index] / delay;
 	if (maxValue != 0.0f && value > maxValue) value = maxValue;
 	return value;
 }
 
-float C4ParticleValueProvider::KeyFrames(C4Particle *forParticle)
+float C4ParticleValueProvider::KeyFrames(C4ParticleBlock &block, size_t index)
 {
-	float age = forParticle->GetRelativeAge();
+	float value;
 	// todo, implement smoothing
-	//if (smoothing == 0) // linear
-	{
-		for (size_t i = 0; i < keyFrameCount; ++i)
-		{
-			if (age > keyFrames[i * 2]) continue;
-			assert(i >= 1);
-
-			float x1 = keyFrames[(i - 1) * 2];
-			float x2 = keyFrames[i * 2];
-			float y1 = keyFrames[(i - 1) * 2 + 1];
-			float y2 = keyFrames[i * 2 + 1];
-			float position = (age - x1) / (x2 - x1);
-			float totalRange = (y2 - y1);
-
-			float value = position * totalRange + y1;
-			return value;
-		}
-	}
-
-	return startValue;
+	C4ParticleKernels::KeyFrames(&block.relativeAge[index], &keyFrames[0], keyFrameCount, startValue, &value, 1);
+	return value;
 }
 
-float C4ParticleValueProvider::Sin(C4Particle *forParticle)
+float C4ParticleValueProvider::Sin(C4ParticleBlock &block, size_t index)
 {
 	return sin(parameterValue * M_PI / 180.0f) * maxValue + startValue;
 }
 
-float C4ParticleValueProvider::Cos(C4Particle *forParticle)
+float C4ParticleValueProvider::Cos(C4ParticleBlock &block, size_t index)
 {
 	return cos(parameterValue * M_PI / 180.0f) * maxValue + startValue;
 }
 
-float C4ParticleValueProvider::Speed(C4Particle *forParticle)
+float C4ParticleValueProvider::Speed(C4ParticleBlock &block, size_t index)
 {
-	float distX = forParticle->currentSpeedX;
-	float distY = forParticle->currentSpeedY;
+	float distX = block.speedX[index];
+	float distY = block.speedY[index];
 	float speed = sqrtf((distX * distX) + (distY * distY));
 
 	return startValue + speedFactor * speed;
 }
 
-float C4ParticleValueProvider::Wind(C4Particle *forParticle)
+float C4ParticleValueProvider::Wind(C4ParticleBlock &block, size_t index)
 {
-	return startValue + (0.01f * speedFactor * ::Weather.GetWind((int)forParticle->positionX, (int)forParticle->positionY));
+	return startValue + (0.01f * speedFactor * ::Weather.GetWind((int)block.positionX[index], (int)block.positionY[index]));
 }
 
-float C4ParticleValueProvider::Gravity(C4Particle *forParticle)
+float C4ParticleValueProvider::Gravity(C4ParticleBlock &block, size_t index)
 {
 	return startValue + (speedFactor * fixtof(::Landscape.GetGravity()));
 }
@@ -706,6 +694,7 @@ C4ParticleProperties::C4ParticleProperties()
 	hasCollisionVertex = false;
 	collisionCallback = 0;
 	bouncyness = 0.f;
+	randomSlotCount = 0;
 
 	// all values in pre-floatified range (f.e. 0..255 instead of 0..1)
 	collisionDensity.Set(static_cast<float>(C4M_Solid));
@@ -744,6 +733,23 @@ void C4ParticleProperties::Floatify()
 	phase.Floatify(1.f);
 
 	hasConstantColor = colorR.IsConstant() && colorG.IsConstant() && colorB.IsConstant() && colorAlpha.IsConstant();
+
+	randomSlotCount = 0;
+	for (C4ParticleValueProvider *provider : { &size, &stretch, &forceX, &forceY, &speedDampingX, &speedDampingY, &colorR, &colorG, &colorB, &colorAlpha, &rotation, &phase, &collisionVertex, &collisionDensity })
+		provider->AssignRandomSlots(randomSlotCount);
+}
+
+bool C4ParticleProperties::operator== (const C4ParticleProperties &other) const
+{
+	return hasConstantColor == other.hasConstantColor && hasCollisionVertex == other.hasCollisionVertex
+		&& bouncyness == other.bouncyness && collisionCallback == other.collisionCallback
+		&& blitMode == other.blitMode && attachment == other.attachment
+		&& size == other.size && stretch == other.stretch
+		&& forceX == other.forceX && forceY == other.forceY
+		&& speedDampingX == other.speedDampingX && speedDampingY == other.speedDampingY
+		&& colorR == other.colorR && colorG == other.colorG && colorB == other.colorB && colorAlpha == other.colorAlpha
+		&& rotation == other.rotation && phase == other.phase
+		&& collisionVertex == other.collisionVertex && collisionDensity == other.collisionDensity;
 }
 
 void C4ParticleProperties::Set(C4PropList *dataSource)
@@ -865,143 +871,362 @@ void C4ParticleProperties::SetCollisionFunc(const C4Value &source)
 	}
 }
 
-bool C4ParticleProperties::CollisionBounce(C4Particle *forParticle)
+bool C4ParticleProperties::CollisionBounce(float &speedX, float &speedY)
 {
-	forParticle->currentSpeedX = -forParticle->currentSpeedX * bouncyness;
-	forParticle->currentSpeedY = -forParticle->currentSpeedY * bouncyness;
+	speedX = -speedX * bouncyness;
+	speedY = -speedY * bouncyness;
 	return true;
 }
 
-bool C4ParticleProperties::CollisionStop(C4Particle *forParticle)
+bool C4ParticleProperties::CollisionStop(float &speedX, float &speedY)
 {
-	forParticle->currentSpeedX = 0.f;
-	forParticle->currentSpeedY = 0.f;
+	speedX = 0.f;
+	speedY = 0.f;
 	return true;
 }
 
-void C4Particle::Init()
+C4ParticleBatch::C4ParticleBatch(const C4ParticleProperties &properties) : properties(properties), particleCount(0)
 {
-	currentSpeedX = currentSpeedY = 0.f;
-	positionX = positionY = 0.f;
-	lifetime = startingLifetime = 5.f * 38.f;
+	randomValues.resize(properties.randomSlotCount);
 }
 
-bool C4Particle::Exec(C4Object *obj, float timeDelta, C4ParticleDef *sourceDef)
+void C4ParticleBatch::Resize(size_t count)
 {
+	particleCount = count;
+	for (std::vector<float> *values : { &positionX, &positionY, &speedX, &speedY, &lifetime, &startingLifetime, &offsetX, &offsetY, &sizeX, &sizeY })
+		values->resize(count, 0.f);
+	originalSize.resize(count, 0.0001f);
+	currentStretch.resize(count, 1.f);
+	phase.resize(count, -1);
+	for (std::vector<float> &values : randomValues)
+		values.resize(count, 0.f);
+	vertices.resize(count * C4ParticleKernels::VerticesPerParticle);
+}
+
+size_t C4ParticleBatch::AddParticles(size_t amount)
+{
+	const size_t first = particleCount;
+	Resize(particleCount + amount);
+	return first;
+}
+
+void C4ParticleBatch::MoveParticle(size_t indexFrom, size_t indexTo)
+{
+	for (std::vector<float> *values : { &positionX, &positionY, &speedX, &speedY, &lifetime, &startingLifetime, &offsetX, &offsetY, &originalSize, &currentStretch, &sizeX, &sizeY })
+		(*values)[indexTo] = (*values)[indexFrom];
+	phase[indexTo] = phase[indexFrom];
+	for (std::vector<float> &values : randomValues)
+		values[indexTo] = values[indexFrom];
+	std::copy(&vertices[indexFrom * C4ParticleKernels::VerticesPerParticle], &vertices[indexFrom * C4ParticleKernels::VerticesPerParticle] + C4ParticleKernels::VerticesPerParticle, &vertices[indexTo * C4ParticleKernels::VerticesPerParticle]);
+}
+
+void C4ParticleBatch::SetupBlock(C4ParticleBlock &block, size_t first, size_t count)
+{
+	assert(count > 0 && count <= C4ParticleBlock::MaxSize && first + count <= particleCount);
+	block.count = count;
+	block.lifetime = &lifetime[first];
+	block.startingLifetime = &startingLifetime[first];
+	block.speedX = &speedX[first];
+	block.speedY = &speedY[first];
+	block.positionX = &positionX[first];
+	block.positionY = &positionY[first];
+	block.randomValues = &randomValues;
+	block.randomOffset = first;
+	C4ParticleKernels::Age(block.lifetime, block.startingLifetime, block.age, block.relativeAge, count);
+}
+
+void C4ParticleBatch::UpdateSizes(size_t first, size_t count, const float *size, const float *stretch, const uint8_t *update, float aspect)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (update && !update[i]) continue;
+		const size_t index = first + i;
+		if (size[i] != originalSize[index] || stretch[i] != currentStretch[index])
+		{
+			currentStretch[index] = stretch[i];
+			originalSize[index] = std::max(size[i], 0.0001f); // a size of zero results in undefined behavior
+			sizeX[index] = originalSize[index] / aspect;
+			sizeY[index] = originalSize[index] * currentStretch[index];
+		}
+	}
+}
+
+void C4ParticleBatch::SetPhase(size_t index, int phase, C4ParticleDef *sourceDef)
+{
+	this->phase[index] = phase;
+	phase = phase % sourceDef->Length;
+	int offsetY = phase / sourceDef->PhasesX;
+	int offsetX = phase % sourceDef->PhasesX;
+	float wdt = 1.0f / (float)sourceDef->PhasesX;
+	int numOfLines = sourceDef->Length / sourceDef->PhasesX;
+	float hgt = 1.0f / (float)numOfLines;
+
+	float x = wdt * (float)offsetX;
+	float y = hgt * (float)offsetY;
+	float xr = x + wdt;
+	float yr = y + hgt;
+
+	C4ParticleVertex *quad = &vertices[index * C4ParticleKernels::VerticesPerParticle];
+	quad[0].u = x; quad[0].v = yr;
+	quad[1].u = x; quad[1].v = y;
+	quad[2].u = xr; quad[2].v = yr;
+	quad[3].u = xr; quad[3].v = y;
+}
+
+void C4ParticleBatch::InitParticles(size_t first, size_t count, C4ParticleDef *sourceDef)
+{
+	const size_t MaxSize = C4ParticleBlock::MaxSize;
+	float size[MaxSize], rotation[MaxSize], stretch[MaxSize];
+	float r[MaxSize], g[MaxSize], b[MaxSize], alpha[MaxSize];
+	float values[MaxSize];
+
+	for (size_t blockStart = first; blockStart < first + count; blockStart += MaxSize)
+	{
+		C4ParticleBlock block;
+		const size_t blockCount = std::min(MaxSize, first + count - blockStart);
+		SetupBlock(block, blockStart, blockCount);
+
+		// this rolls the random values of all properties, also of those that are only needed later on
+		for (C4ParticleValueProvider *provider : { &properties.forceX, &properties.forceY, &properties.speedDampingX, &properties.speedDampingY, &properties.collisionVertex, &properties.collisionDensity, &properties.stretch })
+			provider->GetValues(block, values);
+
+		// the particles start out unstretched
+		properties.size.GetValues(block, size);
+		properties.rotation.GetValues(block, rotation);
+		C4ParticleKernels::Fill(stretch, 1.f, blockCount);
+		UpdateSizes(blockStart, blockCount, size, stretch, nullptr, sourceDef->Aspect);
+		C4ParticleVertex *quads = &vertices[blockStart * C4ParticleKernels::VerticesPerParticle];
+		C4ParticleKernels::QuadPositions(block.positionX, block.positionY, &sizeX[blockStart], &sizeY[blockStart], rotation, &offsetX[blockStart], &offsetY[blockStart], nullptr, quads, blockCount);
+
+		properties.colorR.GetValues(block, r);
+		properties.colorG.GetValues(block, g);
+		properties.colorB.GetValues(block, b);
+		properties.colorAlpha.GetValues(block, alpha);
+		C4ParticleKernels::QuadColors(r, g, b, alpha, quads, blockCount);
+
+		properties.phase.GetValues(block, values);
+		for (size_t i = 0; i < blockCount; ++i)
+			SetPhase(blockStart + i, (int)(values[i] + 0.5f), sourceDef);
+	}
+}
+
+void C4ParticleBatch::ExecBlock(size_t first, size_t count, C4ParticleDef *sourceDef, float timeDelta)
+{
+	const size_t MaxSize = C4ParticleBlock::MaxSize;
+	float valuesX[MaxSize], valuesY[MaxSize], size[MaxSize];
+	uint8_t moving[MaxSize], collided[MaxSize];
+	uint8_t *dead = &deathMarks[first];
+
 	// die of old age? :<
-	lifetime -= timeDelta;
-	// check only if we had a maximum lifetime to begin with (for permanent particles)
-	if (startingLifetime > 0.f)
+	C4ParticleKernels::Subtract(&lifetime[first], timeDelta, count);
+	for (size_t i = 0; i < count; ++i)
 	{
-		if (lifetime <= 0.f) return false;
+		// check only if we had a maximum lifetime to begin with (for permanent particles)
+		dead[i] = startingLifetime[first + i] > 0.f && lifetime[first + i] <= 0.f;
 	}
 
+	C4ParticleBlock block;
+	SetupBlock(block, first, count);
+
 	// movement
-	float currentForceX = properties.forceX.GetValue(this);
-	float currentForceY = properties.forceY.GetValue(this);
+	float *currentSpeedX = &speedX[first];
+	float *currentSpeedY = &speedY[first];
+	properties.forceX.GetValues(block, valuesX);
+	properties.forceY.GetValues(block, valuesY);
+	C4ParticleKernels::Add(currentSpeedX, valuesX, count);
+	C4ParticleKernels::Add(currentSpeedY, valuesY, count);
+
+	bool anyMoving = false;
+	for (size_t i = 0; i < count; ++i)
+	{
+		moving[i] = currentSpeedX[i] != 0.f || currentSpeedY[i] != 0.f;
+		anyMoving |= moving[i] != 0;
+	}
 
-	currentSpeedX += currentForceX;
-	currentSpeedY += currentForceY;
+	const bool animatedSize = !properties.size.IsConstant() || !properties.rotation.IsConstant() || !properties.stretch.IsConstant();
+	if (anyMoving || animatedSize)
+		properties.size.GetValues(block, size);
 
-	if (currentSpeedX != 0.f || currentSpeedY != 0.f)
+	std::fill(collided, collided + count, 0);
+	if (anyMoving)
 	{
-		float currentDampingX = properties.speedDampingX.GetValue(this);
-		float currentDampingY = properties.speedDampingY.GetValue(this);
-		float size = properties.size.GetValue(this);
-
-		currentSpeedX *= currentDampingX;
-		currentSpeedY *= currentDampingY;
+		properties.speedDampingX.GetValues(block, valuesX);
+		properties.speedDampingY.GetValues(block, valuesY);
+		for (size_t i = 0; i < count; ++i)
+		{
+			currentSpeedX[i] *= moving[i] ? valuesX[i] : 1.f;
+			currentSpeedY[i] *= moving[i] ? valuesY[i] : 1.f;
+		}
 
-		// move & collision check
+		// collision check
 		// note: accessing Landscape.GetDensity here is not protected by locks
 		// it is assumed that the particle system is cleaned up before, f.e., the landscape memory is freed
-		bool collided = false;
 		if (properties.hasCollisionVertex)
 		{
-			float collisionPoint = properties.collisionVertex.GetValue(this);
-			float size_x = (currentSpeedX > 0.f ? size : -size) * 0.5f * collisionPoint;
-			float size_y = (currentSpeedY > 0.f ? size : -size) * 0.5f * collisionPoint;
-			float density = static_cast<float>(GBackDensity(positionX + size_x + timeDelta * currentSpeedX, positionY + size_y + timeDelta * currentSpeedY));
-			
-			if (density + 0.5f >= properties.collisionDensity.GetValue(this)) // Small offset against floating point insanities.
+			properties.collisionVertex.GetValues(block, valuesX);
+			properties.collisionDensity.GetValues(block, valuesY);
+			for (size_t i = 0; i < count; ++i)
 			{
-				// exec collision func
-				if (properties.collisionCallback != 0 && !(properties.*properties.collisionCallback)(this)) return false;
-				collided = true;
+				if (!moving[i] || dead[i]) continue;
+				const size_t index = first + i;
+				float size_x = (currentSpeedX[i] > 0.f ? size[i] : -size[i]) * 0.5f * valuesX[i];
+				float size_y = (currentSpeedY[i] > 0.f ? size[i] : -size[i]) * 0.5f * valuesX[i];
+				float density = static_cast<float>(GBackDensity(positionX[index] + size_x + timeDelta * currentSpeedX[i], positionY[index] + size_y + timeDelta * currentSpeedY[i]));
+
+				if (density + 0.5f >= valuesY[i]) // Small offset against floating point insanities.
+				{
+					// exec collision func
+					if (properties.collisionCallback != 0 && !(properties.*properties.collisionCallback)(currentSpeedX[i], currentSpeedY[i]))
+						dead[i] = 1;
+					collided[i] = 1;
+				}
 			}
 		}
 
-		if (!collided)
-		{
-			positionX += timeDelta * currentSpeedX;
-			positionY += timeDelta * currentSpeedY;
-		}
-		drawingData.SetPosition(positionX, positionY, size, properties.rotation.GetValue(this), properties.stretch.GetValue(this));
-
+		C4ParticleKernels::Move(&positionX[first], currentSpeedX, collided, timeDelta, count);
+		C4ParticleKernels::Move(&positionY[first], currentSpeedY, collided, timeDelta, count);
 	}
-	else if(!properties.size.IsConstant() || !properties.rotation.IsConstant() || !properties.stretch.IsConstant())
+
+	C4ParticleVertex *quads = &vertices[first * C4ParticleKernels::VerticesPerParticle];
+	if (anyMoving || animatedSize)
 	{
-		drawingData.SetPosition(positionX, positionY, properties.size.GetValue(this), properties.rotation.GetValue(this), properties.stretch.GetValue(this));
+		// resting particles keep their quads unless their size changes over time
+		const uint8_t *update = animatedSize ? nullptr : moving;
+		properties.rotation.GetValues(block, valuesX);
+		properties.stretch.GetValues(block, valuesY);
+		UpdateSizes(first, count, size, valuesY, update, sourceDef->Aspect);
+		C4ParticleKernels::QuadPositions(block.positionX, block.positionY, &sizeX[first], &sizeY[first], valuesX, &offsetX[first], &offsetY[first], update, quads, count);
 	}
 
 	// adjust color
 	if (!properties.hasConstantColor)
 	{
-		drawingData.SetColor(properties.colorR.GetValue(this), properties.colorG.GetValue(this), properties.colorB.GetValue(this), properties.colorAlpha.GetValue(this));
+		float r[MaxSize], g[MaxSize], b[MaxSize], alpha[MaxSize];
+		properties.colorR.GetValues(block, r);
+		properties.colorG.GetValues(block, g);
+		properties.colorB.GetValues(block, b);
+		properties.colorAlpha.GetValues(block, alpha);
+		C4ParticleKernels::QuadColors(r, g, b, alpha, quads, count);
 	}
 
-	int currentPhase = (int)(properties.phase.GetValue(this) + 0.5f);
-	if (currentPhase != drawingData.phase)
-		drawingData.SetPhase(currentPhase, sourceDef);
-
-	return true;
+	properties.phase.GetValues(block, valuesX);
+	for (size_t i = 0; i < count; ++i)
+	{
+		int currentPhase = (int)(valuesX[i] + 0.5f);
+		if (currentPhase != phase[first + i])
+			SetPhase(first + i, currentPhase, sourceDef);
+	}
 }
 
-void C4ParticleChunk::Clear()
+bool C4ParticleBatch::Exec(C4ParticleDef *sourceDef, float timeDelta)
 {
-	for (size_t i = 0; i < particleCount; ++i)
+	deathMarks.assign(particleCount, 0);
+	for (size_t first = 0; first < particleCount; first += C4ParticleBlock::MaxSize)
+		ExecBlock(first, std::min(C4ParticleBlock::MaxSize, particleCount - first), sourceDef, timeDelta);
+
+	// remove the dead particles; the gaps are filled from the back to keep the arrays tightly packed
+	size_t remaining = particleCount;
+	for (size_t i = 0; i < remaining; )
 	{
-		delete particles[i];
+		if (!deathMarks[i])
+		{
+			++i;
+			continue;
+		}
+		--remaining;
+		if (i != remaining)
+		{
+			MoveParticle(remaining, i);
+			deathMarks[i] = deathMarks[remaining];
+		}
 	}
+	if (remaining != particleCount)
+		Resize(remaining);
+	return particleCount > 0;
+}
+
+void C4ParticleChunk::Clear()
+{
+	batches.clear();
+	lastAccessedBatch = nullptr;
 	particleCount = 0;
-	particles.clear();
-	vertexCoordinates.clear();
+
+	pendingVertices.clear();
+	readyVertices.clear();
+	drawnVertices.clear();
+	hasReadyVertices = verticesChanged = false;
 
 	ClearBufferObjects();
 }
 
-void C4ParticleChunk::DeleteAndReplaceParticle(size_t indexToReplace, size_t indexFrom)
+void C4ParticleChunk::PublishVertices()
 {
-	C4Particle *oldParticle = particles[indexToReplace];
-
-	// try to replace the soon-to-be empty slot in the array
-	if (indexFrom != indexToReplace) // false when "replacing" the last one
-	{
-		std::copy(&vertexCoordinates[indexFrom * C4Particle::DrawingData::vertexCountPerParticle], &vertexCoordinates[indexFrom * C4Particle::DrawingData::vertexCountPerParticle] + C4Particle::DrawingData::vertexCountPerParticle, &vertexCoordinates[indexToReplace * C4Particle::DrawingData::vertexCountPerParticle]);
-		particles[indexToReplace] = particles[indexFrom];
-		particles[indexToReplace]->drawingData.SetPointer(&vertexCoordinates[indexToReplace * C4Particle::DrawingData::vertexCountPerParticle]);
-	}
+	pendingVertices.clear();
+	for (auto &batch : batches)
+		pendingVertices.insert(pendingVertices.end(), batch->GetVertices().begin(), batch->GetVertices().end());
+	verticesChanged = false;
 
-	delete oldParticle;
+	CStdLock swapLock(&vertexSwapMutex);
+	std::swap(pendingVertices, readyVertices);
+	hasReadyVertices = true;
 }
 
-bool C4ParticleChunk::Exec(C4Object *obj, float timeDelta)
+bool C4ParticleChunk::Exec(float timeDelta)
 {
-	for (size_t i = 0; i < particleCount; ++i)
+	for (auto iter = batches.begin(); iter != batches.end(); )
 	{
-		if (!particles[i]->Exec(obj, timeDelta, sourceDefinition))
+		if ((*iter)->Exec(sourceDefinition, timeDelta))
 		{
-			DeleteAndReplaceParticle(i, particleCount - 1);
-			--particleCount;
+			++iter;
+			continue;
 		}
+		if (iter->get() == lastAccessedBatch)
+			lastAccessedBatch = nullptr;
+		iter = batches.erase(iter);
 	}
+	UpdateParticleCount();
 	return particleCount > 0;
 }
 
+C4ParticleBatch *C4ParticleChunk::GetFittingBatch(const C4ParticleProperties &properties)
+{
+	if (lastAccessedBatch && lastAccessedBatch->HasProperties(properties))
+		return lastAccessedBatch;
+
+	for (auto &batch : batches)
+	{
+		if (!batch->HasProperties(properties)) continue;
+		lastAccessedBatch = batch.get();
+		return lastAccessedBatch;
+	}
+
+	batches.emplace_back(new C4ParticleBatch(properties));
+	lastAccessedBatch = batches.back().get();
+	return lastAccessedBatch;
+}
+
+void C4ParticleChunk::UpdateParticleCount()
+{
+	particleCount = 0;
+	for (auto &batch : batches)
+		particleCount += batch->GetParticleCount();
+}
+
 void C4ParticleChunk::Draw(C4TargetFacet cgo, C4Object *obj, C4ShaderCall& call, int texUnit, const StdProjectionMatrix& modelview)
 {
-	if (particleCount == 0) return;
-	const int stride = sizeof(C4Particle::DrawingData::Vertex);
+	// fetch the latest finished vertex data
+	{
+		CStdLock swapLock(&vertexSwapMutex);
+		if (hasReadyVertices)
+		{
+			std::swap(readyVertices, drawnVertices);
+			hasReadyVertices = false;
+		}
+	}
+
+	const size_t drawnParticleCount = drawnVertices.size() / C4ParticleKernels::VerticesPerParticle;
+	if (drawnParticleCount == 0) return;
+	const int stride = sizeof(C4ParticleVertex);
 	assert(sourceDefinition && "No source definition assigned to particle chunk.");
 	C4TexRef *textureRef = sourceDefinition->Gfx.GetFace().texture.get();
 	assert(textureRef != 0 && "Particle definition had no texture assigned.");
@@ -1047,7 +1272,7 @@ void C4ParticleChunk::Draw(C4TargetFacet cgo, C4Object *obj, C4ShaderCall& call,
 
 	// Push the new vertex data
 	glBindBuffer(GL_ARRAY_BUFFER, drawingDataVertexBufferObject);
-	glBufferData(GL_ARRAY_BUFFER, 4 * sizeof(C4Particle::DrawingData::Vertex) * particleCount, &vertexCoordinates[0], GL_DYNAMIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(C4ParticleVertex) * drawnVertices.size(), &drawnVertices[0], GL_DYNAMIC_DRAW);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 
 	// set up the vertex array structure
@@ -1066,15 +1291,15 @@ void C4ParticleChunk::Draw(C4TargetFacet cgo, C4Object *obj, C4ShaderCall& call,
 		glEnableVertexAttribArray(call.GetAttribute(C4SSA_Position));
 		glEnableVertexAttribArray(call.GetAttribute(C4SSA_Color));
 		glEnableVertexAttribArray(call.GetAttribute(C4SSA_TexCoord));
-		glVertexAttribPointer(call.GetAttribute(C4SSA_Position), 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<GLvoid*>(offsetof(C4Particle::DrawingData::Vertex, x)));
-		glVertexAttribPointer(call.GetAttribute(C4SSA_TexCoord), 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<GLvoid*>(offsetof(C4Particle::DrawingData::Vertex, u)));
-		glVertexAttribPointer(call.GetAttribute(C4SSA_Color), 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<GLvoid*>(offsetof(C4Particle::DrawingData::Vertex, r)));
+		glVertexAttribPointer(call.GetAttribute(C4SSA_Position), 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<GLvoid*>(offsetof(C4ParticleVertex, x)));
+		glVertexAttribPointer(call.GetAttribute(C4SSA_TexCoord), 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<GLvoid*>(offsetof(C4ParticleVertex, u)));
+		glVertexAttribPointer(call.GetAttribute(C4SSA_Color), 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<GLvoid*>(offsetof(C4ParticleVertex, r)));
 	}
 
 	// We need to always bind the ibo, because it might change its size.
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ::Particles.GetIBO(particleCount));
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ::Particles.GetIBO(drawnParticleCount));
 
-	glDrawElements(GL_TRIANGLE_STRIP, static_cast<GLsizei> (5 * particleCount), GL_UNSIGNED_INT, 0);
+	glDrawElements(GL_TRIANGLE_STRIP, static_cast<GLsizei> (5 * drawnParticleCount), GL_UNSIGNED_INT, 0);
 
 	// reset buffer data
 	glBindVertexArray(0);
@@ -1096,44 +1321,7 @@ void C4ParticleChunk::ClearBufferObjects()
 	drawingDataVertexBufferObject = 0;
 }
 
-void C4ParticleChunk::ReserveSpace(uint32_t forAmount)
-{
-	uint32_t newSize = static_cast<uint32_t>(particleCount) + forAmount + 1;
-	
-	if (particles.capacity() < newSize)
-		particles.reserve(std::max<uint32_t>(newSize, particles.capacity() * 2));
-
-	// resizing the points vector is relatively costly, hopefully we only do it rarely
-	while (vertexCoordinates.capacity() <= newSize * C4Particle::DrawingData::vertexCountPerParticle)
-	{
-		vertexCoordinates.reserve(std::max<uint32_t>(C4Particle::DrawingData::vertexCountPerParticle * newSize, vertexCoordinates.capacity() * 2));
-
-		// update all existing particles' pointers..
-		for (size_t i = 0; i < particleCount; ++i)
-			particles[i]->drawingData.SetPointer(&vertexCoordinates[i * C4Particle::DrawingData::vertexCountPerParticle]);
-	}
-}
-
-C4Particle *C4ParticleChunk::AddNewParticle()
-{
-	size_t currentIndex = particleCount++;
-
-	if (currentIndex < particles.size())
-	{
-		particles[currentIndex] = new C4Particle();
-	}
-	else
-	{
-		particles.push_back(new C4Particle());
-		vertexCoordinates.resize(vertexCoordinates.size() + C4Particle::DrawingData::vertexCountPerParticle);
-	}
-
-	C4Particle *newParticle = particles[currentIndex];
-	newParticle->drawingData.SetPointer(&vertexCoordinates[currentIndex * C4Particle::DrawingData::vertexCountPerParticle], true);
-	return newParticle;
-}
-
-void C4ParticleList::Exec(float timeDelta)
+void C4ParticleList::CollectCalculationTasks(std::vector<C4ParticleCalculationTask> &tasks)
 {
 	if (particleChunks.empty()) return;
 
@@ -1142,7 +1330,9 @@ void C4ParticleList::Exec(float timeDelta)
 	for (std::list<C4ParticleChunk*>::iterator iter = particleChunks.begin(); iter != particleChunks.end();++iter)
 	{
 		C4ParticleChunk *chunk = *iter;
-		chunk->Exec(targetObject, timeDelta);
+		if (chunk->IsEmpty()) continue;
+		chunk->calculationScheduled = true;
+		tasks.push_back({chunk});
 	}
 
 	accessMutex.Leave();
@@ -1175,17 +1365,23 @@ void C4ParticleList::Draw(C4TargetFacet cgo, C4Object *obj)
 
 	for (std::list<C4ParticleChunk*>::iterator iter = particleChunks.begin(); iter != particleChunks.end(); )
 	{
-		if ((*iter)->IsEmpty())
-		{
-			delete *iter;
-			iter = particleChunks.erase(iter);
-			lastAccessedChunk = 0;
-		}
-		else
+		C4ParticleChunk *chunk = *iter;
+		// chunks that are currently calculated are left alone; the calculation publishes their vertices itself
+		if (!chunk->calculationScheduled)
 		{
-			(*iter)->Draw(cgo, obj, call, texUnit, modelview);
-			++iter;
+			if (chunk->IsEmpty())
+			{
+				delete chunk;
+				iter = particleChunks.erase(iter);
+				lastAccessedChunk = 0;
+				continue;
+			}
+			// particles that were created while no calculation ran (f.e. while the game is paused)
+			if (chunk->verticesChanged)
+				chunk->PublishVertices();
 		}
+		chunk->Draw(cgo, obj, call, texUnit, modelview);
+		++iter;
 	}
 
 	accessMutex.Leave();
@@ -1195,6 +1391,8 @@ void C4ParticleList::Draw(C4TargetFacet cgo, C4Object *obj)
 
 void C4ParticleList::Clear()
 {
+	// wait for a running calculation, which might still be working on the chunks
+	::Particles.particleListAccessMutex.Enter();
 	accessMutex.Enter();
 
 	for (std::list<C4ParticleChunk*>::iterator iter = particleChunks.begin(); iter != particleChunks.end(); ++iter)
@@ -1210,6 +1408,7 @@ void C4ParticleList::Clear()
 		if(this == ::Particles.globalParticles) ::Particles.globalParticles = nullptr;
 
 	accessMutex.Leave();
+	::Particles.particleListAccessMutex.Leave();
 }
 
 C4ParticleChunk *C4ParticleList::GetFittingParticleChunk(C4ParticleDef *def, uint32_t blitMode, uint32_t attachment, bool alreadyLocked)
@@ -1256,18 +1455,42 @@ void C4ParticleSystem::CalculationThread::Execute()
 	Particles.ExecuteCalculation();
 }
 
-C4ParticleSystem::C4ParticleSystem() : frameCounterAdvancedEvent(false)
+void C4ParticleSystem::CalculationWorker::Execute()
+{
+	workAvailableEvent.WaitFor(INFINITE);
+	if (IsStopSignaled()) return;
+	Particles.RunCalculationTasks(queueIndex);
+}
+
+C4ParticleSystem::C4ParticleSystem() : frameCounterAdvancedEvent(false), pendingCalculationTasks(0), calculationFinishedEvent(true)
 {
 	currentSimulationTime = 0;
+	calculationTimeDelta = 1.f;
 	globalParticles = 0;
 	ibo = 0;
 	ibo_size = 0;
+
+	// the calculation thread works on the first queue itself, so additional workers only pay off on multi-core machines
+	const size_t workerCount = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+	calculationQueues.emplace_back(new CalculationQueue());
+	for (size_t i = 1; i <= workerCount; ++i)
+	{
+		calculationQueues.emplace_back(new CalculationQueue());
+		calculationWorkers.emplace_back(new CalculationWorker(i));
+	}
 }
 
 C4ParticleSystem::~C4ParticleSystem()
 {
 	Clear();
 
+	for (auto &worker : calculationWorkers)
+	{
+		worker->SignalStop();
+		worker->workAvailableEvent.Set();
+		worker->Stop();
+	}
+
 	calculationThread.SignalStop();
 	CalculateNextStep();
 }
@@ -1287,14 +1510,90 @@ void C4ParticleSystem::ExecuteCalculation()
 
 		particleListAccessMutex.Enter();
 
+		calculationTasks.clear();
 		for (std::list<C4ParticleList>::iterator iter = particleLists.begin(); iter != particleLists.end(); ++iter)
 		{
-			iter->Exec(timeDelta);
+			iter->CollectCalculationTasks(calculationTasks);
+		}
+		calculationTimeDelta = timeDelta;
+
+		if (calculationWorkers.empty() || calculationTasks.size() < 2)
+		{
+			for (const C4ParticleCalculationTask &task : calculationTasks)
+				ExecuteCalculationTask(task);
+		}
+		else
+		{
+			// deal the chunks out round-robin, the work-stealing evens out the differences in chunk size
+			calculationFinishedEvent.Reset();
+			pendingCalculationTasks = calculationTasks.size();
+			for (size_t queueIndex = 0; queueIndex < calculationQueues.size(); ++queueIndex)
+			{
+				CalculationQueue &queue = *calculationQueues[queueIndex];
+				CStdLock queueLock(&queue.mutex);
+				for (size_t i = queueIndex; i < calculationTasks.size(); i += calculationQueues.size())
+					queue.tasks.push_back(calculationTasks[i]);
+			}
+			for (auto &worker : calculationWorkers)
+				worker->workAvailableEvent.Set();
+
+			RunCalculationTasks(0);
+			calculationFinishedEvent.WaitFor(INFINITE);
 		}
 
 		particleListAccessMutex.Leave();
 	}
 }
+
+void C4ParticleSystem::RunCalculationTasks(size_t queueIndex)
+{
+	C4ParticleCalculationTask task;
+	while (PopCalculationTask(queueIndex, task))
+	{
+		ExecuteCalculationTask(task);
+		if (--pendingCalculationTasks == 0)
+			calculationFinishedEvent.Set();
+	}
+}
+
+bool C4ParticleSystem::PopCalculationTask(size_t queueIndex, C4ParticleCalculationTask &task)
+{
+	// own work is taken from the back..
+	{
+		CalculationQueue &queue = *calculationQueues[queueIndex];
+		CStdLock queueLock(&queue.mutex);
+		if (!queue.tasks.empty())
+		{
+			task = queue.tasks.back();
+			queue.tasks.pop_back();
+			return true;
+		}
+	}
+	// ..while other threads' work is stolen from the front
+	for (size_t i = 1; i < calculationQueues.size(); ++i)
+	{
+		CalculationQueue &queue = *calculationQueues[(queueIndex + i) % calculationQueues.size()];
+		CStdLock queueLock(&queue.mutex);
+		if (!queue.tasks.empty())
+		{
+			task = queue.tasks.front();
+			queue.tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+void C4ParticleSystem::ExecuteCalculationTask(const C4ParticleCalculationTask &task)
+{
+	C4ParticleChunk *chunk = task.chunk;
+	chunk->Lock();
+	chunk->Exec(calculationTimeDelta);
+	chunk->PublishVertices();
+	chunk->Unlock();
+	// the chunk may be deleted by the drawing code from here on
+	chunk->calculationScheduled = false;
+}
 #endif
 
 C4ParticleList *C4ParticleSystem::GetNewParticleList(C4Object *forObject)
@@ -1338,15 +1637,16 @@ void C4ParticleSystem::ReleaseParticleList(C4ParticleList *first, C4ParticleList
 #ifndef USE_CONSOLE
 void C4ParticleSystem::Create(C4ParticleDef *of_def, C4ParticleValueProvider &x, C4ParticleValueProvider &y, C4ParticleValueProvider &speedX, C4ParticleValueProvider &speedY, C4ParticleValueProvider &lifetime, C4PropList *properties, int amount, C4Object *object)
 {
-	// todo: check amount etc
+	if (amount < 1) return;
 
 	C4ParticleList * pxList(0);
 
 
 	// initialize the particle properties
-	// this is done here, because it would also be the right place to implement caching
+	// they are shared by all particles in a batch, so that equal properties of later calls are stored only once
 	C4ParticleProperties particleProperties;
 	particleProperties.Set(properties);
+	particleProperties.Floatify();
 
 	speedX.Floatify(10.f);
 	speedY.Floatify(10.f);
@@ -1397,42 +1697,57 @@ void C4ParticleSystem::Create(C4ParticleDef *of_def, C4ParticleValueProvider &x,
 	// It is necessary to lock the particle list, because we will have it create a particle first that we are going to modify.
 	// Inbetween creation of the particle and modification, the particle list's calculations should not be executed
 	// (this could f.e. lead to the particle being removed before it was fully instantiated).
+	// The chunk is locked as well, because it might currently be calculated by one of the workers.
 	pxList->Lock();
 
 	// retrieve the fitting chunk for the particle (note that we tell the particle list, we already locked it)
 	C4ParticleChunk *chunk = pxList->GetFittingParticleChunk(of_def, particleProperties.blitMode, particleProperties.attachment, true);
+	chunk->Lock();
+	chunk->verticesChanged = true;
 	
-	// set up chunk to be able to contain enough particles
-	chunk->ReserveSpace(static_cast<uint32_t>(amount));
-
-	while (amount--)
-	{	
-		// create a particle in the fitting chunk (note that we tell the particle list, we already locked it)
-		C4Particle *particle = chunk->AddNewParticle();
-
-		// initialize some more properties
-		particle->properties = particleProperties;
-		// this will adjust the initial values of the (possibly cached) particle properties
-		particle->properties.Floatify();
-
-		// setup some more non-property attributes of the particle
-		// The particle having lifetime == startingLifetime will force all random values to alway-reevaluate.
-		// Thus we need to guarantee that even before setting the lifetime (to allow a PV_Random for the lifetime).
-		particle->lifetime = particle->startingLifetime = 0.0f;
-		const float lifetime_value = lifetime.GetValue(particle);
-		// Negative values are not allowed (would crash later); using a value of 0 is most likely visible to the scripter.
-		if (lifetime_value >= 0.0f)
-			particle->lifetime = particle->startingLifetime = lifetime_value;
-
-		particle->currentSpeedX = speedX.GetValue(particle);
-		particle->currentSpeedY = speedY.GetValue(particle);
-		particle->drawingData.aspect = of_def->Aspect;
-		particle->drawingData.SetOffset(drawingOffsetX, drawingOffsetY);
-		particle->SetPosition(x.GetValue(particle) + xoff, y.GetValue(particle) + yoff);
-		particle->drawingData.SetColor(particle->properties.colorR.GetValue(particle), particle->properties.colorG.GetValue(particle), particle->properties.colorB.GetValue(particle), particle->properties.colorAlpha.GetValue(particle));
-		particle->drawingData.SetPhase((int)(particle->properties.phase.GetValue(particle) + 0.5f), of_def);
+	C4ParticleBatch *batch = chunk->GetFittingBatch(particleProperties);
+	const size_t firstParticle = batch->AddParticles(static_cast<size_t>(amount));
+
+	// the creation values might be random as well and need their own per-particle storage
+	size_t creationRandomSlotCount = 0;
+	for (C4ParticleValueProvider *provider : { &x, &y, &speedX, &speedY, &lifetime })
+		provider->AssignRandomSlots(creationRandomSlotCount);
+	std::vector<std::vector<float>> creationRandomValues(creationRandomSlotCount, std::vector<float>(C4ParticleBlock::MaxSize));
+
+	float values[C4ParticleBlock::MaxSize];
+	for (size_t first = firstParticle; first < batch->particleCount; first += C4ParticleBlock::MaxSize)
+	{
+		C4ParticleBlock block;
+		const size_t count = std::min(C4ParticleBlock::MaxSize, batch->particleCount - first);
+		batch->SetupBlock(block, first, count);
+		block.randomValues = &creationRandomValues;
+		block.randomOffset = 0;
+
+		// The particles having lifetime == startingLifetime will force all random values to alway-reevaluate.
+		// New particles start with a lifetime of 0 to guarantee that even before setting the lifetime (to allow a PV_Random for the lifetime).
+		lifetime.GetValues(block, values);
+		for (size_t i = 0; i < count; ++i)
+		{
+			// Negative values are not allowed (would crash later); using a value of 0 is most likely visible to the scripter.
+			batch->lifetime[first + i] = batch->startingLifetime[first + i] = std::max(values[i], 0.0f);
+		}
+
+		speedX.GetValues(block, &batch->speedX[first]);
+		speedY.GetValues(block, &batch->speedY[first]);
+		x.GetValues(block, values);
+		for (size_t i = 0; i < count; ++i)
+			batch->positionX[first + i] = values[i] + xoff;
+		y.GetValues(block, values);
+		for (size_t i = 0; i < count; ++i)
+			batch->positionY[first + i] = values[i] + yoff;
+		C4ParticleKernels::Fill(&batch->offsetX[first], drawingOffsetX, count);
+		C4ParticleKernels::Fill(&batch->offsetY[first], drawingOffsetY, count);
 	}
 
+	batch->InitParticles(firstParticle, static_cast<size_t>(amount), of_def);
+	chunk->UpdateParticleCount();
+
+	chunk->Unlock();
 	pxList->Unlock();
 }
 
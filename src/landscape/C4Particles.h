@@ -16,12 +16,15 @@
 #include "C4ForbidLibraryCompilation.h"
 #include "graphics/C4FacetEx.h"
 #include "lib/C4Random.h"
+#include "landscape/C4ParticleKernels.h"
 
 #include "platform/StdScheduler.h"
 
 #include <pcg/pcg_random.hpp>
 #ifndef USE_CONSOLE
 #include <GL/glew.h>
+#include <atomic>
+#include <deque>
 #endif
 #include "graphics/C4Shader.h"
 
@@ -62,7 +65,7 @@ class C4ParticleDefCore;
 class C4ParticleDef;
 class C4ParticleList;
 class C4ParticleChunk;
-class C4Particle;
+class C4ParticleBatch;
 class C4ParticleProperties;
 class C4ParticleValueProvider;
 
@@ -101,17 +104,37 @@ public:
 	bool Reload();              // reload particle from stored position
 };
 
-typedef float (C4ParticleValueProvider::*C4ParticleValueProviderFunction) (C4Particle*);
-typedef bool (C4ParticleProperties::*C4ParticleCollisionCallback) (C4Particle*);
+struct C4ParticleBlock;
+
+typedef float (C4ParticleValueProvider::*C4ParticleValueProviderFunction) (C4ParticleBlock &block, size_t index);
+typedef bool (C4ParticleProperties::*C4ParticleCollisionCallback) (float &speedX, float &speedY);
 
 #ifndef USE_CONSOLE
+// a span of particles of one batch whose values are evaluated together
+struct C4ParticleBlock
+{
+	static const size_t MaxSize = 64;
+
+	size_t count;
+
+	const float *lifetime, *startingLifetime;
+	const float *speedX, *speedY;
+	const float *positionX, *positionY;
+	float age[MaxSize];
+	float relativeAge[MaxSize];
+
+	// per-particle values of the PV_Random providers: one array per random slot, the block starts at randomOffset
+	std::vector<std::vector<float>> *randomValues;
+	size_t randomOffset;
+};
+
 // the value providers are used to change the attributes of a particle over the lifetime
 class C4ParticleValueProvider
 {
 private:
 	float startValue, endValue;
 
-	// used by Random
+	// used by Step
 	float currentValue;
 
 	union
@@ -130,6 +153,7 @@ private:
 	};
 
 	pcg32 rng; // for Random
+	size_t randomSlot; // for Random, index of the per-particle values in the block
 
 	size_t keyFrameCount;
 	std::vector<float> keyFrames;
@@ -157,7 +181,7 @@ public:
 	bool IsConstant() const { return isConstant; }
 	bool IsRandom() const { return valueFunction == &C4ParticleValueProvider::Random; }
 	C4ParticleValueProvider() :
-		startValue(0.f), endValue(0.f), currentValue(0.f), rerollInterval(0), smoothing(0), keyFrameCount(0), valueFunction(nullptr), isConstant(true), floatValueToChange(nullptr), typeOfValueToChange(VAL_TYPE_FLOAT)
+		startValue(0.f), endValue(0.f), currentValue(0.f), rerollInterval(0), smoothing(0), randomSlot(0), keyFrameCount(0), valueFunction(nullptr), isConstant(true), floatValueToChange(nullptr), typeOfValueToChange(VAL_TYPE_FLOAT)
 	{ }
 	~C4ParticleValueProvider()
 	{
@@ -166,6 +190,9 @@ public:
 	}
 	C4ParticleValueProvider(const C4ParticleValueProvider &other) { *this = other; }
 	C4ParticleValueProvider & operator= (const C4ParticleValueProvider &other);
+	// compares the parameters, but not the state of the random number generator
+	bool operator== (const C4ParticleValueProvider &other) const;
+	bool operator!= (const C4ParticleValueProvider &other) const { return !(*this == other); }
 
 	// divides by denominator
 	void Floatify(float denominator);
@@ -173,29 +200,34 @@ public:
 	void Set(const C4Value &value);
 	void Set(const C4ValueArray &fromArray);
 	void Set(float to); // constant
-	float GetValue(C4Particle *forParticle);
+	// numbers the random providers of the tree, each of which needs one per-particle array in the block
+	void AssignRandomSlots(size_t &slotCount);
+
+	float GetValue(C4ParticleBlock &block, size_t index);
+	// evaluates the provider for all particles of the block at once
+	void GetValues(C4ParticleBlock &block, float *values);
 
 private:
-	void UpdatePointerValue(C4Particle *particle, C4ParticleValueProvider *parent);
-	void UpdateChildren(C4Particle *particle);
+	void UpdatePointerValue(C4ParticleBlock &block, size_t index, C4ParticleValueProvider *parent);
+	void UpdateChildren(C4ParticleBlock &block, size_t index);
 	void FloatifyParameterValue(float C4ParticleValueProvider::*value, float denominator, size_t keyFrameIndex = 0);
 	void SetParameterValue(int type, const C4Value &value, float C4ParticleValueProvider::*floatVal, int C4ParticleValueProvider::*intVal = nullptr, size_t keyFrameIndex = 0);
 
 	void SetType(C4ParticleValueProviderID what = C4PV_Const);
-	float Linear(C4Particle *forParticle);
-	float Const(C4Particle *forParticle);
-	float Random(C4Particle *forParticle);
-	float KeyFrames(C4Particle *forParticle);
-	float Sin(C4Particle *forParticle);
-	float Cos(C4Particle *forParticle);
-	float Direction(C4Particle *forParticle);
-	float Step(C4Particle *forParticle);
-	float Speed(C4Particle *forParticle);
-	float Wind(C4Particle *forParticle);
-	float Gravity(C4Particle *forParticle);
+	float Linear(C4ParticleBlock &block, size_t index);
+	float Const(C4ParticleBlock &block, size_t index);
+	float Random(C4ParticleBlock &block, size_t index);
+	float KeyFrames(C4ParticleBlock &block, size_t index);
+	float Sin(C4ParticleBlock &block, size_t index);
+	float Cos(C4ParticleBlock &block, size_t index);
+	float Direction(C4ParticleBlock &block, size_t index);
+	float Step(C4ParticleBlock &block, size_t index);
+	float Speed(C4ParticleBlock &block, size_t index);
+	float Wind(C4ParticleBlock &block, size_t index);
+	float Gravity(C4ParticleBlock &block, size_t index);
 };
 
-// the properties are part of every particle and contain certain changeable attributes
+// the properties are shared by all particles of a batch and contain certain changeable attributes
 class C4ParticleProperties
 {
 public:
@@ -218,6 +250,9 @@ public:
 
 	uint32_t attachment;
 
+	// number of PV_Random providers in all of the properties
+	size_t randomSlotCount;
+
 	C4ParticleProperties();
 
 	
@@ -225,114 +260,65 @@ public:
 	// divides ints in certain properties by 1000f and in the color properties by 255f
 	void Floatify();
 
-	
-	bool CollisionDie(C4Particle *forParticle) { return false; }
-	bool CollisionBounce(C4Particle *forParticle);
-	bool CollisionStop(C4Particle *forParticle);
+	bool operator== (const C4ParticleProperties &other) const;
+
+	bool CollisionDie(float &speedX, float &speedY) { return false; }
+	bool CollisionBounce(float &speedX, float &speedY);
+	bool CollisionStop(float &speedX, float &speedY);
 };
 
-// one single particle
-class C4Particle
+// All particles that were created with equal properties.
+// They are stored as structure-of-arrays, so that the calculation can run over blocks of particles
+// and only touches the attributes it actually needs.
+class C4ParticleBatch
 {
-public:
-
-	struct DrawingData
-	{
-		static const int vertexCountPerParticle;
-
-		struct Vertex
-		{
-			float x;
-			float y;
-
-			float u;
-			float v;
-			
-			float r;
-			float g;
-			float b;
-			float alpha;
-		};
-		Vertex *vertices;
-		
-		int phase;
-
-		float currentStretch;
-		float originalSize;
-		float sizeX, sizeY;
-		float aspect;
-
-		float offsetX, offsetY;
-
-		void SetOffset(float x, float y)
-		{
-			offsetX = x;
-			offsetY = y;
-		}
-
-		void SetPointer(Vertex *startingVertex, bool initial = false)
-		{
-			vertices = startingVertex;
-
-			if (initial)
-			{
-				vertices[0].u = 0.f; vertices[0].v = 1.f;
-				vertices[1].u = 0.f; vertices[1].v = 0.f;
-				vertices[2].u = 1.f; vertices[2].v = 1.f;
-				vertices[3].u = 1.f; vertices[3].v = 0.f;
-
-				SetColor(1.f, 1.f, 1.f, 1.f);
-
-				phase = -1;
-			}
-		}
-
-		void SetColor(float r, float g, float b, float a = 1.0f)
-		{
-			for (int vertex = 0; vertex < 4; ++vertex)
-			{
-				vertices[vertex].r = r;
-				vertices[vertex].g = g;
-				vertices[vertex].b = b;
-				vertices[vertex].alpha = a;
-			}
-		}
-
-		void SetPosition(float x, float y, float size, float rotation = 0.f, float stretch = 1.f);
-		void SetPhase(int phase, C4ParticleDef *sourceDef);
-
-		DrawingData() : currentStretch(1.f), originalSize(0.0001f), aspect(1.f), offsetX(0.f), offsetY(0.f)
-		{
-		}
-
-	} drawingData;
-protected:
-	float currentSpeedX, currentSpeedY;
-	float positionX, positionY;
-	float lifetime, startingLifetime;
-
+private:
 	C4ParticleProperties properties;
+	size_t particleCount;
 
-public:
-	float GetAge() const { return startingLifetime - lifetime; }
-	float GetLifetime() const { return lifetime; }
-	float GetRelativeAge() const { return (startingLifetime != 0.f) ? (1.0f - (lifetime / startingLifetime)) : 0.f; }
+	// simulation state
+	std::vector<float> positionX, positionY;
+	std::vector<float> speedX, speedY;
+	std::vector<float> lifetime, startingLifetime;
+
+	// drawing state
+	std::vector<float> offsetX, offsetY;
+	std::vector<float> originalSize, currentStretch;
+	std::vector<float> sizeX, sizeY;
+	std::vector<int> phase;
+	std::vector<C4ParticleVertex> vertices;
+
+	// the current values of the PV_Random providers in the properties, one array per random slot
+	std::vector<std::vector<float>> randomValues;
+
+	// set for particles that died during the last calculation
+	std::vector<uint8_t> deathMarks;
+
+	void Resize(size_t count);
+	void SetupBlock(C4ParticleBlock &block, size_t first, size_t count);
+	// recalculates the quad size of the particles for which update is set (all if update is null)
+	void UpdateSizes(size_t first, size_t count, const float *size, const float *stretch, const uint8_t *update, float aspect);
+	void SetPhase(size_t index, int phase, C4ParticleDef *sourceDef);
+	void ExecBlock(size_t first, size_t count, C4ParticleDef *sourceDef, float timeDelta);
+	// moves the particle at indexFrom into the slot of indexTo, which is lost
+	void MoveParticle(size_t indexFrom, size_t indexTo);
 
-	void Init();
-	C4Particle() { Init(); }
+public:
+	C4ParticleBatch(const C4ParticleProperties &properties);
+	C4ParticleBatch(const C4ParticleBatch&) = delete;
+	C4ParticleBatch& operator=(const C4ParticleBatch&) = delete;
 
-	void SetPosition(float x, float y)
-	{
-		positionX = x;
-		positionY = y;
-		drawingData.SetPosition(positionX, positionY, properties.size.GetValue(this),  properties.rotation.GetValue(this));
-	}
+	bool HasProperties(const C4ParticleProperties &other) const { return properties == other; }
+	size_t GetParticleCount() const { return particleCount; }
+	const std::vector<C4ParticleVertex> &GetVertices() const { return vertices; }
 
-	bool Exec(C4Object *obj, float timeDelta, C4ParticleDef *sourceDef);
+	// appends amount uninitialized particles and returns the index of the first one
+	size_t AddParticles(size_t amount);
+	// evaluates the properties for particles that were just created and sets up their drawing state
+	void InitParticles(size_t first, size_t count, C4ParticleDef *sourceDef);
+	// returns whether there are particles left
+	bool Exec(C4ParticleDef *sourceDef, float timeDelta);
 
-	friend class C4ParticleProperties;
-	friend class C4ParticleValueProvider;
-	friend class C4ParticleChunk;
 	friend class C4ParticleSystem;
 };
 
@@ -347,20 +333,32 @@ private:
 	// whether the particles are translated according to the object's position
 	uint32_t attachment;
 
-	std::vector<C4Particle*> particles;
-	std::vector<C4Particle::DrawingData::Vertex> vertexCoordinates;
+	std::vector<std::unique_ptr<C4ParticleBatch>> batches;
+	C4ParticleBatch *lastAccessedBatch;
 	size_t particleCount;
 
+	// held while the particles of this chunk are calculated or created
+	CStdCSec accessMutex;
+	// whether the chunk has been handed to the calculation workers and is not finished yet
+	std::atomic<bool> calculationScheduled;
+
+	// The vertex data is handed from the calculation to the drawing via three buffers:
+	// the calculation fills pendingVertices and swaps it with readyVertices, the drawing swaps readyVertices with drawnVertices.
+	// Only the swaps need to be locked, so drawing never waits for a running calculation.
+	std::vector<C4ParticleVertex> pendingVertices, readyVertices, drawnVertices;
+	CStdCSec vertexSwapMutex;
+	bool hasReadyVertices;
+	// set when particles were created after the last PublishVertices
+	bool verticesChanged;
+	void PublishVertices();
+
 	// OpenGL optimizations
 	GLuint drawingDataVertexBufferObject;
 	unsigned int drawingDataVertexArraysObject;
 	void ClearBufferObjects();
 
-	// delete the particle at indexTo. If possible, replace it with the particle at indexFrom to keep the particles tighly packed
-	void DeleteAndReplaceParticle(size_t indexToReplace, size_t indexFrom);
-
 public:
-	C4ParticleChunk() : sourceDefinition(nullptr), blitMode(0), attachment(C4ATTACH_None), particleCount(0), drawingDataVertexBufferObject(0), drawingDataVertexArraysObject(0)
+	C4ParticleChunk() : sourceDefinition(nullptr), blitMode(0), attachment(C4ATTACH_None), lastAccessedBatch(nullptr), particleCount(0), calculationScheduled(false), hasReadyVertices(false), verticesChanged(false), drawingDataVertexBufferObject(0), drawingDataVertexArraysObject(0)
 	{
 
 	}
@@ -373,17 +371,27 @@ public:
 	}
 	// removes all particles
 	void Clear();
-	bool Exec(C4Object *obj, float timeDelta);
+	bool Exec(float timeDelta);
 	void Draw(C4TargetFacet cgo, C4Object *obj, C4ShaderCall& call, int texUnit, const StdProjectionMatrix& modelview);
 	bool IsOfType(C4ParticleDef *def, uint32_t _blitMode, uint32_t attachment) const;
 	bool IsEmpty() const { return !particleCount; }
 
-	// before adding a particle, you should ReserveSpace for it
-	C4Particle *AddNewParticle();
-	// sets up internal data structures to be large enough for the passed amount of ADDITIONAL particles
-	void ReserveSpace(uint32_t forAmount);
+	void Lock() { accessMutex.Enter(); }
+	void Unlock() { accessMutex.Leave(); }
+
+	// returns the batch for particles with these properties, creating a new one if there is none yet
+	C4ParticleBatch *GetFittingBatch(const C4ParticleProperties &properties);
+	// to be called after particles were added to one of the batches
+	void UpdateParticleCount();
 
 	friend class C4ParticleList;
+	friend class C4ParticleSystem;
+};
+
+// one chunk that is to be calculated by the particle system's workers
+struct C4ParticleCalculationTask
+{
+	C4ParticleChunk *chunk;
 };
 
 // this class must not be copied, because deleting the contained CStdCSec twice would be fatal
@@ -398,7 +406,8 @@ private:
 	// caching..
 	C4ParticleChunk *lastAccessedChunk;
 
-	// for making sure that the list is not drawn and calculated at the same time
+	// for making sure that the chunk list is not changed while it is drawn or while the calculation collects its chunks
+	// (the chunks themselves are locked separately during calculation)
 	CStdCSec accessMutex;
 
 public:
@@ -419,10 +428,10 @@ public:
 	// deletes all the particles
 	void Clear();
 
-	void Exec(float timeDelta = 1.f);
+	// marks all chunks as scheduled and appends them to the calculation tasks
+	void CollectCalculationTasks(std::vector<C4ParticleCalculationTask> &tasks);
 	void Draw(C4TargetFacet cgo, C4Object *obj);
 	C4ParticleChunk *GetFittingParticleChunk(C4ParticleDef *def, uint32_t blitMode, uint32_t attachment, bool alreadyLocked);
-	C4Particle *AddNewParticle(C4ParticleDef *def, uint32_t blitMode, uint32_t attachment, bool alreadyLocked, int remaining = 0);
 };
 #endif
 
@@ -453,6 +462,26 @@ class C4ParticleSystem
 	};
 	friend class CalculationThread;
 
+	// the chunks of one frame are spread over the task queues; every worker works on its own queue first
+	// and steals from the other queues when it runs out of work
+	struct CalculationQueue
+	{
+		CStdCSec mutex;
+		std::deque<C4ParticleCalculationTask> tasks;
+	};
+
+	class CalculationWorker : public StdThread
+	{
+	private:
+		size_t queueIndex;
+	public:
+		CStdEvent workAvailableEvent;
+		CalculationWorker(size_t queueIndex) : queueIndex(queueIndex), workAvailableEvent(false) { StdThread::Start(); }
+	protected:
+		void Execute() override;
+	};
+	friend class CalculationWorker;
+
 private:
 	// contains an array with indices for vertices, separated by a primitive restart index
 	GLuint ibo;
@@ -464,10 +493,22 @@ private:
 	CStdEvent frameCounterAdvancedEvent;
 	CalculationThread calculationThread;
 
+	// queue 0 belongs to the calculation thread, queue i to calculationWorkers[i-1]
+	std::vector<std::unique_ptr<CalculationQueue>> calculationQueues;
+	std::vector<std::unique_ptr<CalculationWorker>> calculationWorkers;
+	std::vector<C4ParticleCalculationTask> calculationTasks;
+	std::atomic<size_t> pendingCalculationTasks;
+	CStdEvent calculationFinishedEvent;
+	float calculationTimeDelta;
+
 	int currentSimulationTime; // in game time
 
 	// calculates the physics in all of the existing particle lists
 	void ExecuteCalculation();
+	// works on the tasks of the given queue, then on those of the other queues until all are empty
+	void RunCalculationTasks(size_t queueIndex);
+	bool PopCalculationTask(size_t queueIndex, C4ParticleCalculationTask &task);
+	void ExecuteCalculationTask(const C4ParticleCalculationTask &task);
 
 	C4ParticleList *globalParticles;
 #endif
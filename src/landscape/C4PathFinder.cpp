@@ -49,7 +49,12 @@
 #include "game/C4GraphicsSystem.h"
 #include "graphics/C4Draw.h"
 #include "graphics/C4FacetEx.h"
+#include "landscape/C4Landscape.h"
 #include "lib/StdColors.h"
+#include "platform/StdScheduler.h"
+
+#include <atomic>
+#include <thread>
 
 const int32_t C4PF_MaxDepth        = 35,
               C4PF_MaxCrawl        = 800,
@@ -70,6 +75,8 @@ const int32_t C4PF_MaxDepth        = 35,
               C4PF_Crawl_Left      = 4,
               C4PF_Draw_Rate       = 10;
 
+const size_t C4PF_MaxCacheSize = 512;
+
 //------------------------------- C4PathFinderRay ---------------------------------------------
 class C4PathFinderRay
 {
@@ -146,7 +153,7 @@ bool C4PathFinderRay::Execute()
 		if (UseZone)
 		{
 			// Mark zone used
-			UseZone->Used=true;
+			pPathFinder->UsedZones.push_back(UseZone);
 			// Target in transfer zone: success
 			if (UseZone->At(TargetX,TargetY))
 			{
@@ -223,18 +230,16 @@ bool C4PathFinderRay::Execute()
 		if ((X2==CrawlStartX) && (Y2==CrawlStartY) && (CrawlAttach==CrawlStartAttach))
 			{ Status=C4PF_Ray_Still; break; }
 		// Check unused zone intersection
-		if (pPathFinder->TransferZonesEnabled)
-			if (pPathFinder->TransferZones)
-				if ((pZone = pPathFinder->TransferZones->Find(X2,Y2)))
-					if (!pZone->Used)
-					{
-						// Add use-zone ray (with zone entry point adjust)
-						iX=X2; iY=Y2; if (pZone->GetEntryPoint(iX,iY,X2,Y2))
-							if (!pPathFinder->AddRay(iX,iY,TargetX,TargetY,Depth+1,Direction,this,pZone))
-								{ Status=C4PF_Ray_Failure; break; }
-						// Continue crawling
-						return true;
-					}
+		if ((pZone = pPathFinder->FindTransferZone(X2,Y2)))
+			if (!pPathFinder->IsZoneUsed(pZone))
+			{
+				// Add use-zone ray (with zone entry point adjust)
+				iX=X2; iY=Y2; if (pZone->GetEntryPoint(iX,iY,X2,Y2))
+					if (!pPathFinder->AddRay(iX,iY,TargetX,TargetY,Depth+1,Direction,this,pZone))
+						{ Status=C4PF_Ray_Failure; break; }
+				// Continue crawling
+				return true;
+			}
 		// Crawl length
 		CrawlLength++;
 		if (CrawlLength >= C4PF_MaxCrawl * pPathFinder->Level)
@@ -328,10 +333,8 @@ bool C4PathFinderRay::PathFree(int32_t &rX, int32_t &rY, int32_t iToX, int32_t i
 			else return false;
 			// Check transfer zone intersection
 			if (ppZone)
-				if (pPathFinder->TransferZonesEnabled)
-					if (pPathFinder->TransferZones)
-						if ((*ppZone = pPathFinder->TransferZones->Find(rX,rY)))
-							return false;
+				if ((*ppZone = pPathFinder->FindTransferZone(rX,rY)))
+					return false;
 			// Advance
 			if (d>=0) { x+=xincr; d+=aincr; }
 			else d+=bincr;
@@ -350,10 +353,8 @@ bool C4PathFinderRay::PathFree(int32_t &rX, int32_t &rY, int32_t iToX, int32_t i
 			else return false;
 			// Check transfer zone intersection
 			if (ppZone)
-				if (pPathFinder->TransferZonesEnabled)
-					if (pPathFinder->TransferZones)
-						if ((*ppZone = pPathFinder->TransferZones->Find(rX,rY)))
-							return false;
+				if ((*ppZone = pPathFinder->FindTransferZone(rX,rY)))
+					return false;
 			// Advance
 			if (d>=0) { y+=yincr; d+=aincr; }
 			else d+=bincr;
@@ -414,16 +415,16 @@ void C4PathFinderRay::SetCompletePath()
 	{
 		// Transfer waypoint
 		if (pRay->UseZone)
-			pPathFinder->SetWaypoint(pRay->X2,pRay->Y2,pRay->UseZone->Object);
+			pPathFinder->AddWaypoint(pRay->X2,pRay->Y2,pRay->UseZone->Object);
 		// MoveTo waypoint
 		else
-			pPathFinder->SetWaypoint(pRay->From->X2,pRay->From->Y2,nullptr);
+			pPathFinder->AddWaypoint(pRay->From->X2,pRay->From->Y2,nullptr);
 	}
 }
 
 bool C4PathFinderRay::PointFree(int32_t iX, int32_t iY)
 {
-	return pPathFinder->PointFree(iX,iY);
+	return pPathFinder->IsPointFree(iX,iY);
 }
 
 bool C4PathFinderRay::CrawlTargetFree(int32_t iX, int32_t iY, int32_t iAttach, int32_t iDirection)
@@ -534,6 +535,38 @@ bool C4PathFinderRay::CheckBackRayShorten()
 
 //------------------------------- C4PathFinder ---------------------------------------------
 
+// Searches for queued queries next to the main thread, using its own rays
+class C4PathFinder::SearchThread : public StdThread
+{
+public:
+	SearchThread(const C4PathFinder &rMain, std::vector<Query *> &rPending, std::atomic<size_t> &rNextPending)
+		: Pending(rPending), NextPending(rNextPending)
+	{
+		Finder.Init(rMain.PointFree, rMain.TransferZones);
+		Finder.ShowSearch = false;
+	}
+	~SearchThread() override { Stop(); }
+
+protected:
+	void Execute() override
+	{
+		size_t i = NextPending++;
+		if (i >= Pending.size()) { SignalStop(); return; }
+		Finder.Search(Pending[i]->Key, Pending[i]->Result);
+	}
+
+private:
+	C4PathFinder Finder;
+	std::vector<Query *> &Pending;
+	std::atomic<size_t> &NextPending;
+};
+
+bool C4PathFinder::SearchKey::operator<(const SearchKey &other) const
+{
+	return std::tie(FromX, FromY, ToX, ToY, Level, TransferZonesEnabled)
+	     < std::tie(other.FromX, other.FromY, other.ToX, other.ToY, other.Level, other.TransferZonesEnabled);
+}
+
 C4PathFinder::C4PathFinder()
 {
 	Default();
@@ -547,15 +580,24 @@ C4PathFinder::~C4PathFinder()
 void C4PathFinder::Default()
 {
 	PointFree=nullptr;
-	SetWaypoint=nullptr;
 	FirstRay=nullptr;
 	Success=false;
 	TransferZones=nullptr;
 	TransferZonesEnabled=true;
 	Level=1;
+	ShowSearch=true;
+	CurrentResult=nullptr;
 }
 
 void C4PathFinder::Clear()
+{
+	ClearRays();
+	UsedZones.clear();
+	Queries.clear();
+	Cache.clear();
+}
+
+void C4PathFinder::ClearRays()
 {
 	C4PathFinderRay *pRay,*pNext;
 	for (pRay=FirstRay; pRay; pRay=pNext) { pNext=pRay->Next; delete pRay; }
@@ -567,6 +609,8 @@ void C4PathFinder::Init(PointFreeFn fnPointFree, C4TransferZones* pTransferZones
 	// Set data
 	PointFree = fnPointFree;
 	TransferZones = pTransferZones;
+	// Cached results may stem from other functions
+	Cache.clear();
 }
 
 void C4PathFinder::EnableTransferZones(bool fEnabled)
@@ -581,13 +625,13 @@ void C4PathFinder::SetLevel(int iLevel)
 
 void C4PathFinder::Draw(C4TargetFacet &cgo)
 {
-	if (TransferZones) TransferZones->Draw(cgo);
+	if (TransferZones) TransferZones->Draw(cgo, UsedZones);
 	for (C4PathFinderRay *pRay=FirstRay; pRay; pRay=pRay->Next) pRay->Draw(cgo);
 }
 
 void C4PathFinder::Run()
 {
-	if (TransferZones) TransferZones->ClearUsed();
+	UsedZones.clear();
 	Success=false;
 	while (!Success && Execute()) {}
 	// Notice that ray zone-pointers might be invalid after run
@@ -607,7 +651,7 @@ bool C4PathFinder::Execute()
 	if (iRays>=C4PF_MaxRay) return false;
 
 	// Draw
-	if (::GraphicsSystem.ShowPathfinder)
+	if (ShowSearch && ::GraphicsSystem.ShowPathfinder)
 	{
 		static int32_t iDelay=0;
 		iDelay++; if (iDelay>C4PF_Draw_Rate)
@@ -622,27 +666,171 @@ bool C4PathFinder::Execute()
 
 bool C4PathFinder::Find(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY, SetWaypointFn fnSetWaypoint)
 {
-
-	// Prepare
-	Clear();
-
 	// Parameter safety
 	if (!fnSetWaypoint) return false;
-	SetWaypoint=fnSetWaypoint;
+
+	SearchKey Key = { iFromX, iFromY, iToX, iToY, Level, TransferZonesEnabled };
+	SearchResult Result;
+	Evaluate(Key, Result);
+	if (!Result.Found) return false;
+
+	// Set the waypoints
+	for (const Waypoint &waypoint : Result.Path)
+		fnSetWaypoint(waypoint.X, waypoint.Y, waypoint.TransferObject);
+	return true;
+}
+
+void C4PathFinder::QueueFind(const void *pOwner, int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY, int iLevel, bool fTransferZones, QueryResultFn fnResult)
+{
+	// A new query replaces the pending one of the same owner
+	CancelQueries(pOwner);
+	Query NewQuery;
+	NewQuery.Owner = pOwner;
+	NewQuery.Key = { iFromX, iFromY, iToX, iToY, Clamp(iLevel, 1, 10), fTransferZones };
+	NewQuery.OnResult = std::move(fnResult);
+	Queries.push_back(std::move(NewQuery));
+}
+
+void C4PathFinder::CancelQueries(const void *pOwner)
+{
+	for (Query &query : Queries)
+		if (query.Owner == pOwner)
+			query.Owner = nullptr;
+}
+
+void C4PathFinder::ExecuteQueries()
+{
+	if (Queries.empty()) return;
+
+	// Take cached results, search for the others
+	std::vector<Query *> Pending;
+	for (Query &query : Queries)
+		if (query.Owner && !GetCached(query.Key, query.Result))
+			Pending.push_back(&query);
+
+	// The landscape is not modified until all searches are done, so they may run in parallel.
+	// Searches to be shown by the graphics system are done on this thread only.
+	std::atomic<size_t> NextPending(0);
+	std::vector<std::unique_ptr<SearchThread>> Threads;
+	if (!::GraphicsSystem.ShowPathfinder)
+	{
+		size_t iThreads = std::min<size_t>(std::thread::hardware_concurrency(), Pending.size());
+		for (size_t i = 1; i < iThreads; ++i)
+		{
+			Threads.emplace_back(new SearchThread(*this, Pending, NextPending));
+			if (!Threads.back()->Start()) { Threads.pop_back(); break; }
+		}
+	}
+	for (size_t i; (i = NextPending++) < Pending.size(); )
+		Search(Pending[i]->Key, Pending[i]->Result);
+	// Wait for the searches still running
+	Threads.clear();
+	for (Query *pQuery : Pending)
+		AddToCache(pQuery->Key, pQuery->Result);
+
+	// Deliver in query order. Handlers may cancel or add queries, so the list is accessed by index
+	// and queries added meanwhile are left for the next call.
+	size_t iCount = Queries.size();
+	for (size_t i = 0; i < iCount; ++i)
+	{
+		if (!Queries[i].Owner) continue;
+		Queries[i].Owner = nullptr;
+		QueryResultFn fnResult = std::move(Queries[i].OnResult);
+		SearchResult Result = std::move(Queries[i].Result);
+		fnResult(Result.Found, Result.Path);
+	}
+	Queries.erase(Queries.begin(), Queries.begin() + iCount);
+}
+
+void C4PathFinder::Evaluate(const SearchKey &Key, SearchResult &Result)
+{
+	if (GetCached(Key, Result)) return;
+	Search(Key, Result);
+	AddToCache(Key, Result);
+}
+
+void C4PathFinder::Search(const SearchKey &Key, SearchResult &Result)
+{
+	// Prepare
+	ClearRays();
+	int iPrevLevel = Level; bool fPrevTransferZonesEnabled = TransferZonesEnabled;
+	Level = Key.Level; TransferZonesEnabled = Key.TransferZonesEnabled;
+	Result = SearchResult();
+	Result.Cacheable = true;
+	Result.SolidRevision = ::Landscape.GetSolidRevision();
+	Result.TransferZonesRevision = TransferZones ? TransferZones->GetRevision() : 0;
+	CurrentResult = &Result;
+	AreaX1 = AreaY1 = INT32_MAX; AreaX2 = AreaY2 = INT32_MIN;
+	Success = false;
 
 	// Start & target coordinates must be free
-	if (!PointFree(iFromX,iFromY) || !PointFree(iToX,iToY)) return false;
+	if (IsPointFree(Key.FromX,Key.FromY) && IsPointFree(Key.ToX,Key.ToY))
+		// Add the first two rays
+		if (AddRay(Key.FromX,Key.FromY,Key.ToX,Key.ToY,0,C4PF_Direction_Left,nullptr))
+			if (AddRay(Key.FromX,Key.FromY,Key.ToX,Key.ToY,0,C4PF_Direction_Right,nullptr))
+				// Run
+				Run();
+
+	Result.Found = Success;
+	if (!Success) Result.Path.clear();
+	Result.Area = C4Rect(AreaX1, AreaY1, AreaX2 - AreaX1 + 1, AreaY2 - AreaY1 + 1);
+	CurrentResult = nullptr;
+	Level = iPrevLevel; TransferZonesEnabled = fPrevTransferZonesEnabled;
+}
 
-	// Add the first two rays
-	if (!AddRay(iFromX,iFromY,iToX,iToY,0,C4PF_Direction_Left,nullptr)) return false;
-	if (!AddRay(iFromX,iFromY,iToX,iToY,0,C4PF_Direction_Right,nullptr)) return false;
+bool C4PathFinder::GetCached(const SearchKey &Key, SearchResult &Result) const
+{
+	auto it = Cache.find(Key);
+	if (it == Cache.end()) return false;
+	const SearchResult &Cached = it->second;
+	// Solidity changed within the searched area or transfer zones changed: search again
+	if (::Landscape.GetSolidRevision(Cached.Area) > Cached.SolidRevision) return false;
+	if (Key.TransferZonesEnabled && TransferZones && TransferZones->GetRevision() != Cached.TransferZonesRevision) return false;
+	Result = Cached;
+	return true;
+}
 
-	// Run
-	Run();
+void C4PathFinder::AddToCache(const SearchKey &Key, const SearchResult &Result)
+{
+	if (!Result.Cacheable) return;
+	if (Cache.size() >= C4PF_MaxCacheSize)
+	{
+		// Drop outdated results first, everything if that is not enough
+		for (auto it = Cache.begin(); it != Cache.end(); )
+			if (::Landscape.GetSolidRevision(it->second.Area) > it->second.SolidRevision)
+				it = Cache.erase(it);
+			else
+				++it;
+		if (Cache.size() >= C4PF_MaxCacheSize) Cache.clear();
+	}
+	Cache[Key] = Result;
+}
 
-	// Success
-	return Success;
+bool C4PathFinder::IsPointFree(int32_t iX, int32_t iY)
+{
+	// Remember the checked area for the validation of cached results
+	AreaX1 = std::min(AreaX1, iX); AreaY1 = std::min(AreaY1, iY);
+	AreaX2 = std::max(AreaX2, iX); AreaY2 = std::max(AreaY2, iY);
+	return PointFree(iX, iY);
+}
+
+C4TransferZone *C4PathFinder::FindTransferZone(int32_t iX, int32_t iY)
+{
+	if (!TransferZonesEnabled || !TransferZones) return nullptr;
+	C4TransferZone *pZone = TransferZones->Find(iX, iY);
+	// Zone entry points depend on more of the landscape than the checked area
+	if (pZone && CurrentResult) CurrentResult->Cacheable = false;
+	return pZone;
+}
 
+bool C4PathFinder::IsZoneUsed(C4TransferZone *pZone) const
+{
+	return std::find(UsedZones.begin(), UsedZones.end(), pZone) != UsedZones.end();
+}
+
+void C4PathFinder::AddWaypoint(int32_t iX, int32_t iY, C4Object *pTransferObject)
+{
+	CurrentResult->Path.push_back({ iX, iY, pTransferObject });
 }
 
 bool C4PathFinder::AddRay(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY, int32_t iDepth, int32_t iDirection, C4PathFinderRay *pFrom, C4TransferZone *pUseZone)
@@ -20,7 +20,10 @@
 #ifndef INC_C4PathFinder
 #define INC_C4PathFinder
 
+#include "lib/C4Rect.h"
+
 #include <functional>
+#include <map>
 
 class C4Object;
 class C4PathFinderRay;
@@ -31,8 +34,15 @@ public:
 	C4PathFinder();
 	~C4PathFinder();
 
+	struct Waypoint
+	{
+		int32_t X, Y;
+		C4Object *TransferObject; // set for waypoints that enter a transfer zone
+	};
+
 	typedef std::function<bool(int32_t x, int32_t y)> PointFreeFn;
 	typedef std::function<bool(int32_t x, int32_t y, C4Object *transfer_object)> SetWaypointFn;
+	typedef std::function<void(bool found, const std::vector<Waypoint> &path)> QueryResultFn;
 
 	void Draw(C4TargetFacet &cgo);
 	void Clear();
@@ -42,19 +52,70 @@ public:
 	void EnableTransferZones(bool fEnabled);
 	void SetLevel(int iLevel);
 
+	// Queued queries are evaluated together by ExecuteQueries at a fixed point of the frame,
+	// where the landscape is not modified and the searches may run in parallel.
+	// The results are passed to the handlers in the order of the queries.
+	void QueueFind(const void *pOwner, int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY, int iLevel, bool fTransferZones, QueryResultFn fnResult);
+	void CancelQueries(const void *pOwner);
+	void ExecuteQueries();
+
 private:
+	// Everything a search result depends on besides the landscape and transfer zones
+	struct SearchKey
+	{
+		int32_t FromX, FromY, ToX, ToY;
+		int Level;
+		bool TransferZonesEnabled;
+		bool operator<(const SearchKey &other) const;
+	};
+	struct SearchResult
+	{
+		bool Found = false;
+		std::vector<Waypoint> Path;
+		bool Cacheable = false; // only searches that did not meet any transfer zone
+		C4Rect Area; // pixels checked by the search
+		uint32_t SolidRevision = 0; // landscape revision the search ran on
+		uint32_t TransferZonesRevision = 0;
+	};
+	struct Query
+	{
+		const void *Owner; // nullptr once cancelled or delivered
+		SearchKey Key;
+		QueryResultFn OnResult;
+		SearchResult Result;
+	};
+	class SearchThread;
+
+	void Search(const SearchKey &key, SearchResult &result);
+	void Evaluate(const SearchKey &key, SearchResult &result);
+	bool GetCached(const SearchKey &key, SearchResult &result) const;
+	void AddToCache(const SearchKey &key, const SearchResult &result);
+	bool IsPointFree(int32_t iX, int32_t iY);
+	C4TransferZone *FindTransferZone(int32_t iX, int32_t iY);
+	bool IsZoneUsed(C4TransferZone *pZone) const;
+	void AddWaypoint(int32_t iX, int32_t iY, C4Object *pTransferObject);
+
+	void ClearRays();
 	void Run();
 	bool AddRay(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY, int32_t iDepth, int32_t iDirection, C4PathFinderRay *pFrom, C4TransferZone *pUseZone=nullptr);
 	bool SplitRay(C4PathFinderRay *pRay, int32_t iAtX, int32_t iAtY);
 	bool Execute();
 
 	PointFreeFn PointFree;
-	SetWaypointFn SetWaypoint;
 	C4PathFinderRay *FirstRay;
 	bool Success;
 	C4TransferZones *TransferZones;
 	bool TransferZonesEnabled;
 	int Level;
+	bool ShowSearch; // search may be shown by the graphics system (main thread only)
+
+	// state of the current search
+	SearchResult *CurrentResult;
+	std::vector<C4TransferZone *> UsedZones;
+	int32_t AreaX1, AreaY1, AreaX2, AreaY2;
+
+	std::vector<Query> Queries;
+	std::map<SearchKey, SearchResult> Cache;
 };
 
 
@@ -312,6 +312,7 @@ void C4SLandscape::Default()
 	MaterialZoom=4;
 	FlatChunkShapes=false;
 	Secret=false;
+	MaxPXS=C4S_DefaultMaxPXS;
 }
 
 void C4SLandscape::GetMapSize(int32_t &rWdt, int32_t &rHgt, int32_t iPlayerNum)
@@ -356,6 +357,7 @@ void C4SLandscape::CompileFunc(StdCompiler *pComp)
 	pComp->Value(mkNamingAdapt(MaterialZoom,            "MaterialZoom",          4));
 	pComp->Value(mkNamingAdapt(FlatChunkShapes,         "FlatChunkShapes",       false));
 	pComp->Value(mkNamingAdapt(Secret,                  "Secret",                false));
+	pComp->Value(mkNamingAdapt(MaxPXS,                  "MaxPXS",                C4S_DefaultMaxPXS));
 }
 
 void C4SWeather::Default()
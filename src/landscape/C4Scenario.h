@@ -136,6 +136,10 @@ public:
 
 const int32_t C4S_MaxMapPlayerExtend = 4;
 
+// Default limit of loose material pixels
+
+const int32_t C4S_DefaultMaxPXS = 10000;
+
 class C4SPlrStart
 {
 public:
@@ -185,6 +189,7 @@ public:
 	int32_t MaterialZoom;
 	bool FlatChunkShapes; // if true, all material chunks are drawn flat
 	bool Secret; // hide map from observers (except in dev mode and the like)
+	int32_t MaxPXS; // maximum number of loose material pixels
 public:
 	void Default();
 	void GetMapSize(int32_t &rWdt, int32_t &rHgt, int32_t iPlayerNum);
@@ -20,6 +20,7 @@
 #include "landscape/C4SolidMask.h"
 
 #include "graphics/C4DrawGL.h"
+#include "graphics/C4Surface.h"
 #include "graphics/CSurface8.h"
 #include "graphics/StdPNG.h"
 #include "landscape/C4Landscape.h"
@@ -28,6 +29,7 @@
 #include "object/C4GameObjects.h"
 #include "object/C4Object.h"
 
+const int32_t C4SM_IndexCellShift = 7; // 128x128 pixel cells
 
 void C4SolidMask::Put(bool fCauseInstability, C4TargetRect *pClipRect, bool fRestoreAttachment)
 {
@@ -182,6 +184,7 @@ void C4SolidMask::Put(bool fCauseInstability, C4TargetRect *pClipRect, bool fRes
 	}
 	// Store mask put status
 	MaskPut=true;
+	UpdateIndex();
 	// restore attached object positions if moved
 	if (fRestoreAttachment && iAttachingObjectsCount)
 	{
@@ -270,9 +273,14 @@ void C4SolidMask::Remove(bool fBackupAttachment)
 	}
 	// Mask not put flag
 	MaskPut=false;
+	RemoveFromIndex();
 	// update surrounding masks in that range
 	C4TargetRect ClipRect;
-	for (C4SolidMask *pSolid = C4SolidMask::Last; pSolid; pSolid = pSolid->Prev)
+	std::vector<C4SolidMask *> masks;
+	GetPutMasks(MaskPutRect, masks);
+	for (auto it = masks.rbegin(); it != masks.rend(); ++it)
+	{
+		C4SolidMask *pSolid = *it;
 		if (pSolid->MaskPut) if (pSolid->MaskPutRect.Overlap(MaskPutRect))
 			{
 				// set clipping rect for all calls, since they may modify it
@@ -281,7 +289,10 @@ void C4SolidMask::Remove(bool fBackupAttachment)
 				pSolid->MaskPut = false;
 				// re-put the solidmask
 				pSolid->Put(false, &ClipRect, false);
+				// a failed re-put leaves the mask removed
+				pSolid->UpdateIndex();
 			}
+	}
 
 	// backup attachment if desired: Backup old pos and all objects that attach to or lie on the SolidMask
 	if (fBackupAttachment)
@@ -292,7 +303,7 @@ void C4SolidMask::Remove(bool fBackupAttachment)
 		// Search in area slightly larger than SolidMask because objects might have vertices slightly outside their shape
 		C4LArea SolidArea(&::Objects.Sectors, MaskPutRect.x-1, MaskPutRect.y-4, MaskPutRect.Wdt+2, MaskPutRect.Hgt+2);
 		C4LSector *pSct;
-		for (C4ObjectList *pLst=SolidArea.FirstObjectShapes(&pSct); pLst; pLst=SolidArea.NextObjectShapes(pLst, &pSct))
+		for (C4LSectorList *pLst=SolidArea.FirstObjectShapes(&pSct); pLst; pLst=SolidArea.NextObjectShapes(pLst, &pSct))
 			for (C4Object *pObj : *pLst)
 				if (pObj && pObj != pForObject && pObj->IsMoveableBySolidMask(pForObject->GetSolidMaskPlane()) && !pObj->Shape.CheckContact(pObj->GetX(),pObj->GetY()))
 				{
@@ -415,6 +426,8 @@ C4SolidMask::C4SolidMask(C4Object *pForObject) : pForObject(pForObject)
 	ppAttachingObjects=nullptr;
 	iAttachingObjectsCount=iAttachingObjectsCapacity=0;
 	MaskMaterial=MCVehic;
+	Sequence = SequenceCounter++;
+	Indexed = false;
 	// Update linked list
 	Next = nullptr;
 	Prev = Last;
@@ -431,6 +444,7 @@ C4SolidMask::C4SolidMask(C4Object *pForObject) : pForObject(pForObject)
 C4SolidMask::~C4SolidMask()
 {
 	Remove(false);
+	RemoveFromIndex();
 	// Update linked list
 	if (Next) Next->Prev = Prev;
 	if (Prev) Prev->Next = Next;
@@ -463,6 +477,92 @@ void C4SolidMask::PutSolidMasks()
 
 C4SolidMask * C4SolidMask::First = nullptr;
 C4SolidMask * C4SolidMask::Last = nullptr;
+std::vector<std::vector<C4SolidMask *>> C4SolidMask::IndexCells;
+int32_t C4SolidMask::IndexWdt = 0, C4SolidMask::IndexHgt = 0;
+int32_t C4SolidMask::IndexLandscapeWdt = 0, C4SolidMask::IndexLandscapeHgt = 0;
+uint32_t C4SolidMask::SequenceCounter = 0;
+
+void C4SolidMask::CheckIndex()
+{
+	// (Re)build the grid if the landscape changed size since it was set up
+	if (IndexLandscapeWdt != ::Landscape.GetWidth() || IndexLandscapeHgt != ::Landscape.GetHeight())
+	{
+		for (C4SolidMask *pSolid = First; pSolid; pSolid = pSolid->Next)
+			pSolid->Indexed = false;
+		IndexLandscapeWdt = ::Landscape.GetWidth();
+		IndexLandscapeHgt = ::Landscape.GetHeight();
+		IndexWdt = (IndexLandscapeWdt >> C4SM_IndexCellShift) + 1;
+		IndexHgt = (IndexLandscapeHgt >> C4SM_IndexCellShift) + 1;
+		IndexCells.clear();
+		IndexCells.resize(IndexWdt * IndexHgt);
+		for (C4SolidMask *pSolid = First; pSolid; pSolid = pSolid->Next)
+			pSolid->UpdateIndex();
+	}
+}
+
+bool C4SolidMask::GetIndexCells(const C4Rect &rect, int32_t &x1, int32_t &y1, int32_t &x2, int32_t &y2)
+{
+	// Degenerated rects still cover the cell of their corner, because Overlap() may report them
+	// as overlapping. Everything outside the landscape goes to the border cells.
+	x1 = Clamp<int32_t>(rect.x >> C4SM_IndexCellShift, 0, IndexWdt - 1);
+	y1 = Clamp<int32_t>(rect.y >> C4SM_IndexCellShift, 0, IndexHgt - 1);
+	x2 = Clamp<int32_t>((rect.x + std::max<int32_t>(rect.Wdt, 1) - 1) >> C4SM_IndexCellShift, 0, IndexWdt - 1);
+	y2 = Clamp<int32_t>((rect.y + std::max<int32_t>(rect.Hgt, 1) - 1) >> C4SM_IndexCellShift, 0, IndexHgt - 1);
+	return x1 <= x2 && y1 <= y2;
+}
+
+void C4SolidMask::UpdateIndex()
+{
+	if (!MaskPut) { RemoveFromIndex(); return; }
+	CheckIndex();
+	int32_t x1, y1, x2, y2;
+	if (!GetIndexCells(MaskPutRect, x1, y1, x2, y2)) return;
+	// Still listed at the right place?
+	if (Indexed)
+	{
+		if (IndexedRect.x == MaskPutRect.x && IndexedRect.y == MaskPutRect.y && IndexedRect.Wdt == MaskPutRect.Wdt && IndexedRect.Hgt == MaskPutRect.Hgt) return;
+		RemoveFromIndex();
+	}
+	for (int32_t y = y1; y <= y2; ++y)
+		for (int32_t x = x1; x <= x2; ++x)
+			IndexCells[y * IndexWdt + x].push_back(this);
+	IndexedRect = MaskPutRect;
+	Indexed = true;
+}
+
+void C4SolidMask::RemoveFromIndex()
+{
+	if (!Indexed) return;
+	Indexed = false;
+	int32_t x1, y1, x2, y2;
+	if (!GetIndexCells(IndexedRect, x1, y1, x2, y2)) return;
+	for (int32_t y = y1; y <= y2; ++y)
+		for (int32_t x = x1; x <= x2; ++x)
+		{
+			std::vector<C4SolidMask *> &cell = IndexCells[y * IndexWdt + x];
+			auto it = std::find(cell.begin(), cell.end(), this);
+			if (it == cell.end()) continue;
+			*it = cell.back();
+			cell.pop_back();
+		}
+}
+
+void C4SolidMask::GetPutMasks(const C4Rect &where, std::vector<C4SolidMask *> &masks)
+{
+	masks.clear();
+	CheckIndex();
+	int32_t x1, y1, x2, y2;
+	if (!GetIndexCells(where, x1, y1, x2, y2)) return;
+	for (int32_t y = y1; y <= y2; ++y)
+		for (int32_t x = x1; x <= x2; ++x)
+		{
+			const std::vector<C4SolidMask *> &cell = IndexCells[y * IndexWdt + x];
+			masks.insert(masks.end(), cell.begin(), cell.end());
+		}
+	// Masks spanning several cells are found multiple times
+	std::sort(masks.begin(), masks.end(), [](const C4SolidMask *a, const C4SolidMask *b) { return a->Sequence < b->Sequence; });
+	masks.erase(std::unique(masks.begin(), masks.end()), masks.end());
+}
 
 
 bool C4SolidMask::CheckConsistency()
@@ -489,14 +589,18 @@ CSurface8 *C4SolidMask::LoadMaskFromFile(class C4Group &hGroup, const char *szFi
 {
 	// Construct SolidMask surface from PNG bitmap:
 	// All pixels that are more than 50% transparent are not solid
-	CPNGFile png;
-	StdBuf png_buf;
-	if (!hGroup.LoadEntry(szFilename, &png_buf)) return nullptr; // error messages done by caller
-	if (!png.Load((BYTE*)png_buf.getMData(), png_buf.getSize())) return nullptr;
-	CSurface8 *result = new CSurface8(png.iWdt, png.iHgt);
-	for (size_t y=0u; y<png.iHgt; ++y)
-		for (size_t x=0u; x<png.iWdt; ++x)
-			result->SetPix(x,y,((png.GetPix(x,y)>>24)<128) ? 0x00 : 0xff);
+	std::unique_ptr<CPNGFile> png = ::DecodedImages.Take(hGroup, szFilename);
+	if (!png)
+	{
+		StdBuf png_buf;
+		png = std::make_unique<CPNGFile>();
+		if (!hGroup.LoadEntry(szFilename, &png_buf)) return nullptr; // error messages done by caller
+		if (!png->Load((BYTE*)png_buf.getMData(), png_buf.getSize())) return nullptr;
+	}
+	CSurface8 *result = new CSurface8(png->iWdt, png->iHgt);
+	for (size_t y=0u; y<png->iHgt; ++y)
+		for (size_t x=0u; x<png->iWdt; ++x)
+			result->SetPix(x,y,((png->GetPix(x,y)>>24)<128) ? 0x00 : 0xff);
 	return result;
 }
 
@@ -22,6 +22,8 @@
 #include "object/C4ObjectList.h"
 #include "object/C4Shape.h"
 
+#include <vector>
+
 class C4SolidMask
 {
 protected:
@@ -64,6 +66,19 @@ protected:
 	// Reput and update Matbuf after landscape change underneath
 	void Repair(C4Rect where);
 
+	// Grid of landscape cells, each listing the put solidmasks whose MaskPutRect touches it
+	static std::vector<std::vector<C4SolidMask *>> IndexCells;
+	static int32_t IndexWdt, IndexHgt; // grid size in cells
+	static int32_t IndexLandscapeWdt, IndexLandscapeHgt; // landscape size the grid was built for
+	static uint32_t SequenceCounter;
+	uint32_t Sequence;   // creation order, i.e. position in the First..Last list
+	bool Indexed;        // if set, the mask is listed in the cells covered by IndexedRect
+	C4Rect IndexedRect;
+	void UpdateIndex();  // list the mask in the index while it is put
+	void RemoveFromIndex();
+	static void CheckIndex();
+	static bool GetIndexCells(const C4Rect &rect, int32_t &x1, int32_t &y1, int32_t &x2, int32_t &y2);
+
 	friend class C4Landscape;
 	friend class DensityProvider;
 
@@ -82,6 +97,9 @@ public:
 	C4SolidMask(C4Object *pForObject);  // ctor
 	~C4SolidMask(); // dtor
 
+	// Put solidmasks that may overlap the given rect, in list order (First to Last)
+	static void GetPutMasks(const C4Rect &where, std::vector<C4SolidMask *> &masks);
+
 	static bool CheckConsistency();
 	static void RemoveSolidMasks();
 	static void PutSolidMasks();
@@ -31,7 +31,6 @@ C4TransferZone::C4TransferZone()
 	Object = nullptr;
 	X = Y = Wdt = Hgt = 0;
 	Next = nullptr;
-	Used = false;
 }
 
 C4TransferZone::~C4TransferZone() = default;
@@ -49,6 +48,7 @@ C4TransferZones::~C4TransferZones()
 void C4TransferZones::Default()
 {
 	First=nullptr;
+	Revision=0;
 }
 
 void C4TransferZones::Clear()
@@ -56,6 +56,7 @@ void C4TransferZones::Clear()
 	C4TransferZone *pZone,*pNext;
 	for (pZone=First; pZone; pZone=pNext) { pNext=pZone->Next; delete pZone; }
 	First=nullptr;
+	Revision++;
 }
 
 void C4TransferZones::ClearPointers(C4Object *pObj)
@@ -76,8 +77,10 @@ bool C4TransferZones::Set(int32_t iX, int32_t iY, int32_t iWdt, int32_t iHgt, C4
 	// Update existing zone
 	if ((pZone=Find(pObj)))
 	{
+		if (pZone->X==iX && pZone->Y==iY && pZone->Wdt==iWdt && pZone->Hgt==iHgt) return true;
 		pZone->X=iX; pZone->Y=iY;
 		pZone->Wdt=iWdt; pZone->Hgt=iHgt;
+		Revision++;
 	}
 	// Allocate and add new zone
 	else
@@ -96,6 +99,7 @@ bool C4TransferZones::Add(int32_t iX, int32_t iY, int32_t iWdt, int32_t iHgt, C4
 	pZone->Object=pObj;
 	pZone->Next=First;
 	First=pZone;
+	Revision++;
 	// Success
 	return true;
 }
@@ -115,15 +119,14 @@ C4TransferZone* C4TransferZones::Find(int32_t iX, int32_t iY)
 	return nullptr;
 }
 
-void C4TransferZones::Draw(C4TargetFacet &cgo)
+void C4TransferZones::Draw(C4TargetFacet &cgo, const std::vector<C4TransferZone *> &Highlight)
 {
 	for (C4TransferZone *pZone=First; pZone; pZone=pZone->Next)
-		pZone->Draw(cgo);
+		pZone->Draw(cgo, std::find(Highlight.begin(), Highlight.end(), pZone) != Highlight.end());
 }
 
 void C4TransferZone::Draw(C4TargetFacet &cgo, bool fHighlight)
 {
-	if (Used) fHighlight=true;
 	pDraw->DrawFrameDw(cgo.Surface,
 	                   int(cgo.X+X-cgo.TargetX),int(cgo.Y+Y-cgo.TargetY),
 	                   int(cgo.X+X-cgo.TargetX+Wdt-1),int(cgo.Y+Y-cgo.TargetY+Hgt-1),
@@ -152,6 +155,7 @@ int32_t C4TransferZones::RemoveNullZones()
 		else
 			pPrev=pZone;
 	}
+	if (iResult) Revision++;
 	return iResult;
 }
 
@@ -199,12 +203,6 @@ bool C4TransferZone::GetEntryPoint(int32_t &rX, int32_t &rY, int32_t iToX, int32
 	return true;
 }
 
-void C4TransferZones::ClearUsed()
-{
-	for (C4TransferZone *pZone=First; pZone; pZone=pZone->Next)
-		pZone->Used=false;
-}
-
 C4TransferZone* C4TransferZones::Find(C4Object *pObj)
 {
 	for (C4TransferZone *pZone=First; pZone; pZone=pZone->Next)
@@ -29,7 +29,6 @@ public:
 public:
 	C4Object *Object;
 	int32_t X,Y,Wdt,Hgt;
-	bool Used;
 protected:
 	C4TransferZone *Next;
 public:
@@ -46,17 +45,18 @@ public:
 protected:
 	int32_t RemoveNullZones();
 	C4TransferZone *First;
+	uint32_t Revision; // raised with every change of the zones
 public:
 	void Default();
 	void Clear();
-	void ClearUsed();
 	void ClearPointers(C4Object *pObj);
-	void Draw(C4TargetFacet &cgo);
+	void Draw(C4TargetFacet &cgo, const std::vector<C4TransferZone *> &Highlight);
 	void Synchronize();
 	C4TransferZone* Find(C4Object *pObj);
 	C4TransferZone* Find(int32_t iX, int32_t iY);
 	bool Add(int32_t iX, int32_t iY, int32_t iWdt, int32_t iHgt, C4Object *pObj);
 	bool Set(int32_t iX, int32_t iY, int32_t iWdt, int32_t iHgt, C4Object *pObj);
+	uint32_t GetRevision() const { return Revision; }
 };
 
 #endif
@@ -0,0 +1,192 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2016, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+// Hot path tracing
+
+#include "C4Include.h"
+#include "lib/C4Trace.h"
+
+#include "platform/StdSync.h"
+
+#include <chrono>
+#include <unordered_set>
+
+namespace
+{
+	typedef std::chrono::steady_clock Clock;
+
+	struct TraceEvent
+	{
+		const char *category, *name;
+		Clock::time_point start;
+		Clock::duration duration;
+	};
+
+	// Events of one thread. Completed spans go into a ring buffer that
+	// overwrites the oldest events once full; open spans live on a stack.
+	struct TraceBuffer
+	{
+		int32_t ThreadIndex;
+		CStdCSec Lock; // taken by the owning thread when completing a span and by the writer
+		std::vector<TraceEvent> Events;
+		size_t NextEvent{0};
+		bool Wrapped{false};
+		// only accessed by the owning thread
+		std::vector<TraceEvent> OpenSpans;
+		uint32_t Generation{0};
+		std::unordered_set<std::string> Names; // copied span names
+
+		void Reset(size_t size)
+		{
+			CStdLock lock(&Lock);
+			Events.clear();
+			Events.resize(size);
+			NextEvent = 0;
+			Wrapped = false;
+		}
+	};
+
+	CStdCSec RegistryLock;
+	std::vector<std::shared_ptr<TraceBuffer>> Buffers;
+	size_t BufferSize = C4Trace::DefaultBufferSize;
+	Clock::time_point TraceStart;
+	std::atomic<uint32_t> Generation{0}; // incremented by every Start
+
+	thread_local std::shared_ptr<TraceBuffer> ThreadBuffer;
+
+	TraceBuffer &GetThreadBuffer()
+	{
+		if (!ThreadBuffer)
+		{
+			ThreadBuffer = std::make_shared<TraceBuffer>();
+			CStdLock lock(&RegistryLock);
+			ThreadBuffer->ThreadIndex = Buffers.size();
+			ThreadBuffer->Reset(BufferSize);
+			Buffers.push_back(ThreadBuffer);
+		}
+		// spans left open by a previous trace run are never closed properly
+		if (ThreadBuffer->Generation != Generation)
+		{
+			ThreadBuffer->OpenSpans.clear();
+			ThreadBuffer->Generation = Generation;
+		}
+		return *ThreadBuffer;
+	}
+
+	void AppendJSONString(StdStrBuf &buf, const char *s)
+	{
+		buf.AppendChar('"');
+		for (; *s; ++s)
+		{
+			if (*s == '"' || *s == '\\')
+				buf.AppendChar('\\');
+			if (static_cast<unsigned char>(*s) < 0x20)
+				buf.AppendFormat("\\u%04x", static_cast<unsigned int>(*s));
+			else
+				buf.AppendChar(*s);
+		}
+		buf.AppendChar('"');
+	}
+
+	double ToMicroseconds(Clock::duration d)
+	{
+		return std::chrono::duration<double, std::micro>(d).count();
+	}
+}
+
+std::atomic<bool> C4Trace::Enabled{false};
+
+void C4Trace::Start(size_t buffer_size)
+{
+	CStdLock lock(&RegistryLock);
+	Enabled = false;
+	BufferSize = std::max<size_t>(buffer_size, 1);
+	for (auto &buffer : Buffers)
+		buffer->Reset(BufferSize);
+	TraceStart = Clock::now();
+	++Generation;
+	Enabled = true;
+}
+
+void C4Trace::Stop()
+{
+	Enabled = false;
+}
+
+void C4Trace::BeginSpan(const char *category, const char *name, bool copy_name)
+{
+	TraceBuffer &buffer = GetThreadBuffer();
+	if (copy_name)
+		name = buffer.Names.insert(name ? name : "").first->c_str();
+	buffer.OpenSpans.push_back({ category, name, Clock::now(), Clock::duration::zero() });
+}
+
+void C4Trace::EndSpan()
+{
+	TraceBuffer &buffer = GetThreadBuffer();
+	// spans opened before tracing started are not recorded
+	if (buffer.OpenSpans.empty()) return;
+	TraceEvent event = buffer.OpenSpans.back();
+	buffer.OpenSpans.pop_back();
+	event.duration = Clock::now() - event.start;
+	CStdLock lock(&buffer.Lock);
+	if (buffer.Events.empty()) return;
+	buffer.Events[buffer.NextEvent] = event;
+	if (++buffer.NextEvent == buffer.Events.size())
+	{
+		buffer.NextEvent = 0;
+		buffer.Wrapped = true;
+	}
+}
+
+bool C4Trace::WriteChromeTrace(const char *filename)
+{
+	StdStrBuf out;
+	out.Append("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	bool first = true;
+	size_t event_count = 0;
+	CStdLock registry_lock(&RegistryLock);
+	for (auto &buffer : Buffers)
+	{
+		CStdLock lock(&buffer->Lock);
+		if (!first) out.Append(",\n");
+		first = false;
+		out.AppendFormat(R"({"name":"thread_name","ph":"M","pid":1,"tid":%d,"args":{"name":"Thread %d"}})", (int) buffer->ThreadIndex, (int) buffer->ThreadIndex);
+		// oldest events first
+		size_t count = buffer->Wrapped ? buffer->Events.size() : buffer->NextEvent;
+		size_t begin = buffer->Wrapped ? buffer->NextEvent : 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			const TraceEvent &event = buffer->Events[(begin + i) % buffer->Events.size()];
+			if (event.start < TraceStart) continue;
+			out.Append(",\n{\"name\":");
+			AppendJSONString(out, event.name);
+			out.Append(",\"cat\":");
+			AppendJSONString(out, event.category);
+			out.AppendFormat(",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+			                 ToMicroseconds(event.start - TraceStart), ToMicroseconds(event.duration), (int) buffer->ThreadIndex);
+			++event_count;
+		}
+		if (buffer->Wrapped)
+			LogF("Trace: Ring buffer of thread %d overflowed; only the last %d spans were kept", (int) buffer->ThreadIndex, (int) count);
+	}
+	out.Append("\n]}\n");
+	if (!out.SaveToFile(filename))
+	{
+		LogF("Trace: Could not write %s", filename);
+		return false;
+	}
+	LogF("Trace: %d spans written to %s", (int) event_count, filename);
+	return true;
+}
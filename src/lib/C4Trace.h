@@ -0,0 +1,73 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2016, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+// Hot path tracing. Nested spans are recorded into per-thread ring buffers
+// while tracing is enabled and can be written in the Chrome trace event
+// format (chrome://tracing, Perfetto, speedscope).
+
+#ifndef INC_C4Trace
+#define INC_C4Trace
+
+#include <atomic>
+
+class C4Trace
+{
+public:
+	static const size_t DefaultBufferSize = 1 << 18; // events per thread
+
+	// Checked before any span is recorded; tracing costs a single branch while disabled
+	static bool IsEnabled() { return Enabled.load(std::memory_order_relaxed); }
+
+	// (Re)start recording. Previously recorded events are discarded.
+	static void Start(size_t buffer_size = DefaultBufferSize);
+	static void Stop();
+
+	// Span names and categories must stay valid until the trace is written,
+	// unless copy_name is set (e.g. for script function names).
+	// Spans must be closed in reverse order on the thread that opened them.
+	static void BeginSpan(const char *category, const char *name, bool copy_name = false);
+	static void EndSpan();
+
+	// Writes all buffered events as a Chrome trace event JSON file
+	static bool WriteChromeTrace(const char *filename);
+
+private:
+	static std::atomic<bool> Enabled;
+};
+
+// Records a span from construction until destruction. Next() closes the
+// current span and opens a sibling, for sequential phases in one function.
+class C4TraceScope
+{
+public:
+	C4TraceScope(const char *category, const char *name, bool copy_name = false) : category(category), active(C4Trace::IsEnabled())
+	{
+		if (active) C4Trace::BeginSpan(category, name, copy_name);
+	}
+	~C4TraceScope()
+	{
+		if (active) C4Trace::EndSpan();
+	}
+	void Next(const char *name, bool copy_name = false)
+	{
+		if (active) C4Trace::EndSpan();
+		active = C4Trace::IsEnabled();
+		if (active) C4Trace::BeginSpan(category, name, copy_name);
+	}
+private:
+	const char *category;
+	bool active;
+};
+
+#endif // INC_C4Trace
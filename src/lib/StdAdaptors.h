@@ -566,7 +566,7 @@ void StdPtrAdaptCompileFunc(StdCompiler* pComp, const T& adapt, P && ...pars)
 		}
 		else
 		{
-			bool fNull = !! adapt.rpObj;
+			bool fNull = ! adapt.rpObj;
 			pComp->Value(fNull);
 			// Null? Nothing further to do
 			if(fNull) return;
@@ -656,8 +656,10 @@ void C4Network2::Execute()
 
 	if (isHost())
 	{
+		// publish dynamic packed in the background
+		CheckDynamicSnapshot();
 		// remove dynamic
-		if (!ResDynamic.isNull() && ::Control.ControlTick > iDynamicTick)
+		if (!ResDynamic.isNull() && ::Control.ControlTick > iDynamicMaxTick)
 			RemoveDynamic();
 		// Set chase target
 		UpdateChaseTarget();
@@ -737,13 +739,17 @@ void C4Network2::Clear()
 	Clients.Clear();
 	// close net classes
 	NetIO.Clear();
+	// stop packing dynamic
+	pDynamicSnapshot.reset();
+	DynamicParameters.Clear();
 	// clear resources
 	ResList.Clear();
 	// clear password
 	sPassword.Clear();
 	// stuff
 	fAllowJoin = false;
-	iDynamicTick = -1; fDynamicNeeded = false;
+	iDynamicTick = iDynamicMaxTick = -1; fDynamicNeeded = false;
+	fDynamicSnapshotOutdated = false;
 	tLastActivateRequest = C4TimeMilliseconds::NegativeInfinity;
 	iLastChaseTargetUpdate = iLastReferenceUpdate = iLastLeagueUpdate = 0;
 	fDelayedActivateReq = false;
@@ -1067,6 +1073,9 @@ void C4Network2::OnGameSynchronized()
 	{
 		// create dynamic
 		bool fSuccess = CreateDynamic(false);
+		// packed in the background? Join data will be sent once it is published.
+		if (fSuccess && pDynamicSnapshot)
+			{ CheckDynamicSnapshot(); return; }
 		// check for clients that still need join-data
 		C4Network2Client *pClient = nullptr;
 		while ((pClient = Clients.GetNextClient(pClient)))
@@ -1647,8 +1656,10 @@ void C4Network2::SendJoinData(C4Network2Client *pClient)
 	if (pClient->hasJoinData()) return;
 	// host only, scenario must be available
 	assert(isHost());
+	// dynamic being packed? The client gets it once it is published.
+	if (pDynamicSnapshot) return;
 	// dynamic available?
-	if (ResDynamic.isNull() || iDynamicTick < ::Control.ControlTick)
+	if (ResDynamic.isNull() || iDynamicMaxTick < ::Control.ControlTick)
 	{
 		fDynamicNeeded = true;
 		// add synchronization control (will callback, see C4Game::Synchronize)
@@ -1662,8 +1673,8 @@ void C4Network2::SendJoinData(C4Network2Client *pClient)
 	JoinData.SetGameStatus(Status);
 	// scenario parameter defs for lobby display (localized in host language)
 	JoinData.ScenarioParameterDefs = ::Game.ScenarioParameterDefs;
-	// parameters
-	JoinData.Parameters = Game.Parameters;
+	// parameters (as they were when the dynamic was saved, if control has been executed since)
+	JoinData.Parameters = iDynamicTick < ::Control.ControlTick ? DynamicParameters : Game.Parameters;
 	// core join data
 	JoinData.SetStartCtrlTick(iDynamicTick);
 	JoinData.SetDynamicCore(ResDynamic);
@@ -1782,14 +1793,32 @@ bool C4Network2::CreateDynamic(bool fInit)
 		Log(LoadResStr("IDS_NET_SAVE_ERR_CREATEDYNFILE"));
 	// save dynamic data
 	C4GameSaveNetwork SaveGame(fInit);
-	if (!SaveGame.Save(szDynamicFilename) || !SaveGame.Close())
+	if (!SaveGame.Save(szDynamicFilename))
 		{ Log(LoadResStr("IDS_NET_SAVE_ERR_SAVEDYNFILE")); return false; }
+	// at runtime, the game state is captured now. Packing the group and
+	// calculating checksums can be done in the background.
+	if (!fInit && !fDynamicSnapshotOutdated)
+	{
+		C4Group *pGroup = SaveGame.ReleaseGroup();
+		if (!pGroup)
+			{ Log(LoadResStr("IDS_NET_SAVE_ERR_SAVEDYNFILE")); return false; }
+		pDynamicSnapshot.reset(new C4Network2DynamicSnapshot(pGroup, szDynamicFilename, ResList, ::Control.getNextControlTick()));
+		// no thread? Pack right away.
+		if (!pDynamicSnapshot->Start())
+			pDynamicSnapshot->Pack();
+		// will be published by CheckDynamicSnapshot
+		fDynamicNeeded = false;
+		return true;
+	}
+	if (!SaveGame.Close())
+		{ Log(LoadResStr("IDS_NET_SAVE_ERR_SAVEDYNFILE")); return false; }
+	fDynamicSnapshotOutdated = false;
 	// add resource
 	C4Network2Res::Ref pRes = ResList.AddByFile(szDynamicFilename, true, NRT_Dynamic);
 	if (!pRes) { Log(LoadResStr("IDS_NET_SAVE_ERR_ADDDYNDATARES")); return false; }
 	// save
 	ResDynamic = pRes->getCore();
-	iDynamicTick = ::Control.getNextControlTick();
+	iDynamicTick = iDynamicMaxTick = ::Control.getNextControlTick();
 	fDynamicNeeded = false;
 	// ok
 	return true;
@@ -1797,10 +1826,105 @@ bool C4Network2::CreateDynamic(bool fInit)
 
 void C4Network2::RemoveDynamic()
 {
+	// abort any snapshot still being packed
+	if (pDynamicSnapshot)
+	{
+		pDynamicSnapshot->Cancel();
+		pDynamicSnapshot.reset();
+	}
 	C4Network2Res::Ref pRes = ResList.getRefRes(ResDynamic.getID());
 	if (pRes) pRes->Remove();
 	ResDynamic.Clear();
-	iDynamicTick = -1;
+	iDynamicTick = iDynamicMaxTick = -1;
+	DynamicParameters.Clear();
+}
+
+void C4Network2::CheckDynamicSnapshot()
+{
+	if (!pDynamicSnapshot || !pDynamicSnapshot->isDone()) return;
+	std::unique_ptr<C4Network2DynamicSnapshot> pSnapshot(std::move(pDynamicSnapshot));
+	pSnapshot->Stop();
+	C4Network2Res::Ref pRes = pSnapshot->getRes();
+	bool fSuccess = false;
+	if (!pRes)
+	{
+		Log(LoadResStr("IDS_NET_SAVE_ERR_ADDDYNDATARES"));
+		pSnapshot->Cancel();
+	}
+	// joining clients can only catch up with the control still in the backlog
+	else if (::Control.ControlTick > pSnapshot->getCtrlTick() + C4NetDynamicMaxAge)
+	{
+		LogSilentF("Network: dynamic for tick %d outdated (now %d), saving again", (int) pSnapshot->getCtrlTick(), (int) ::Control.ControlTick);
+		pSnapshot->Cancel();
+		fDynamicSnapshotOutdated = true;
+	}
+	else
+	{
+		// publish
+		ResDynamic = pRes->getCore();
+		iDynamicTick = pSnapshot->getCtrlTick();
+		iDynamicMaxTick = iDynamicTick + C4NetDynamicMaxAge;
+		DynamicParameters = pSnapshot->getParameters();
+		fSuccess = true;
+	}
+	// check for clients that still need join-data
+	C4Network2Client *pClient = nullptr;
+	while ((pClient = Clients.GetNextClient(pClient)))
+		if (!pClient->hasJoinData())
+		{
+			if (fSuccess || fDynamicSnapshotOutdated)
+				// send it or request another synchronization
+				SendJoinData(pClient);
+			else
+				// join data could not be created: emergency kick
+				Game.Clients.CtrlRemove(pClient->getClient(), LoadResStr("IDS_ERR_ERRORWHILECREATINGJOINDAT"));
+		}
+}
+
+// *** C4Network2DynamicSnapshot
+
+C4Network2DynamicSnapshot::C4Network2DynamicSnapshot(C4Group *pGroup, const char *szFilename, C4Network2ResList &ResList, int32_t iCtrlTick)
+		: pGroup(pGroup), Filename(szFilename), ResList(ResList), iCtrlTick(iCtrlTick)
+{
+	// join data must describe the game at the time of the snapshot
+	Parameters = Game.Parameters;
+}
+
+C4Network2DynamicSnapshot::~C4Network2DynamicSnapshot()
+{
+	Stop();
+}
+
+void C4Network2DynamicSnapshot::Cancel()
+{
+	Stop();
+	// discard the group if the thread didn't get to it
+	pGroup.reset();
+	if (pRes)
+	{
+		pRes->Remove();
+		pRes.Clear();
+	}
+	else
+		EraseItem(Filename.getData());
+}
+
+void C4Network2DynamicSnapshot::Pack() // by snapshot thread
+{
+	// pack and compress
+	bool fSuccess = pGroup->Close();
+	pGroup.reset();
+	// add resource (calculates checksums)
+	if (fSuccess)
+		pRes = ResList.AddByFile(Filename.getData(), true, NRT_Dynamic);
+	// done
+	fDone = true;
+}
+
+void C4Network2DynamicSnapshot::Execute()
+{
+	Pack();
+	SignalStop();
 }
 
 bool C4Network2::isFrozen() const
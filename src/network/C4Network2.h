@@ -44,6 +44,10 @@ const int C4NetActivationReqInterval = 5000, // (ms)
 // client chase
 const unsigned int C4NetChaseTargetUpdateInterval = 5; // (s)
 
+// runtime join: age up to which a dynamic packed in the background is sent to
+// joining clients, who have to fetch the control since then from the backlog
+const int32_t C4NetDynamicMaxAge = 50; // (ticks) - must be smaller than C4ControlBacklog!
+
 // reference
 const unsigned int C4NetReferenceUpdateInterval = 120; // (s)
 const unsigned int C4NetMinLeagueUpdateInterval = 1; // (s)
@@ -98,6 +102,38 @@ public:
 	void CompileFunc(StdCompiler *pComp) override;
 };
 
+// Packs a runtime join dynamic and adds it to the resource list, so the game
+// does not have to stop for compression and checksums while a client joins.
+class C4Network2DynamicSnapshot : public StdThread
+{
+public:
+	C4Network2DynamicSnapshot(C4Group *pGroup, const char *szFilename, C4Network2ResList &ResList, int32_t iCtrlTick);
+	~C4Network2DynamicSnapshot() override;
+
+protected:
+	std::unique_ptr<C4Group> pGroup; // open save group, closed (packed) by the thread
+	StdCopyStrBuf Filename;
+	C4Network2ResList &ResList;
+	C4Network2Res::Ref pRes;
+	std::atomic<bool> fDone{false};
+
+	// state at the time of the snapshot
+	int32_t iCtrlTick;
+	C4GameParameters Parameters;
+
+public:
+	bool isDone() const { return fDone; }
+	C4Network2Res::Ref getRes() const { return pRes; } // after isDone(); nullptr on failure
+	int32_t getCtrlTick() const { return iCtrlTick; }
+	C4GameParameters &getParameters() { return Parameters; }
+
+	void Pack(); // close group and add resource; done by the thread unless it could not be started
+	void Cancel(); // wait for the thread and remove any resource added
+
+protected:
+	void Execute() override;
+};
+
 class C4Network2 : private C4ApplicationSec1Timer
 {
 	friend class C4Network2IO;
@@ -134,8 +170,14 @@ protected:
 
 	// resources
 	int32_t iDynamicTick{-1};
+	int32_t iDynamicMaxTick{-1}; // last tick at which the dynamic may be sent to joining clients
 	bool fDynamicNeeded{false};
 
+	// runtime join dynamic being packed in the background
+	std::unique_ptr<C4Network2DynamicSnapshot> pDynamicSnapshot;
+	C4GameParameters DynamicParameters; // game parameters at iDynamicTick of a dynamic published later
+	bool fDynamicSnapshotOutdated{false}; // last snapshot took too long: save the next one synchronously
+
 	// game status flags
 	bool fStatusAck{false}, fStatusReached{false};
 	bool fChasing{false};
@@ -338,6 +380,7 @@ protected:
 	// resource list
 	bool CreateDynamic(bool fInit);
 	void RemoveDynamic();
+	void CheckDynamicSnapshot();
 
 	// status changes
 	bool PauseGame(bool fAutoContinue);
@@ -278,15 +278,19 @@ void C4Command::MoveTo()
 				// Not too close
 				if (!(Inside(cx-Tx._getInt(),-PathRange,+PathRange) && Inside(cy-Ty,-PathRange,+PathRange)))
 				{
-					// Path not free: find path
+					// Path not free: find path at the end of the frame
 					if (!PathFree(cx,cy,Tx._getInt(),Ty))
 					{
-						Game.PathFinder.EnableTransferZones(!cObj->Def->NoTransferZones);
-						Game.PathFinder.SetLevel(cObj->Def->Pathfinder);
-						if (!Game.PathFinder.Find( cObj->GetX(),cObj->GetY(),
-						                           Tx._getInt(),Ty,
-												   ObjectAddWaypoint(cObj)))
-							{ /* Path not found: react? */ PathChecked=true; /* recheck delay */ }
+						Game.PathFinder.QueueFind(this, cx, cy, Tx._getInt(), Ty, cObj->Def->Pathfinder, !cObj->Def->NoTransferZones,
+							[this](bool fFound, const std::vector<C4PathFinder::Waypoint> &Path)
+							{
+								// Other command got in front meanwhile: find again when back
+								if (!cObj || cObj->Command != this) return;
+								if (!fFound) { /* Path not found: react? */ PathChecked=true; /* recheck delay */ return; }
+								ObjectAddWaypoint AddWaypoint(cObj);
+								for (const C4PathFinder::Waypoint &waypoint : Path)
+									AddWaypoint(waypoint.X, waypoint.Y, waypoint.TransferObject);
+							});
 						return;
 					}
 					// Path free: recheck delay
@@ -1456,6 +1460,7 @@ bool C4Command::InitEvaluation()
 
 void C4Command::Clear()
 {
+	Game.PathFinder.CancelQueries(this);
 	Command=C4CMD_None;
 	cObj=nullptr;
 	Evaluated=false;
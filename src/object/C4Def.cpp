@@ -26,10 +26,12 @@
 #include "graphics/C4DrawGL.h"
 #include "graphics/C4GraphicsResource.h"
 #include "graphics/CSurface8.h"
+#include "graphics/StdPNG.h"
 #include "landscape/C4Particles.h"
 #include "landscape/C4SolidMask.h"
 #include "lib/StdColors.h"
 #include "lib/StdMeshLoader.h"
+#include "object/C4DefCache.h"
 #include "object/C4Object.h"
 #include "platform/C4FileMonitor.h"
 #include "platform/C4SoundSystem.h"
@@ -46,9 +48,10 @@ public:
 	{
 		if (!Group.AccessEntry(filename)) return nullptr;
 		C4Surface* surface = new C4Surface;
+		std::unique_ptr<CPNGFile> png = ::DecodedImages.Take(Group, filename);
 		// Suppress error message here, StdMeshMaterial loader
 		// will show one.
-		if (!surface->Read(Group, GetExtension(filename), C4SF_MipMap))
+		if (png ? !surface->ReadPNG(*png, C4SF_MipMap) : !surface->Read(Group, GetExtension(filename), C4SF_MipMap))
 			{ delete surface; surface = nullptr; }
 		return surface;
 	}
@@ -143,9 +146,14 @@ bool C4Def::LoadDefCore(C4Group &hGroup)
 	StdStrBuf Source;
 	if (hGroup.LoadEntryString(C4CFN_DefCore,&Source))
 	{
-		StdStrBuf Name = hGroup.GetFullName() + (const StdStrBuf &)FormatString("%cDefCore.txt", DirectorySeparator);
-		if (!Compile(Source.getData(), Name.getData()))
-			return false;
+		// Parsed before? Then the binary form is all that needs to be read
+		if (!::DefCache.LoadDefCore(*this, Source))
+		{
+			StdStrBuf Name = hGroup.GetFullName() + (const StdStrBuf &)FormatString("%cDefCore.txt", DirectorySeparator);
+			if (!Compile(Source.getData(), Name.getData()))
+				return false;
+			::DefCache.SaveDefCore(*this, Source);
+		}
 		Source.Clear();
 
 		// Check mass
@@ -568,7 +576,8 @@ void C4Def::LoadRankFaces(C4Group &hGroup)
 	if (hGroup.AccessEntry(C4CFN_RankFacesPNG))
 	{
 		pRankSymbols = new C4FacetSurface();
-		if (!pRankSymbols->GetFace().ReadPNG(hGroup, false)) { delete pRankSymbols; pRankSymbols = nullptr; }
+		std::unique_ptr<CPNGFile> png = ::DecodedImages.Take(hGroup, C4CFN_RankFacesPNG);
+		if (png ? !pRankSymbols->GetFace().ReadPNG(*png, 0) : !pRankSymbols->GetFace().ReadPNG(hGroup, false)) { delete pRankSymbols; pRankSymbols = nullptr; }
 	}
 	// set size
 	if (pRankSymbols)
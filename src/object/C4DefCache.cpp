@@ -0,0 +1,148 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2016, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+// persistent cache of definition data that is costly to recreate from its source files
+
+#include "C4Include.h"
+#include "object/C4DefCache.h"
+
+#include "C4Version.h"
+#include "graphics/StdPNG.h"
+#include "object/C4Def.h"
+
+#include <random>
+#include <zlib.h>
+
+C4DefCache DefCache;
+
+namespace
+{
+	// header of a cached image, followed by its pixel rows
+	struct C4DefCacheImageHeader
+	{
+		char Id[4];
+		uint32_t Wdt, Hgt;
+		uint32_t Alpha;
+	};
+	const char C4DefCacheImageId[4] = { 'O', 'C', 'D', 'I' };
+}
+
+void C4DefCache::Init()
+{
+	Folder.Clear();
+	if (!Config.General.DefCache) return;
+	// one folder per engine build
+	const char *szBuild = C4VERSION " " C4_OS " " C4REVISION " " C4REVISION_TS C4BUILDOPT;
+	StdStrBuf BuildFolder = FormatString("DefCache%c%08x", DirectorySeparator, (unsigned int) crc32(0, reinterpret_cast<const Bytef *>(szBuild), SLen(szBuild)));
+	StdCopyStrBuf Path(Config.AtUserDataPath(BuildFolder.getData()));
+	if (!CreatePath(Path.getData()))
+	{
+		LogF("WARNING: Cannot create definition cache folder %s", Path.getData());
+		return;
+	}
+	Folder.Take(Path);
+}
+
+StdStrBuf C4DefCache::GetEntryFilename(const char *szKind, const void *pSource, size_t iSourceSize) const
+{
+	uint32_t iCRC = crc32(0, static_cast<const Bytef *>(pSource), iSourceSize);
+	return FormatString("%s%c%s-%08x-%lu", Folder.getData(), DirectorySeparator, szKind, (unsigned int) iCRC, (unsigned long) iSourceSize);
+}
+
+bool C4DefCache::SaveEntry(const char *szFilename, const StdBuf &Data) const
+{
+	// Write to a temporary file first, so no other process ever sees a partial entry
+	StdStrBuf TempFilename = FormatString("%s.%08x", szFilename, (unsigned int) std::random_device()());
+	if (!Data.SaveToFile(TempFilename.getData())) return false;
+	if (!RenameFile(TempFilename.getData(), szFilename))
+	{
+		// someone else was faster?
+		EraseFile(TempFilename.getData());
+		return false;
+	}
+	return true;
+}
+
+bool C4DefCache::LoadDefCore(C4Def &Def, const StdStrBuf &Source) const
+{
+	if (!IsEnabled()) return false;
+	StdBuf Data;
+	if (!Data.LoadFromFile(GetEntryFilename("DefCore", Source.getData(), Source.getLength()).getData())) return false;
+	try
+	{
+		CompileFromBuf<StdCompilerBinRead>(mkNamingAdapt(Def, "DefCore"), Data);
+	}
+	catch (StdCompiler::Exception *pExc)
+	{
+		// broken entry: parse the source again
+		delete pExc;
+		return false;
+	}
+	return true;
+}
+
+void C4DefCache::SaveDefCore(C4Def &Def, const StdStrBuf &Source) const
+{
+	if (!IsEnabled()) return;
+	StdBuf Data;
+	try
+	{
+		Data = DecompileToBuf<StdCompilerBinWrite>(mkNamingAdapt(Def, "DefCore"));
+	}
+	catch (StdCompiler::Exception *pExc)
+	{
+		delete pExc;
+		return;
+	}
+	SaveEntry(GetEntryFilename("DefCore", Source.getData(), Source.getLength()).getData(), Data);
+}
+
+std::unique_ptr<CPNGFile> C4DefCache::LoadImage(const void *pSource, size_t iSourceSize) const
+{
+	if (!IsEnabled()) return nullptr;
+	std::shared_ptr<CStdFileMapping> Mapping = CStdFileMapping::Open(GetEntryFilename("Image", pSource, iSourceSize).getData());
+	if (!Mapping || Mapping->getSize() < sizeof(C4DefCacheImageHeader)) return nullptr;
+	C4DefCacheImageHeader Header;
+	memcpy(&Header, Mapping->getData(), sizeof(Header));
+	if (memcmp(Header.Id, C4DefCacheImageId, sizeof(Header.Id))) return nullptr;
+	std::unique_ptr<CPNGFile> png(new CPNGFile);
+	if (!png->Create(Header.Wdt, Header.Hgt, !!Header.Alpha)) return nullptr;
+	size_t iImageSize = size_t(Header.Wdt) * Header.Hgt * (Header.Alpha ? 4 : 3);
+	if (Mapping->getSize() != sizeof(Header) + iImageSize) return nullptr;
+	memcpy(png->GetImageData(), Mapping->getData() + sizeof(Header), iImageSize);
+	return png;
+}
+
+void C4DefCache::SaveImage(const void *pSource, size_t iSourceSize, CPNGFile &png) const
+{
+	if (!IsEnabled()) return;
+	// only the formats the loader converts everything to
+	bool fAlpha;
+	switch (png.iClrType)
+	{
+	case PNG_COLOR_TYPE_RGB: fAlpha = false; break;
+	case PNG_COLOR_TYPE_RGB_ALPHA: fAlpha = true; break;
+	default: return;
+	}
+	C4DefCacheImageHeader Header;
+	memcpy(Header.Id, C4DefCacheImageId, sizeof(Header.Id));
+	Header.Wdt = png.iWdt; Header.Hgt = png.iHgt;
+	Header.Alpha = fAlpha;
+	size_t iImageSize = size_t(Header.Wdt) * Header.Hgt * (Header.Alpha ? 4 : 3);
+	StdBuf Data;
+	Data.New(sizeof(Header) + iImageSize);
+	Data.Write(&Header, sizeof(Header));
+	Data.Write(png.GetImageData(), iImageSize, sizeof(Header));
+	SaveEntry(GetEntryFilename("Image", pSource, iSourceSize).getData(), Data);
+}
@@ -0,0 +1,50 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2016, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+// persistent cache of definition data that is costly to recreate from its source files
+
+#ifndef INC_C4DefCache
+#define INC_C4DefCache
+
+class C4Def;
+class CPNGFile;
+
+// Cache entries are named after CRC and size of the source file they were created from,
+// so they do not need to be invalidated when definitions change. Each engine build uses
+// its own folder, because the stored formats may differ between builds.
+// Enabled by Config.General.DefCache, which dedicated servers restarting often profit from.
+class C4DefCache
+{
+private:
+	StdCopyStrBuf Folder; // empty if disabled
+
+	StdStrBuf GetEntryFilename(const char *szKind, const void *pSource, size_t iSourceSize) const;
+	bool SaveEntry(const char *szFilename, const StdBuf &Data) const;
+
+public:
+	void Init(); // determine folder from config; call before loading definitions
+	bool IsEnabled() const { return !!Folder.getLength(); }
+
+	// parsed DefCore.txt
+	bool LoadDefCore(C4Def &Def, const StdStrBuf &Source) const;
+	void SaveDefCore(C4Def &Def, const StdStrBuf &Source) const;
+
+	// decoded PNG images; may be called from any thread
+	std::unique_ptr<CPNGFile> LoadImage(const void *pSource, size_t iSourceSize) const;
+	void SaveImage(const void *pSource, size_t iSourceSize, CPNGFile &png) const;
+};
+
+extern C4DefCache DefCache;
+
+#endif
@@ -161,17 +161,19 @@ bool C4DefGraphics::LoadMesh(C4Group &hGroup, const char* szFileName, StdMeshSke
 
 	try
 	{
-		if(!hGroup.LoadEntry(szFileName, &buf, &size, 1)) return false;
-
 		if (SEqualNoCase(GetExtension(szFileName), "xml"))
 		{
+			if(!hGroup.LoadEntry(szFileName, &buf, &size, 1)) return false;
 			Mesh = StdMeshLoader::LoadMeshXml(buf, size, ::MeshMaterialManager, loader, hGroup.GetName());
+			delete[] buf;
 		}
 		else
 		{
-			Mesh = StdMeshLoader::LoadMeshBinary(buf, size, ::MeshMaterialManager, loader, hGroup.GetName());
+			// binary meshes need no terminator and can be read from the group file directly
+			C4GroupEntryView view;
+			if (!hGroup.LoadEntryView(szFileName, &view)) return false;
+			Mesh = StdMeshLoader::LoadMeshBinary(static_cast<const char *>(view.getData()), view.getSize(), ::MeshMaterialManager, loader, hGroup.GetName());
 		}
-		delete[] buf;
 
 		Mesh->SetLabel(pDef->id.ToString());
 
@@ -196,19 +198,21 @@ bool C4DefGraphics::LoadSkeleton(C4Group &hGroup, const char* szFileName, StdMes
 
 	try
 	{
-		if (!hGroup.LoadEntry(szFileName, &buf, &size, 1)) return false;
+		bool fXml = SEqualNoCase(GetExtension(szFileName), "xml");
+		C4GroupEntryView view;
+		if (fXml ? !hGroup.LoadEntry(szFileName, &buf, &size, 1) : !hGroup.LoadEntryView(szFileName, &view)) return false;
 
 		// delete skeleton from the map for reloading, or else if you delete or rename
 		// a skeleton file in the folder the old skeleton will still exist in the map
 		loader.RemoveSkeleton(hGroup.GetName(), szFileName);
 
-		if (SEqualNoCase(GetExtension(szFileName), "xml"))
+		if (fXml)
 		{
 			loader.LoadSkeletonXml(hGroup.GetName(), szFileName, buf, size);
 		}
 		else
 		{
-			loader.LoadSkeletonBinary(hGroup.GetName(), szFileName, buf, size);
+			loader.LoadSkeletonBinary(hGroup.GetName(), szFileName, static_cast<const char *>(view.getData()), view.getSize());
 		}
 
 		delete[] buf;
@@ -387,8 +391,14 @@ void C4DefGraphics::DrawClr(C4Facet &cgo, bool fAspect, DWORD dwClr)
 void C4DefGraphicsAdapt::CompileFunc(StdCompiler *pComp)
 {
 	bool deserializing = pComp->isDeserializer();
-	// nothing?
-	if (!deserializing && !pDefGraphics) return;
+	// nothing? Binary compilers cannot detect the omitted value, so it is flagged
+	if (!pComp->hasNaming())
+	{
+		bool fNull = !pDefGraphics;
+		pComp->Value(fNull);
+		if (fNull) { pDefGraphics = nullptr; return; }
+	}
+	else if (!deserializing && !pDefGraphics) return;
 	// definition
 	C4ID id; if (!deserializing) id = pDefGraphics->pDef->id;
 	pComp->Value(id);
@@ -1125,6 +1135,12 @@ void C4GraphicsOverlayListAdapt::CompileFunc(StdCompiler *pComp)
 		bool fContinue;
 		do
 		{
+			// binary: every overlay is announced, so empty lists can be told apart
+			if (!fNaming)
+			{
+				pComp->Value(fContinue);
+				if (!fContinue) return;
+			}
 			C4GraphicsOverlay *pNext = new C4GraphicsOverlay();
 			try
 			{
@@ -1151,8 +1167,6 @@ void C4GraphicsOverlayListAdapt::CompileFunc(StdCompiler *pComp)
 			// continue?
 			if (fNaming)
 				fContinue = pComp->Separator(StdCompiler::SEP_SEP2) || pComp->Separator(StdCompiler::SEP_SEP);
-			else
-				pComp->Value(fContinue);
 		}
 		while (fContinue);
 	}
@@ -1163,13 +1177,10 @@ void C4GraphicsOverlayListAdapt::CompileFunc(StdCompiler *pComp)
 		for (C4GraphicsOverlay *pPos = pOverlay; pPos; pPos = pPos->GetNext())
 		{
 			// separate
-			if (pPos != pOverlay)
-			{
-				if (fNaming)
-					pComp->Separator(StdCompiler::SEP_SEP2);
-				else
-					pComp->Value(fContinue);
-			}
+			if (!fNaming)
+				pComp->Value(fContinue);
+			else if (pPos != pOverlay)
+				pComp->Separator(StdCompiler::SEP_SEP2);
 			// write
 			pComp->Value(*pPos);
 		}
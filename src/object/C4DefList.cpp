@@ -24,9 +24,14 @@
 #include "control/C4Record.h"
 #include "game/C4GameScript.h"
 #include "game/C4GameVersion.h"
+#include "graphics/StdPNG.h"
 #include "lib/StdMeshLoader.h"
 #include "object/C4Def.h"
+#include "object/C4DefCache.h"
 #include "platform/C4FileMonitor.h"
+#include "platform/StdScheduler.h"
+
+#include <thread>
 
 namespace
 {
@@ -58,6 +63,95 @@ namespace
 	};
 }
 
+namespace
+{
+	// Images of all definitions in a group, to be decoded in parallel by C4DefList::PreloadImages
+	class C4DefImageQueue
+	{
+		struct Job
+		{
+			std::string EntryName; // full name as used by C4DecodedImageCache
+			C4GroupEntryView Data;
+		};
+		std::vector<std::unique_ptr<Job>> Jobs;
+		size_t NextJob{0};
+		CStdCSec JobsCSec;
+
+	public:
+		void Collect(C4Group &hGroup)
+		{
+			char szEntryname[_MAX_FNAME+1];
+			// same groups as visited by C4DefList::Load
+			if (SEqualNoCase(GetExtension(hGroup.GetName()), "ocd"))
+			{
+				// entry names first, because loading resets the search
+				std::vector<std::string> entries;
+				hGroup.ResetSearch();
+				while (hGroup.FindNextEntry("*.png", szEntryname))
+					entries.emplace_back(szEntryname);
+				StdStrBuf group_name = hGroup.GetFullName();
+				for (const std::string &entry : entries)
+				{
+					std::unique_ptr<Job> job(new Job);
+					job->EntryName = FormatString("%s%c%s", group_name.getData(), DirectorySeparator, entry.c_str()).getData();
+					if (hGroup.LoadEntryView(entry.c_str(), &job->Data))
+						Jobs.push_back(std::move(job));
+				}
+			}
+			// sub definitions
+			C4Group hChild;
+			hGroup.ResetSearch();
+			while (hGroup.FindNextEntry(C4CFN_DefFiles, szEntryname))
+				if (hChild.OpenAsChild(&hGroup, szEntryname))
+				{
+					Collect(hChild);
+					hChild.Close();
+				}
+		}
+
+		bool IsEmpty() const { return Jobs.empty(); }
+
+		// decode one image into ::DecodedImages. Returns false if there was none left.
+		bool DecodeNext()
+		{
+			Job *job;
+			{
+				CStdLock JobsLock(&JobsCSec);
+				if (NextJob >= Jobs.size()) return false;
+				job = Jobs[NextJob++].get();
+			}
+			// Broken images are left to the regular loader, which will complain about them
+			std::unique_ptr<CPNGFile> png = ::DefCache.LoadImage(job->Data.getData(), job->Data.getSize());
+			if (!png)
+			{
+				png.reset(new CPNGFile);
+				if (!png->Load(static_cast<const BYTE *>(job->Data.getData()), job->Data.getSize())) png.reset();
+				else ::DefCache.SaveImage(job->Data.getData(), job->Data.getSize(), *png);
+			}
+			if (png)
+				::DecodedImages.Add(job->EntryName.c_str(), job->Data.getSize(), std::move(png));
+			job->Data.Clear();
+			return true;
+		}
+	};
+
+	class C4DefImageDecoder : public StdThread
+	{
+	private:
+		C4DefImageQueue &Queue;
+
+	public:
+		C4DefImageDecoder(C4DefImageQueue &Queue) : Queue(Queue) { }
+		~C4DefImageDecoder() override { Stop(); }
+
+	protected:
+		void Execute() override
+		{
+			if (!Queue.DecodeNext()) SignalStop();
+		}
+	};
+}
+
 C4DefList::C4DefList() : SkeletonLoader(new C4SkeletonManager)
 {
 	Default();
@@ -73,6 +167,47 @@ int32_t C4DefList::Load(C4Group &hGroup, DWORD dwLoadWhat,
                         C4SoundSystem *pSoundSystem,
                         bool fOverload,
                         bool fSearchMessage, int32_t iMinProgress, int32_t iMaxProgress, bool fLoadSysGroups)
+{
+	::DefCache.Init();
+	// Decoding images is the bulk of the work, so do that for all definitions on all cores first.
+	// Everything else stays in the serial pass, which picks up the decoded images.
+	bool fPreloaded = (dwLoadWhat & C4D_Load_Bitmap) && PreloadImages(hGroup);
+	int32_t iResult = LoadGroup(hGroup, dwLoadWhat, szLanguage, pSoundSystem, fOverload, fSearchMessage, iMinProgress, iMaxProgress, fLoadSysGroups);
+	// Images of skipped definitions etc.
+	if (fPreloaded) ::DecodedImages.Clear();
+	return iResult;
+}
+
+bool C4DefList::PreloadImages(C4Group &hGroup)
+{
+	// Nothing to gain on a single core, unless the images can be taken from the cache
+	unsigned int iThreads = std::thread::hardware_concurrency();
+	if (iThreads < 2 && !::DefCache.IsEnabled()) return false;
+	// Collect through a separate handle, so hGroup is left as it is
+	C4Group hPreloadGroup;
+	if (!hPreloadGroup.Open(hGroup.GetFullName().getData())) return false;
+	C4DefImageQueue Queue;
+	Queue.Collect(hPreloadGroup);
+	hPreloadGroup.Close();
+	if (Queue.IsEmpty()) return false;
+	// Decode on the main thread as well
+	std::vector<std::unique_ptr<C4DefImageDecoder>> Decoders;
+	for (unsigned int i = 1; i < iThreads; ++i)
+	{
+		Decoders.emplace_back(new C4DefImageDecoder(Queue));
+		if (!Decoders.back()->Start()) { Decoders.pop_back(); break; }
+	}
+	while (Queue.DecodeNext()) {}
+	// Wait for the last images still being decoded
+	Decoders.clear();
+	return true;
+}
+
+int32_t C4DefList::LoadGroup(C4Group &hGroup, DWORD dwLoadWhat,
+                             const char *szLanguage,
+                             C4SoundSystem *pSoundSystem,
+                             bool fOverload,
+                             bool fSearchMessage, int32_t iMinProgress, int32_t iMaxProgress, bool fLoadSysGroups)
 {
 	int32_t iResult=0;
 	C4Def *nDef = nullptr;
@@ -135,7 +270,7 @@ int32_t C4DefList::Load(C4Group &hGroup, DWORD dwLoadWhat,
 			int iSubMinProgress = std::min(iMaxProgress, iMinProgress + ((iMaxProgress - iMinProgress) * i) / 16);
 			int iSubMaxProgress = std::min(iMaxProgress, iMinProgress + ((iMaxProgress - iMinProgress) * (i + 1)) / 16);
 			++i;
-			iResult += Load(hChild,dwLoadWhat,szLanguage,pSoundSystem,fOverload,fSearchMessage,iSubMinProgress,iSubMaxProgress);
+			iResult += LoadGroup(hChild,dwLoadWhat,szLanguage,pSoundSystem,fOverload,fSearchMessage,iSubMinProgress,iSubMaxProgress,true);
 			hChild.Close();
 		}
 
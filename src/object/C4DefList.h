@@ -77,6 +77,13 @@ public:
 	float GetFontImageAspect(const char* szImageTag) override;
 private:
 	std::unique_ptr<StdMeshSkeletonLoader> SkeletonLoader;
+
+	int32_t LoadGroup(C4Group &hGroup,
+	                  DWORD dwLoadWhat, const char *szLanguage,
+	                  C4SoundSystem *pSoundSystem,
+	                  bool fOverload,
+	                  bool fSearchMessage, int32_t iMinProgress, int32_t iMaxProgress, bool fLoadSysGroups);
+	bool PreloadImages(C4Group &hGroup); // decode images of all definitions in hGroup into ::DecodedImages
 };
 
 extern C4DefList Definitions;
@@ -251,6 +251,37 @@ C4FindObject *C4FindObject::CreateByValue(const C4Value &DataVal, C4SortObject *
 }
 
 int32_t C4FindObject::Count(const C4ObjectList &Objs)
+{
+	return CountIn(Objs);
+}
+
+C4Object *C4FindObject::Find(const C4ObjectList &Objs)
+{
+	return FindIn(Objs);
+}
+
+C4ValueArray *C4FindObject::FindMany(const C4ObjectList &Objs)
+{
+	return FindManyIn(Objs);
+}
+
+int32_t C4FindObject::Count(const C4LSectorList &Objs)
+{
+	return CountIn(Objs);
+}
+
+C4Object *C4FindObject::Find(const C4LSectorList &Objs)
+{
+	return FindIn(Objs);
+}
+
+C4ValueArray *C4FindObject::FindMany(const C4LSectorList &Objs)
+{
+	return FindManyIn(Objs);
+}
+
+template <class List>
+int32_t C4FindObject::CountIn(const List &Objs)
 {
 	// Trivial cases
 	if (IsImpossible())
@@ -265,7 +296,8 @@ int32_t C4FindObject::Count(const C4ObjectList &Objs)
 	return iCount;
 }
 
-C4Object *C4FindObject::Find(const C4ObjectList &Objs)
+template <class List>
+C4Object *C4FindObject::FindIn(const List &Objs)
 {
 	// Trivial case
 	if (IsImpossible())
@@ -289,7 +321,8 @@ C4Object *C4FindObject::Find(const C4ObjectList &Objs)
 }
 
 // return is to be freed by the caller
-C4ValueArray *C4FindObject::FindMany(const C4ObjectList &Objs)
+template <class List>
+C4ValueArray *C4FindObject::FindManyIn(const List &Objs)
 {
 	// Trivial case
 	if (IsImpossible())
@@ -317,6 +350,26 @@ C4ValueArray *C4FindObject::FindMany(const C4ObjectList &Objs)
 	return pArray;
 }
 
+const C4LSectorList *C4FindObject::GetIndex(const C4ObjectList &Objs)
+{
+	// indices mirror the main object list only
+	if (&Objs != &::Objects) return nullptr;
+	return GetIndex();
+}
+
+int32_t C4FindObject::GetAreaSize(const C4Rect &Bounds, bool fShapes)
+{
+	C4LArea Area(&::Objects.Sectors, Bounds); C4LSector *pSct;
+	int32_t iSize = 0;
+	if (fShapes)
+		for (C4LSectorList *pLst=Area.FirstObjectShapes(&pSct); pLst; pLst=Area.NextObjectShapes(pLst, &pSct))
+			iSize += pLst->GetSize();
+	else
+		for (C4LSectorList *pLst=Area.FirstObjects(&pSct); pLst; pLst=Area.NextObjects(pLst, &pSct))
+			iSize += pLst->GetSize();
+	return iSize;
+}
+
 int32_t C4FindObject::Count(const C4ObjectList &Objs, const C4LSectors &Sct)
 {
 	// Trivial cases
@@ -326,13 +379,17 @@ int32_t C4FindObject::Count(const C4ObjectList &Objs, const C4LSectors &Sct)
 		return Objs.ObjectCount();
 	// Check bounds
 	C4Rect *pBounds = GetBounds();
+	const C4LSectorList *pIndex = GetIndex(Objs);
 	if (!pBounds)
-		return Count(Objs);
-	else if (UseShapes())
+		return pIndex ? Count(*pIndex) : Count(Objs);
+	// Counting doesn't depend on the order, so check the index if it is smaller than the area
+	if (pIndex && pIndex->GetSize() < GetAreaSize(*pBounds, UseShapes()))
+		return Count(*pIndex);
+	if (UseShapes())
 	{
 		// Get area
 		C4LArea Area(&::Objects.Sectors, *pBounds); C4LSector *pSct;
-		C4ObjectList *pLst = Area.FirstObjectShapes(&pSct);
+		C4LSectorList *pLst = Area.FirstObjectShapes(&pSct);
 		// Check if a single-sector check is enough
 		if (!Area.Next(pSct))
 			return Count(pSct->ObjectShapes);
@@ -340,7 +397,7 @@ int32_t C4FindObject::Count(const C4ObjectList &Objs, const C4LSectors &Sct)
 		uint32_t iMarker = ::Objects.GetNextMarker();
 		int32_t iCount = 0;
 		for (; pLst; pLst=Area.NextObjectShapes(pLst, &pSct))
-			for (C4Object *obj : Objs)
+			for (C4Object *obj : *pLst)
 				if (obj->Status)
 					if (obj->Marker != iMarker)
 					{
@@ -355,7 +412,7 @@ int32_t C4FindObject::Count(const C4ObjectList &Objs, const C4LSectors &Sct)
 		// Count objects per area
 		C4LArea Area(&::Objects.Sectors, *pBounds); C4LSector *pSct;
 		int32_t iCount = 0;
-		for (C4ObjectList *pLst=Area.FirstObjects(&pSct); pLst; pLst=Area.NextObjects(pLst, &pSct))
+		for (C4LSectorList *pLst=Area.FirstObjects(&pSct); pLst; pLst=Area.NextObjects(pLst, &pSct))
 			iCount += Count(*pLst);
 		return iCount;
 	}
@@ -370,13 +427,16 @@ C4Object *C4FindObject::Find(const C4ObjectList &Objs, const C4LSectors &Sct)
 	// Check bounds
 	C4Rect *pBounds = GetBounds();
 	if (!pBounds)
-		return Find(Objs);
+	{
+		const C4LSectorList *pIndex = GetIndex(Objs);
+		return pIndex ? Find(*pIndex) : Find(Objs);
+	}
 	// Traverse areas, return first matching object w/o sort or best with sort
 	else if (UseShapes())
 	{
 		C4LArea Area(&::Objects.Sectors, *pBounds); C4LSector *pSct;
 		C4Object *pObj;
-		for (C4ObjectList *pLst=Area.FirstObjectShapes(&pSct); pLst; pLst=Area.NextObjectShapes(pLst, &pSct))
+		for (C4LSectorList *pLst=Area.FirstObjectShapes(&pSct); pLst; pLst=Area.NextObjectShapes(pLst, &pSct))
 			if ((pObj = Find(*pLst)))
 			{
 				if (!pSort)
@@ -390,7 +450,7 @@ C4Object *C4FindObject::Find(const C4ObjectList &Objs, const C4LSectors &Sct)
 	{
 		C4LArea Area(&::Objects.Sectors, *pBounds); C4LSector *pSct;
 		C4Object *pObj;
-		for (C4ObjectList *pLst=Area.FirstObjects(&pSct); pLst; pLst=Area.NextObjects(pLst, &pSct))
+		for (C4LSectorList *pLst=Area.FirstObjects(&pSct); pLst; pLst=Area.NextObjects(pLst, &pSct))
 		{
 			if ((pObj = Find(*pLst)))
 			{
@@ -413,7 +473,10 @@ C4ValueArray *C4FindObject::FindMany(const C4ObjectList &Objs, const C4LSectors
 		return new C4ValueArray();
 	C4Rect *pBounds = GetBounds();
 	if (!pBounds)
-		return FindMany(Objs);
+	{
+		const C4LSectorList *pIndex = GetIndex(Objs);
+		return pIndex ? FindMany(*pIndex) : FindMany(Objs);
+	}
 	// Prepare for array that may be generated
 	C4ValueArray *pArray; int32_t iSize;
 	// Check shape lists?
@@ -421,7 +484,7 @@ C4ValueArray *C4FindObject::FindMany(const C4ObjectList &Objs, const C4LSectors
 	{
 		// Get area
 		C4LArea Area(&::Objects.Sectors, *pBounds); C4LSector *pSct;
-		C4ObjectList *pLst = Area.FirstObjectShapes(&pSct);
+		C4LSectorList *pLst = Area.FirstObjectShapes(&pSct);
 		// Check if a single-sector check is enough
 		if (!Area.Next(pSct))
 			return FindMany(pSct->ObjectShapes);
@@ -451,7 +514,7 @@ C4ValueArray *C4FindObject::FindMany(const C4ObjectList &Objs, const C4LSectors
 		pArray = new C4ValueArray(32); iSize = 0;
 		// Search
 		C4LArea Area(&::Objects.Sectors, *pBounds); C4LSector *pSct;
-		for (C4ObjectList *pLst=Area.FirstObjects(&pSct); pLst; pLst=Area.NextObjects(pLst, &pSct))
+		for (C4LSectorList *pLst=Area.FirstObjects(&pSct); pLst; pLst=Area.NextObjects(pLst, &pSct))
 			for (C4Object *obj : *pLst)
 				if (obj->Status)
 					if (Check(obj))
@@ -495,6 +558,14 @@ void C4FindObject::SetSort(C4SortObject *pToSort)
 	pSort = pToSort;
 }
 
+void C4FindObject::SortByCost(C4FindObject **ppConds, int32_t iCnt)
+{
+	// Conditions without side effects don't depend on the order, so the cheap
+	// ones can be checked first. Script calls keep their relative order.
+	std::stable_sort(ppConds, ppConds + iCnt,
+		[](C4FindObject *a, C4FindObject *b) { return a->GetCost() < b->GetCost(); });
+}
+
 
 // *** C4FindObjectNot
 
@@ -545,6 +616,9 @@ C4FindObjectAnd::C4FindObjectAnd(int32_t inCnt, C4FindObject **ppConds, bool fFr
 			// the objects will be filtered out later
 		}
 	}
+	// Check order does not matter for the bounds anymore
+	SortByCost(ppConds, iCnt);
+	Cost = iCnt ? ppConds[iCnt - 1]->GetCost() : C4FOC_Field;
 }
 
 C4FindObjectAnd::~C4FindObjectAnd()
@@ -571,6 +645,19 @@ bool C4FindObjectAnd::IsImpossible()
 	return false;
 }
 
+const C4LSectorList *C4FindObjectAnd::GetIndex()
+{
+	// all conditions must hold, so the smallest index of any condition will do
+	const C4LSectorList *pBest = nullptr;
+	for (int32_t i = 0; i < iCnt; i++)
+	{
+		const C4LSectorList *pIndex = ppConds[i]->GetIndex();
+		if (pIndex && (!pBest || pIndex->GetSize() < pBest->GetSize()))
+			pBest = pIndex;
+	}
+	return pBest;
+}
+
 // *** C4FindObjectOr
 
 C4FindObjectOr::C4FindObjectOr(int32_t inCnt, C4FindObject **ppConds)
@@ -606,6 +693,9 @@ C4FindObjectOr::C4FindObjectOr(int32_t inCnt, C4FindObject **ppConds)
 			fHasBounds = true;
 		}
 	}
+	// Check order does not matter for the bounds anymore
+	SortByCost(ppConds, iCnt);
+	Cost = iCnt ? ppConds[iCnt - 1]->GetCost() : C4FOC_Field;
 }
 
 C4FindObjectOr::~C4FindObjectOr()
@@ -648,6 +738,11 @@ bool C4FindObjectDef::IsImpossible()
 	return !def || !def->GetDef() || !def->GetDef()->Count;
 }
 
+const C4LSectorList *C4FindObjectDef::GetIndex()
+{
+	return &::Objects.ObjectsByPrototype(def);
+}
+
 bool C4FindObjectInRect::Check(C4Object *pObj)
 {
 	return rect.Contains(pObj->GetX(), pObj->GetY());
@@ -710,6 +805,16 @@ bool C4FindObjectCategory::IsEnsured()
 	return !iCategory;
 }
 
+const C4LSectorList *C4FindObjectCategory::GetIndex()
+{
+	// any of several categories may match, so only single categories are indexed
+	uint32_t dwCategory = iCategory;
+	if (!dwCategory || (dwCategory & (dwCategory - 1))) return nullptr;
+	int32_t iBit = 0;
+	while (!(dwCategory & (uint32_t(1) << iBit))) ++iBit;
+	return &::Objects.ObjectsByCategory(iBit);
+}
+
 bool C4FindObjectAction::Check(C4Object *pObj)
 {
 	assert(pObj);
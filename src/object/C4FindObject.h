@@ -65,6 +65,15 @@ enum C4SortObjectCondID
 	C4SO_Last         = 50  // no sort condition larger than this
 };
 
+// Relative cost of C4FindObject::Check. And/Or check cheaper conditions first.
+enum C4FindObjectCost
+{
+	C4FOC_Field    = 0, // compares object fields
+	C4FOC_Geometry = 1, // position or shape test
+	C4FOC_Lookup   = 2, // property, action or array lookup
+	C4FOC_Script   = 3  // script call
+};
+
 // Base class
 class C4FindObject
 {
@@ -83,6 +92,10 @@ public:
 	C4Object *Find(const C4ObjectList &Objs); // Returns first object for which the condition is true
 	C4ValueArray *FindMany(const C4ObjectList &Objs); // Returns all objects for which the condition is true
 
+	int32_t Count(const C4LSectorList &Objs); // Same for single sector lists
+	C4Object *Find(const C4LSectorList &Objs);
+	C4ValueArray *FindMany(const C4LSectorList &Objs);
+
 	int32_t Count(const C4ObjectList &Objs, const C4LSectors &Sct); // Counts objects for which the condition is true
 	C4Object *Find(const C4ObjectList &Objs, const C4LSectors &Sct);  // Returns first object for which the condition is true
 	C4ValueArray *FindMany(const C4ObjectList &Objs, const C4LSectors &Sct); // Returns all objects for which the condition is true
@@ -96,9 +109,19 @@ protected:
 	virtual bool UseShapes() { return false; }
 	virtual bool IsImpossible() { return false; }
 	virtual bool IsEnsured() { return false; }
+	virtual C4FindObjectCost GetCost() { return C4FOC_Field; }
+	virtual const C4LSectorList *GetIndex() { return nullptr; } // main list objects that may match, in main list order
+
+	static void SortByCost(C4FindObject **ppConds, int32_t iCnt);
 
 private:
 	void CheckObjectStatus(C4ValueArray *pArray);
+	const C4LSectorList *GetIndex(const C4ObjectList &Objs);
+	int32_t GetAreaSize(const C4Rect &Bounds, bool fShapes);
+
+	template <class List> int32_t CountIn(const List &Objs);
+	template <class List> C4Object *FindIn(const List &Objs);
+	template <class List> C4ValueArray *FindManyIn(const List &Objs);
 };
 
 // Combinators
@@ -114,6 +137,7 @@ protected:
 	bool Check(C4Object *pObj) override;
 	bool IsImpossible() override { return pCond->IsEnsured(); }
 	bool IsEnsured() override { return pCond->IsImpossible(); }
+	C4FindObjectCost GetCost() override { return pCond->GetCost(); }
 };
 
 class C4FindObjectAnd : public C4FindObject
@@ -125,12 +149,15 @@ private:
 	int32_t iCnt;
 	C4FindObject **ppConds; bool fFreeArray; bool fUseShapes;
 	C4Rect Bounds; bool fHasBounds;
+	C4FindObjectCost Cost;
 protected:
 	bool Check(C4Object *pObj) override;
 	C4Rect *GetBounds() override { return fHasBounds ? &Bounds : nullptr; }
 	bool UseShapes() override { return fUseShapes; }
 	bool IsEnsured() override { return !iCnt; }
 	bool IsImpossible() override;
+	C4FindObjectCost GetCost() override { return Cost; }
+	const C4LSectorList *GetIndex() override;
 	void ForgetConditions() { ppConds=nullptr; iCnt=0; }
 };
 
@@ -152,12 +179,14 @@ private:
 	int32_t iCnt;
 	C4FindObject **ppConds; bool fUseShapes;
 	C4Rect Bounds; bool fHasBounds;
+	C4FindObjectCost Cost;
 protected:
 	bool Check(C4Object *pObj) override;
 	C4Rect *GetBounds() override { return fHasBounds ? &Bounds : nullptr; }
 	bool UseShapes() override { return fUseShapes; }
 	bool IsEnsured() override;
 	bool IsImpossible() override { return !iCnt; }
+	C4FindObjectCost GetCost() override { return Cost; }
 };
 
 // Primitive conditions
@@ -182,6 +211,7 @@ private:
 protected:
 	bool Check(C4Object *pObj) override;
 	bool IsImpossible() override;
+	const C4LSectorList *GetIndex() override;
 };
 
 class C4FindObjectInRect : public C4FindObject
@@ -193,6 +223,7 @@ private:
 	C4Rect rect;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCost GetCost() override { return C4FOC_Geometry; }
 	C4Rect *GetBounds() override { return &rect; }
 	bool IsImpossible() override;
 };
@@ -206,6 +237,7 @@ private:
 	C4Rect bounds;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCost GetCost() override { return C4FOC_Geometry; }
 	C4Rect *GetBounds() override { return &bounds; }
 	bool UseShapes() override { return true; }
 };
@@ -219,6 +251,7 @@ private:
 	C4Rect bounds;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCost GetCost() override { return C4FOC_Geometry; }
 	C4Rect *GetBounds() override { return &bounds; }
 	bool UseShapes() override { return true; }
 };
@@ -233,6 +266,7 @@ private:
 	C4Rect bounds;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCost GetCost() override { return C4FOC_Geometry; }
 	C4Rect *GetBounds() override { return &bounds; }
 	bool UseShapes() override { return true; }
 };
@@ -247,6 +281,7 @@ private:
 	C4Rect bounds;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCost GetCost() override { return C4FOC_Geometry; }
 	C4Rect *GetBounds() override { return &bounds; }
 };
 
@@ -260,6 +295,7 @@ private:
 	C4Rect bounds;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCost GetCost() override { return C4FOC_Geometry; }
 	C4Rect *GetBounds() override { return &bounds; }
 };
 
@@ -285,6 +321,7 @@ private:
 protected:
 	bool Check(C4Object *pObj) override;
 	bool IsEnsured() override;
+	const C4LSectorList *GetIndex() override;
 };
 
 class C4FindObjectAction : public C4FindObject
@@ -296,6 +333,7 @@ private:
 	const char *szAction;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCost GetCost() override { return C4FOC_Lookup; }
 };
 
 class C4FindObjectActionTarget : public C4FindObject
@@ -308,6 +346,7 @@ private:
 	int index;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCost GetCost() override { return C4FOC_Lookup; }
 };
 
 class C4FindObjectProcedure : public C4FindObject
@@ -319,6 +358,7 @@ private:
 	C4String * procedure;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCost GetCost() override { return C4FOC_Lookup; }
 	bool IsImpossible() override;
 };
 
@@ -375,6 +415,7 @@ private:
 	C4AulParSet Pars;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCost GetCost() override { return C4FOC_Script; }
 	bool IsImpossible() override;
 };
 
@@ -386,6 +427,7 @@ private:
 	C4String * Name;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCost GetCost() override { return C4FOC_Lookup; }
 	bool IsImpossible() override;
 };
 
@@ -408,6 +450,7 @@ private:
 	C4ValueArray *pArray;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCost GetCost() override { return C4FOC_Lookup; }
 	bool IsImpossible() override;
 };
 
@@ -42,6 +42,7 @@ C4GameObjects::~C4GameObjects()
 void C4GameObjects::Default()
 {
 	Sectors.Clear();
+	ClearIndex();
 	LastUsedMarker = 0;
 	ForeObjects.Default();
 }
@@ -64,7 +65,7 @@ bool C4GameObjects::Add(C4Object *nObj)
 	if (!C4ObjectList::Add(nObj, C4ObjectList::stMain))
 		return false;
 	// add to sectors
-	Sectors.Add(nObj, this);
+	Sectors.Add(nObj);
 	return true;
 }
 
@@ -81,11 +82,92 @@ bool C4GameObjects::Remove(C4Object *pObj)
 	return C4ObjectList::Remove(pObj);
 }
 
-C4ObjectList &C4GameObjects::ObjectsAt(int ix, int iy)
+C4LSectorList &C4GameObjects::ObjectsAt(int ix, int iy)
 {
 	return Sectors.SectorAt(ix, iy)->ObjectShapes;
 }
 
+// Called before CrossCheck does anything that may change other objects
+static inline bool CrossCheckCall(bool &fChanged)
+{
+	fChanged = true;
+	return true;
+}
+
+bool C4GameObjects::CrossCheckPair(C4Object *obj1, C4Object *obj2, DWORD focf, DWORD tocf, uint32_t Marker, bool &fChanged)
+{
+	if ((obj2 != obj1) && obj2->Status && !obj2->Contained && (obj2->OCF & tocf) &&
+	    Inside<int32_t>(obj2->GetX() - (obj1->GetX() + obj1->Shape.x), 0, obj1->Shape.Wdt - 1) &&
+	    Inside<int32_t>(obj2->GetY() - (obj1->GetY() + obj1->Shape.y), 0, obj1->Shape.Hgt - 1) &&
+	    obj1->Layer == obj2->Layer)
+	{
+		// handle collision only once
+		if (obj2->Marker == Marker) return true;
+		obj2->Marker = Marker;
+		// Only hit if target is alive and projectile is an object
+		if ((obj1->OCF & OCF_Alive) && (obj2->Category & C4D_Object))
+		{
+			C4Real dXDir = obj2->xdir - obj1->xdir, dYDir = obj2->ydir - obj1->ydir;
+			C4Real speed = dXDir * dXDir + dYDir * dYDir;
+			// Only hit if obj2's speed and relative speeds are larger than HitSpeed2
+			if ((obj2->OCF & OCF_HitSpeed2) && speed > HitSpeed2 && CrossCheckCall(fChanged) &&
+			   !obj1->Call(PSF_QueryCatchBlow, &C4AulParSet(obj2)))
+			{
+				int32_t iHitEnergy = fixtoi(speed * obj2->Mass / 5);
+				// Hit energy reduced to 1/3rd, but do not drop to zero because of this division
+				iHitEnergy = std::max<int32_t>(iHitEnergy/3, !!iHitEnergy);
+				obj1->DoEnergy(-iHitEnergy / 5, false, C4FxCall_EngObjHit, obj2->Controller);
+				int tmass = std::max<int32_t>(obj1->Mass, 50);
+				C4PropList* pActionDef = obj1->GetAction();
+				if (!::Game.iTick3 || (pActionDef && pActionDef->GetPropertyP(P_Procedure) != DFA_FLIGHT))
+					obj1->Fling(obj2->xdir * 50 / tmass, -Abs(obj2->ydir / 2) * 50 / tmass, false);
+				obj1->Call(PSF_CatchBlow, &C4AulParSet(-iHitEnergy / 5, obj2));
+				// obj1 might have been tampered with
+				return obj1->Status && !obj1->Contained && (obj1->OCF & focf);
+			}
+		}
+		// Collection
+		if ((obj1->OCF & OCF_Collection) && (obj2->OCF & OCF_Carryable) &&
+		    Inside<int32_t>(obj2->GetX() - (obj1->GetX() + obj1->Def->Collection.x), 0, obj1->Def->Collection.Wdt - 1) &&
+		    Inside<int32_t>(obj2->GetY() - (obj1->GetY() + obj1->Def->Collection.y), 0, obj1->Def->Collection.Hgt - 1))
+		{
+			CrossCheckCall(fChanged);
+			obj1->Collect(obj2);
+			// obj1 might have been tampered with
+			if (!obj1->Status || obj1->Contained || !(obj1->OCF & focf))
+				return false;
+		}
+	}
+	return true;
+}
+
+bool C4GameObjects::CrossCheckSectors(C4Object *obj1, C4LSector *pSct, C4Object *pAfter, DWORD focf, DWORD tocf, uint32_t Marker)
+{
+	// Check all objects in the sectors of obj1's area, starting behind pAfter in pSct
+	bool fChanged = false;
+	for (C4LSectorList *pLst = &pSct->Objects; pLst; pLst = obj1->Area.NextObjects(pLst, &pSct))
+	{
+		for (auto it = pAfter ? pLst->FindNext(pAfter) : pLst->begin(); !it.atEnd(); ++it)
+			if (!CrossCheckPair(obj1, *it, focf, tocf, Marker, fChanged))
+				return fChanged;
+		pAfter = nullptr;
+	}
+	return fChanged;
+}
+
+void C4GameObjects::BuildCrossCheckCandidates(DWORD tocf)
+{
+	CrossCheckCandidates.clear();
+	for (C4Object *obj : *this)
+		if (obj->Status && !obj->Contained && (obj->OCF & tocf))
+		{
+			C4LSector *pSct = Sectors.SectorAt(obj->old_x, obj->old_y);
+			CrossCheckCandidates.push_back({ obj->GetX(), obj->GetY(), pSct, obj });
+		}
+	std::sort(CrossCheckCandidates.begin(), CrossCheckCandidates.end(),
+		[](const CrossCheckCandidate &a, const CrossCheckCandidate &b) { return a.x < b.x; });
+}
+
 void C4GameObjects::CrossCheck() // Every Tick1 by ExecObjects
 {
 	DWORD focf,tocf;
@@ -98,57 +180,73 @@ void C4GameObjects::CrossCheck() // Every Tick1 by ExecObjects
 		tocf |= OCF_Carryable;
 	focf |= OCF_Collection; focf |= OCF_Alive; tocf |= OCF_HitSpeed2;
 
+	// Broad phase: All possible obj2 sorted by x. The checks must happen in the order
+	// in which the sector lists of obj1's area would be walked, so matches are sorted
+	// by sector and main list order. Any callback may move objects or change their
+	// OCF, so the candidates are collected again after one happened.
+	bool fCandidatesValid = false;
+	std::vector<std::pair<int32_t, C4Object *>> Matches;
+	const int32_t MaxAreaSectors = 16;
+	C4LSector *AreaSectors[MaxAreaSectors];
+
 	for (C4Object* obj1 : *this)
 		if (obj1->Status && !obj1->Contained && (obj1->OCF & focf))
 		{
 			uint32_t Marker = GetNextMarker();
+			if (!fCandidatesValid)
+			{
+				BuildCrossCheckCandidates(tocf);
+				fCandidatesValid = true;
+			}
+			// Sectors in walking order
+			int32_t iAreaSectors = 0;
 			C4LSector *pSct;
-			for (C4ObjectList *pLst = obj1->Area.FirstObjects(&pSct); pLst; pLst = obj1->Area.NextObjects(pLst, &pSct))
-				for (C4Object* obj2 : *pLst)
-					if ((obj2 != obj1) && obj2->Status && !obj2->Contained && (obj2->OCF & tocf) &&
-					    Inside<int32_t>(obj2->GetX() - (obj1->GetX() + obj1->Shape.x), 0, obj1->Shape.Wdt - 1) &&
-					    Inside<int32_t>(obj2->GetY() - (obj1->GetY() + obj1->Shape.y), 0, obj1->Shape.Hgt - 1) &&
-					    obj1->Layer == obj2->Layer)
-					{
-						// handle collision only once
-						if (obj2->Marker == Marker) continue;
-						obj2->Marker = Marker;
-						// Only hit if target is alive and projectile is an object
-						if ((obj1->OCF & OCF_Alive) && (obj2->Category & C4D_Object))
-						{
-							C4Real dXDir = obj2->xdir - obj1->xdir, dYDir = obj2->ydir - obj1->ydir;
-							C4Real speed = dXDir * dXDir + dYDir * dYDir;
-							// Only hit if obj2's speed and relative speeds are larger than HitSpeed2
-							if ((obj2->OCF & OCF_HitSpeed2) && speed > HitSpeed2 &&
-							   !obj1->Call(PSF_QueryCatchBlow, &C4AulParSet(obj2)))
-							{
-								int32_t iHitEnergy = fixtoi(speed * obj2->Mass / 5);
-								// Hit energy reduced to 1/3rd, but do not drop to zero because of this division
-								iHitEnergy = std::max<int32_t>(iHitEnergy/3, !!iHitEnergy);
-								obj1->DoEnergy(-iHitEnergy / 5, false, C4FxCall_EngObjHit, obj2->Controller);
-								int tmass = std::max<int32_t>(obj1->Mass, 50);
-								C4PropList* pActionDef = obj1->GetAction();
-								if (!::Game.iTick3 || (pActionDef && pActionDef->GetPropertyP(P_Procedure) != DFA_FLIGHT))
-									obj1->Fling(obj2->xdir * 50 / tmass, -Abs(obj2->ydir / 2) * 50 / tmass, false);
-								obj1->Call(PSF_CatchBlow, &C4AulParSet(-iHitEnergy / 5, obj2));
-								// obj1 might have been tampered with
-								if (!obj1->Status || obj1->Contained || !(obj1->OCF & focf))
-									goto out1;
-								continue;
-							}
-						}
-						// Collection
-						if ((obj1->OCF & OCF_Collection) && (obj2->OCF & OCF_Carryable) &&
-						    Inside<int32_t>(obj2->GetX() - (obj1->GetX() + obj1->Def->Collection.x), 0, obj1->Def->Collection.Wdt - 1) &&
-						    Inside<int32_t>(obj2->GetY() - (obj1->GetY() + obj1->Def->Collection.y), 0, obj1->Def->Collection.Hgt - 1))
+			for (pSct = obj1->Area.First(); pSct; pSct = obj1->Area.Next(pSct))
+			{
+				if (iAreaSectors == MaxAreaSectors) break;
+				AreaSectors[iAreaSectors++] = pSct;
+			}
+			if (pSct)
+			{
+				// huge object: walk the sectors
+				if (CrossCheckSectors(obj1, obj1->Area.First(), nullptr, focf, tocf, Marker))
+					fCandidatesValid = false;
+				continue;
+			}
+			// Collect all candidates within obj1's shape from sectors of its area
+			int32_t x0 = obj1->GetX() + obj1->Shape.x, y0 = obj1->GetY() + obj1->Shape.y;
+			auto it = std::lower_bound(CrossCheckCandidates.begin(), CrossCheckCandidates.end(), x0,
+				[](const CrossCheckCandidate &c, int32_t x) { return c.x < x; });
+			Matches.clear();
+			for (; it != CrossCheckCandidates.end() && it->x < x0 + obj1->Shape.Wdt; ++it)
+				if (Inside<int32_t>(it->y - y0, 0, obj1->Shape.Hgt - 1))
+					for (int32_t i = 0; i < iAreaSectors; ++i)
+						if (AreaSectors[i] == it->Sector)
 						{
-							obj1->Collect(obj2);
-							// obj1 might have been tampered with
-							if (!obj1->Status || obj1->Contained || !(obj1->OCF & focf))
-								goto out1;
+							Matches.emplace_back(i, it->Obj);
+							break;
 						}
-					}
-			out1: ;
+			if (Matches.empty()) continue;
+			std::sort(Matches.begin(), Matches.end(),
+				[](const std::pair<int32_t, C4Object *> &a, const std::pair<int32_t, C4Object *> &b)
+				{ return a.first < b.first || (a.first == b.first && a.second->SortOrder < b.second->SortOrder); });
+			// Narrow phase
+			for (auto &match : Matches)
+			{
+				bool fChanged = false;
+				if (!CrossCheckPair(obj1, match.second, focf, tocf, Marker, fChanged))
+				{
+					fCandidatesValid = !fChanged;
+					break;
+				}
+				if (fChanged)
+				{
+					// Continue like the sector walk would after this object
+					CrossCheckSectors(obj1, AreaSectors[match.first], match.second, focf, tocf, Marker);
+					fCandidatesValid = false;
+					break;
+				}
+			}
 		}
 }
 
@@ -203,6 +301,7 @@ void C4GameObjects::UpdateSolidMasks()
 void C4GameObjects::DeleteObjects(bool fDeleteInactive)
 {
 	C4ObjectList::DeleteObjects();
+	ClearIndex();
 	Sectors.ClearObjects();
 	ForeObjects.Clear();
 	if (fDeleteInactive) InactiveObjects.DeleteObjects();
@@ -363,14 +462,130 @@ C4Value C4GameObjects::GRBroadcast(const char *szFunction, C4AulParSet *pPars, b
 void C4GameObjects::UpdatePos(C4Object *pObj)
 {
 	// Position might have changed. Update sector lists
-	Sectors.Update(pObj, this);
+	Sectors.Update(pObj);
 }
 
 void C4GameObjects::UpdatePosResort(C4Object *pObj)
 {
 	// Object order for this object was changed. Readd object to sectors
 	Sectors.Remove(pObj);
-	Sectors.Add(pObj, this);
+	Sectors.Add(pObj);
+}
+
+void C4GameObjects::InsertLinkBefore(C4ObjectLink *pLink, C4ObjectLink *pBefore)
+{
+	C4NotifyingObjectList::InsertLinkBefore(pLink, pBefore);
+	UpdateSortOrder(pLink);
+	AddToIndex(pLink->Obj);
+}
+
+void C4GameObjects::InsertLink(C4ObjectLink *pLink, C4ObjectLink *pAfter)
+{
+	C4NotifyingObjectList::InsertLink(pLink, pAfter);
+	UpdateSortOrder(pLink);
+	AddToIndex(pLink->Obj);
+}
+
+void C4GameObjects::RemoveLink(C4ObjectLink *pLnk)
+{
+	C4NotifyingObjectList::RemoveLink(pLnk);
+	RemoveFromIndex(pLnk->Obj);
+}
+
+const C4LSectorList &C4GameObjects::ObjectsByPrototype(const C4PropList *pPrototype) const
+{
+	static const C4LSectorList EmptyList;
+	auto i = PrototypeIndex.find(pPrototype);
+	if (i == PrototypeIndex.end()) return EmptyList;
+	return *i->second;
+}
+
+void C4GameObjects::UpdateIndex(C4Object *pObj)
+{
+	// only resort the object if one of its keys changed
+	if (pObj->Indexed && pObj->IndexedPrototype == pObj->GetPrototype() && pObj->IndexedCategory == pObj->Category) return;
+	RemoveFromIndex(pObj);
+	AddToIndex(pObj);
+}
+
+void C4GameObjects::AddToIndex(C4Object *pObj)
+{
+	assert(!pObj->Indexed);
+	pObj->IndexedPrototype = pObj->GetPrototype();
+	pObj->IndexedCategory = pObj->Category;
+	pObj->Indexed = true;
+	// lists of prototypes are kept even if they become empty, so iterators stay valid
+	std::unique_ptr<C4LSectorList> &pList = PrototypeIndex[pObj->IndexedPrototype];
+	if (!pList) pList.reset(new C4LSectorList);
+	pList->Add(pObj);
+	for (int32_t iBit = 0; iBit < 32; ++iBit)
+		if (uint32_t(pObj->IndexedCategory) & (uint32_t(1) << iBit))
+			CategoryIndex[iBit].Add(pObj);
+}
+
+void C4GameObjects::RemoveFromIndex(C4Object *pObj)
+{
+	if (!pObj->Indexed) return;
+	auto i = PrototypeIndex.find(pObj->IndexedPrototype);
+	if (i != PrototypeIndex.end()) i->second->Remove(pObj);
+	for (int32_t iBit = 0; iBit < 32; ++iBit)
+		if (uint32_t(pObj->IndexedCategory) & (uint32_t(1) << iBit))
+			CategoryIndex[iBit].Remove(pObj);
+	pObj->Indexed = false;
+}
+
+void C4GameObjects::RebuildIndex()
+{
+	// prototypes of loaded objects are only known after denumeration
+	ClearIndex();
+	for (C4ObjectLink *pLnk = First; pLnk; pLnk = pLnk->Next)
+		pLnk->Obj->Indexed = false;
+	for (C4ObjectLink *pLnk = First; pLnk; pLnk = pLnk->Next)
+		AddToIndex(pLnk->Obj);
+}
+
+void C4GameObjects::ClearIndex()
+{
+	PrototypeIndex.clear();
+	for (C4LSectorList &List : CategoryIndex)
+		List.Clear();
+}
+
+// Distance between the sort orders of neighbouring objects after renumbering
+static const uint64_t SortOrderStep = uint64_t(1) << 32;
+// Sort order of the first object after renumbering; leaves room for insertions at the front
+static const uint64_t SortOrderFirst = uint64_t(1) << 62;
+
+void C4GameObjects::UpdateSortOrder(C4ObjectLink *pLnk)
+{
+	// Place the sort order between the neighbours so the sector lists can find
+	// the main list position of an object without walking the main list
+	uint64_t iPrev = pLnk->Prev ? pLnk->Prev->Obj->SortOrder : 0;
+	if (!pLnk->Next)
+	{
+		if (!pLnk->Prev)
+			pLnk->Obj->SortOrder = SortOrderFirst;
+		else if (iPrev <= UINT64_MAX - SortOrderStep)
+			pLnk->Obj->SortOrder = iPrev + SortOrderStep;
+		else
+			RenumberSortOrder();
+		return;
+	}
+	uint64_t iNext = pLnk->Next->Obj->SortOrder;
+	if (!pLnk->Prev && iNext > SortOrderStep)
+		pLnk->Obj->SortOrder = iNext - SortOrderStep;
+	else if (iNext - iPrev > 1 && iNext > iPrev)
+		pLnk->Obj->SortOrder = iPrev + (iNext - iPrev) / 2;
+	else
+		RenumberSortOrder();
+}
+
+void C4GameObjects::RenumberSortOrder()
+{
+	// relative order is kept, so the sector lists stay sorted
+	uint64_t iOrder = SortOrderFirst;
+	for (C4ObjectLink *pLnk = First; pLnk; pLnk = pLnk->Next, iOrder += SortOrderStep)
+		pLnk->Obj->SortOrder = iOrder;
 }
 
 void C4GameObjects::FixObjectOrder()
@@ -439,6 +654,10 @@ void C4GameObjects::FixObjectOrder()
 		if (!pLnk1stUnsorted) break; // done
 		pLnk0 = pLnk1stUnsorted;
 	}
+	// objects were swapped without updating their sort order
+	RenumberSortOrder();
+	Sectors.Sort();
+	RebuildIndex();
 	// objects fixed!
 }
 
@@ -38,6 +38,34 @@ public:
 private:
 	uint32_t LastUsedMarker; // last used value for C4Object::Marker
 
+	// broad phase of CrossCheck: possible targets sorted by x
+	struct CrossCheckCandidate
+	{
+		int32_t x, y;
+		C4LSector *Sector; // sector of the object's Objects list
+		C4Object *Obj;
+	};
+	std::vector<CrossCheckCandidate> CrossCheckCandidates;
+	void BuildCrossCheckCandidates(DWORD tocf);
+	bool CrossCheckPair(C4Object *obj1, C4Object *obj2, DWORD focf, DWORD tocf, uint32_t Marker, bool &fChanged);
+	bool CrossCheckSectors(C4Object *obj1, C4LSector *pSct, C4Object *pAfter, DWORD focf, DWORD tocf, uint32_t Marker);
+
+	void UpdateSortOrder(C4ObjectLink *pLnk); // assign C4Object::SortOrder to a newly inserted link
+	void RenumberSortOrder(); // space out the sort order of all objects evenly
+
+	// objects of the main list by prototype and by category bit, in main list order
+	std::map<const C4PropList *, std::unique_ptr<C4LSectorList>> PrototypeIndex;
+	C4LSectorList CategoryIndex[32];
+	void AddToIndex(C4Object *pObj);
+	void RemoveFromIndex(C4Object *pObj);
+	void RebuildIndex();
+	void ClearIndex();
+
+protected:
+	void InsertLinkBefore(C4ObjectLink *pLink, C4ObjectLink *pBefore) override;
+	void InsertLink(C4ObjectLink *pLink, C4ObjectLink *pAfter) override;
+	void RemoveLink(C4ObjectLink *pLnk) override;
+
 public:
 	C4LSectors Sectors; // section object lists
 	C4ObjectList InactiveObjects; // inactive objects (Status=2)
@@ -47,7 +75,12 @@ public:
 	bool Add(C4Object *nObj); // add object
 	bool Remove(C4Object *pObj) override; // clear pointers to object
 
-	C4ObjectList &ObjectsAt(int ix, int iy); // get object list for map pos
+	C4LSectorList &ObjectsAt(int ix, int iy); // get object list for map pos
+
+	// all objects of the main list with the given prototype or category bit
+	const C4LSectorList &ObjectsByPrototype(const C4PropList *pPrototype) const;
+	const C4LSectorList &ObjectsByCategory(int32_t iCategoryBit) const { return CategoryIndex[iCategoryBit]; }
+	void UpdateIndex(C4Object *pObj); // prototype or category of an object in the main list changed
 
 	void CrossCheck(); // various collision-checks
 	C4Object *AtObject(int ctx, int cty, DWORD &ocf, C4Object *exclude=nullptr); // find object at ctx/cty
@@ -35,6 +35,7 @@
 #include "landscape/C4SolidMask.h"
 #include "landscape/fow/C4FoW.h"
 #include "lib/C4Random.h"
+#include "lib/C4Trace.h"
 #include "object/C4Command.h"
 #include "object/C4Def.h"
 #include "object/C4DefList.h"
@@ -97,6 +98,7 @@ void C4Object::Default()
 	Controller=NO_OWNER;
 	LastEnergyLossCausePlayer=NO_OWNER;
 	Category=0;
+	IndexedPrototype=nullptr; IndexedCategory=0; Indexed=false;
 	Con=0;
 	Mass=OwnMass=0;
 	Damage=0;
@@ -134,6 +136,7 @@ void C4Object::Default()
 	Menu=nullptr;
 	MaterialContents=nullptr;
 	Marker=0;
+	SortOrder=0;
 	ColorMod=0xffffffff;
 	BlitMode=0;
 	CrewDisabled=false;
@@ -920,27 +923,36 @@ void C4Object::Execute()
 		rc.fr=fix_r;
 		AddDbgRec(RCT_ExecObj, &rc, sizeof(rc));
 	}
+	// Trace spans: one per object, nested one per phase
+	C4TraceScope ObjectTrace("Object", Def ? Def->id.ToString() : "Object", true);
+	C4TraceScope PhaseTrace("Object", "UpdateOCF");
 	// OCF
 	UpdateOCF();
 	// Command
+	PhaseTrace.Next("ExecuteCommand");
 	ExecuteCommand();
 	// Action
 	// need not check status, because dead objects have lost their action
+	PhaseTrace.Next("ExecAction");
 	ExecAction();
 	// commands and actions are likely to have removed the object, and movement
 	// *must not* be executed for dead objects (SolidMask-errors)
 	if (!Status) return;
 	// Movement
+	PhaseTrace.Next("ExecMovement");
 	ExecMovement();
 	if (!Status) return;
 	// effects
 	if (pEffects)
 	{
+		PhaseTrace.Next("Effects");
 		C4Effect::Execute(&pEffects);
 		if (!Status) return;
 	}
 	// Life
+	PhaseTrace.Next("ExecLife");
 	ExecLife();
+	PhaseTrace.Next("Animation");
 	// Animation. If the mesh is attached, then don't execute animation here but let the parent object do it to make sure it is only executed once a frame.
 	if (pMeshInstance && !pMeshInstance->GetAttachParent())
 		pMeshInstance->ExecuteAnimation(1.0f/37.0f /* play smoothly at 37 FPS */);
@@ -2263,10 +2275,17 @@ void C4Object::CompileFunc(StdCompiler *pComp, C4ValueNumbers * numbers)
 		else
 		{
 			C4Command *pCmd = Command;
-			for (int i = 1; pCmd; i++, pCmd = pCmd->Next)
+			int i;
+			for (i = 1; pCmd; i++, pCmd = pCmd->Next)
 			{
 				StdStrBuf Naming = FormatString("Command%d", i);
-				pComp->Value(mkNamingAdapt(mkParAdapt(*pCmd, numbers), Naming.getData()));
+				pComp->Value(mkParAdapt(mkNamingPtrAdapt(pCmd, Naming.getData()), numbers));
+			}
+			// Without naming, the loader needs the null pointer it stops at
+			if (!pComp->hasNaming())
+			{
+				StdStrBuf Naming = FormatString("Command%d", i);
+				pComp->Value(mkParAdapt(mkNamingPtrAdapt(pCmd, Naming.getData()), numbers));
 			}
 		}
 	}
@@ -2664,6 +2683,14 @@ bool C4Object::ExecuteCommand()
 	return true;
 }
 
+void C4Object::SetCategory(int32_t Category)
+{
+	this->Category = Category;
+	if (Indexed) ::Objects.UpdateIndex(this);
+	Resort();
+	SetOCF();
+}
+
 void C4Object::Resort()
 {
 	// Flag resort
@@ -4852,6 +4879,10 @@ void C4Object::SetPropertyByS(C4String * k, const C4Value & to)
 				if (!to.getInt()) throw C4AulExecError("invalid Plane 0");
 				SetPlane(to.getInt());
 				return;
+			case P_Prototype:
+				C4PropListNumbered::SetPropertyByS(k, to);
+				if (Indexed) ::Objects.UpdateIndex(this);
+				return;
 		}
 	}
 	C4PropListNumbered::SetPropertyByS(k, to);
@@ -4866,6 +4897,10 @@ void C4Object::ResetProperty(C4String * k)
 			case P_Plane:
 				SetPlane(GetPropertyInt(P_Plane));
 				return;
+			case P_Prototype:
+				C4PropListNumbered::ResetProperty(k);
+				if (Indexed) ::Objects.UpdateIndex(this);
+				return;
 		}
 	}
 	return C4PropListNumbered::ResetProperty(k);
@@ -112,6 +112,8 @@ public:
 	int32_t LastEnergyLossCausePlayer; // last player that caused an energy loss to this Clonk (used to trace kills when player tumbles off a cliff, etc.)
 	int32_t Category;
 	int32_t old_x, old_y; C4LArea Area; // position as currently seen by Game.Objecets.Sectors. UpdatePos to sync.
+	uint64_t SortOrder; // increases along the main object list; sorts the sector lists - NoSave
+	C4PropList *IndexedPrototype; int32_t IndexedCategory; bool Indexed; // keys as currently seen by the C4GameObjects indices - NoSave
 	int32_t Mass, OwnMass;
 	int32_t Damage;
 	int32_t Energy;
@@ -254,7 +256,7 @@ public:
 	bool SetActionByName(C4String * ActName, C4Object *pTarget=nullptr, C4Object *pTarget2=nullptr, int32_t iCalls = SAC_StartCall | SAC_AbortCall, bool fForce = false);
 	bool SetActionByName(const char * szActName, C4Object *pTarget=nullptr, C4Object *pTarget2=nullptr, int32_t iCalls = SAC_StartCall | SAC_AbortCall, bool fForce = false);
 	void SetDir(int32_t tdir);
-	void SetCategory(int32_t Category) { this->Category = Category; Resort(); SetOCF(); }
+	void SetCategory(int32_t Category);
 	int32_t GetProcedure() const;
 	bool Enter(C4Object *pTarget, bool fCalls=true, bool fCopyMotion=true, bool *pfRejectCollect=nullptr);
 	bool Exit(int32_t iX=0, int32_t iY=0, int32_t iR=0, C4Real iXDir=Fix0, C4Real iYDir=Fix0, C4Real iRDir=Fix0, bool fCalls=true);
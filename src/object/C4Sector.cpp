@@ -22,6 +22,145 @@
 #include "object/C4GameObjects.h"
 #include "object/C4Object.h"
 
+/* sector object list */
+
+static bool SortOrderLess(const C4Object *a, const C4Object *b)
+{
+	return a->SortOrder < b->SortOrder;
+}
+
+C4LSectorList::iterator::iterator(const C4LSectorList &List, int32_t Pos):
+		List(List), Pos(Pos), Obj(nullptr), Next(nullptr), Registered(!atEnd())
+{
+	if (Registered)
+	{
+		Obj = List.Objects[Pos];
+		List.AddIter(this);
+	}
+}
+
+C4LSectorList::iterator::iterator(const iterator &iter):
+		List(iter.List), Pos(iter.Pos), Obj(iter.Obj), Next(nullptr), Registered(iter.Registered)
+{
+	if (Registered) List.AddIter(this);
+}
+
+C4LSectorList::iterator::~iterator()
+{
+	if (Registered) List.RemoveIter(this);
+}
+
+C4LSectorList::iterator &C4LSectorList::iterator::operator ++ ()
+{
+	++Pos;
+	Obj = atEnd() ? nullptr : List.Objects[Pos];
+	return *this;
+}
+
+bool C4LSectorList::iterator::operator == (const iterator &iter) const
+{
+	if (atEnd() || iter.atEnd()) return atEnd() == iter.atEnd();
+	return Pos == iter.Pos;
+}
+
+void C4LSectorList::AddIter(iterator *iter) const
+{
+	iter->Next = FirstIter;
+	FirstIter = iter;
+}
+
+void C4LSectorList::RemoveIter(iterator *iter) const
+{
+	iterator **ppIter = &FirstIter;
+	while (*ppIter != iter) ppIter = &(*ppIter)->Next;
+	*ppIter = iter->Next;
+}
+
+int32_t C4LSectorList::Find(const C4Object *pObj) const
+{
+	// binary search by main list position
+	auto it = std::lower_bound(Objects.begin(), Objects.end(), pObj, SortOrderLess);
+	if (it != Objects.end() && *it == pObj) return it - Objects.begin();
+	// not found or list out of order
+	it = std::find(Objects.begin(), Objects.end(), pObj);
+	return it != Objects.end() ? it - Objects.begin() : -1;
+}
+
+C4LSectorList::iterator C4LSectorList::FindNext(const C4Object *pObj) const
+{
+	auto it = std::upper_bound(Objects.begin(), Objects.end(), pObj, SortOrderLess);
+	return iterator(*this, it - Objects.begin());
+}
+
+bool C4LSectorList::Add(C4Object *pObj)
+{
+	assert(Find(pObj) < 0);
+	auto it = std::upper_bound(Objects.begin(), Objects.end(), pObj, SortOrderLess);
+	int32_t iPos = it - Objects.begin();
+	Objects.insert(it, pObj);
+	// objects inserted before the current position must not be visited
+	for (iterator *iter = FirstIter; iter; iter = iter->Next)
+		if (iPos <= iter->Pos) ++iter->Pos;
+	return true;
+}
+
+bool C4LSectorList::Remove(C4Object *pObj)
+{
+	int32_t iPos = Find(pObj);
+	if (iPos < 0) return false;
+	Objects.erase(Objects.begin() + iPos);
+	// if the current object is removed, the iterator continues with its successor
+	for (iterator *iter = FirstIter; iter; iter = iter->Next)
+		if (iPos <= iter->Pos) --iter->Pos;
+	return true;
+}
+
+void C4LSectorList::Clear()
+{
+	Objects.clear();
+	// live iterators are at the end now
+	for (iterator *iter = FirstIter; iter; iter = iter->Next)
+		iter->Pos = 0;
+}
+
+void C4LSectorList::Sort()
+{
+	assert(!FirstIter);
+	std::stable_sort(Objects.begin(), Objects.end(), SortOrderLess);
+}
+
+bool C4LSectorList::IsContained(const C4Object *pObj) const
+{
+	return std::find(Objects.begin(), Objects.end(), pObj) != Objects.end();
+}
+
+int C4LSectorList::ObjectCount() const
+{
+	int iCount = 0;
+	for (C4Object *pObj : Objects)
+		if (pObj->Status)
+			++iCount;
+	return iCount;
+}
+
+bool C4LSectorList::CheckSort() const
+{
+	for (size_t i = 1; i < Objects.size(); ++i)
+		if (Objects[i - 1]->SortOrder >= Objects[i]->SortOrder)
+			return false;
+	return true;
+}
+
+void C4LSectorList::CompileFunc(StdCompiler *pComp)
+{
+	assert(!pComp->isDeserializer());
+	std::list<int32_t> Numbers;
+	for (C4Object *pObj : Objects)
+		if (pObj->Status)
+			Numbers.push_back(pObj->Number);
+	pComp->Value(mkSTLContainerAdapt(Numbers, StdCompiler::SEP_SEP2));
+}
+
 /* sector */
 
 void C4LSector::Init(int ix, int iy)
@@ -38,12 +177,12 @@ void C4LSector::Clear()
 	ClearObjects();
 }
 
-void C4LSector::CompileFunc(StdCompiler *pComp, C4ValueNumbers * numbers)
+void C4LSector::CompileFunc(StdCompiler *pComp)
 {
 	pComp->Value(mkNamingAdapt(mkIntAdapt(x), "x"));
 	pComp->Value(mkNamingAdapt(mkIntAdapt(y), "y"));
-	pComp->Value(mkNamingAdapt(mkParAdapt(Objects, numbers), "Objects"));
-	pComp->Value(mkNamingAdapt(mkParAdapt(ObjectShapes, numbers), "ObjectShapes"));
+	pComp->Value(mkNamingAdapt(Objects, "Objects"));
+	pComp->Value(mkNamingAdapt(ObjectShapes, "ObjectShapes"));
 }
 
 void C4LSector::ClearObjects()
@@ -88,31 +227,31 @@ C4LSector *C4LSectors::SectorAt(int ix, int iy)
 	return Sectors+(iy/C4LSectorHgt)*Wdt+(ix/C4LSectorWdt);
 }
 
-void C4LSectors::Add(C4Object *pObj, C4ObjectList *pMainList)
+void C4LSectors::Add(C4Object *pObj)
 {
 	assert(Sectors);
 	// Add to owning sector
 	C4LSector *pSct = SectorAt(pObj->GetX(), pObj->GetY());
-	pSct->Objects.Add(pObj, C4ObjectList::stMain, pMainList);
+	pSct->Objects.Add(pObj);
 	// Save position
 	pObj->old_x = pObj->GetX(); pObj->old_y = pObj->GetY();
 	// Add to all sectors in shape area
 	pObj->Area.Set(this, pObj);
 	for (pSct = pObj->Area.First(); pSct; pSct = pObj->Area.Next(pSct))
 	{
-		pSct->ObjectShapes.Add(pObj, C4ObjectList::stMain, pMainList);
+		pSct->ObjectShapes.Add(pObj);
 	}
 	if (Config.General.DebugRec)
 		pObj->Area.DebugRec(pObj, 'A');
 }
 
-void C4LSectors::Update(C4Object *pObj, C4ObjectList *pMainList)
+void C4LSectors::Update(C4Object *pObj)
 {
 	assert(Sectors);
 	// Not added yet?
 	if (pObj->Area.IsNull())
 	{
-		Add(pObj, pMainList);
+		Add(pObj);
 		return;
 	}
 	C4LSector *pOld, *pNew;
@@ -124,7 +263,7 @@ void C4LSectors::Update(C4Object *pObj, C4ObjectList *pMainList)
 		if (pOld != pNew)
 		{
 			pOld->Objects.Remove(pObj);
-			pNew->Objects.Add(pObj, C4ObjectList::stMain, pMainList);
+			pNew->Objects.Add(pObj);
 		}
 		// Save position
 		pObj->old_x = pObj->GetX(); pObj->old_y = pObj->GetY();
@@ -140,7 +279,7 @@ void C4LSectors::Update(C4Object *pObj, C4ObjectList *pMainList)
 	for (pNew = NewArea.First(); pNew; pNew = NewArea.Next(pNew))
 		if (!pObj->Area.Contains(pNew))
 		{
-			pNew->ObjectShapes.Add(pObj, C4ObjectList::stMain, pMainList);
+			pNew->ObjectShapes.Add(pObj);
 		}
 	// Update area
 	pObj->Area = NewArea;
@@ -206,22 +345,32 @@ int C4LSectors::getShapeSum() const
 
 void C4LSectors::Dump()
 {
-	C4ValueNumbers numbers;
 	LogSilent(DecompileToBuf<StdCompilerINIWrite>(
 	            mkNamingAdapt(
-	              mkArrayAdaptMap(Sectors, Size, mkParAdaptMaker(&numbers)),
+	              mkArrayAdapt(Sectors, Size),
 	              "Sector")).getData());
 }
 
 bool C4LSectors::CheckSort()
 {
 	for (int cnt=0; cnt<Size; cnt++)
-		if (!Sectors[cnt].Objects.CheckSort(&::Objects))
+		if (!Sectors[cnt].Objects.CheckSort() || !Sectors[cnt].ObjectShapes.CheckSort())
 			return false;
-	if (!SectorOut.Objects.CheckSort(&::Objects)) return false;
+	if (!SectorOut.Objects.CheckSort() || !SectorOut.ObjectShapes.CheckSort()) return false;
 	return true;
 }
 
+void C4LSectors::Sort()
+{
+	for (int cnt=0; cnt<Size; cnt++)
+	{
+		Sectors[cnt].Objects.Sort();
+		Sectors[cnt].ObjectShapes.Sort();
+	}
+	SectorOut.Objects.Sort();
+	SectorOut.ObjectShapes.Sort();
+}
+
 void C4LSectors::ClearObjects()
 {
 	if (Sectors)
@@ -300,7 +449,7 @@ bool C4LArea::Contains(C4LSector *pSct) const
 	return (pSct->x>=pFirst->x && pSct->y>=pFirst->y && pSct->x<=xL && pSct->y<=yL);
 }
 
-C4ObjectList *C4LArea::NextObjects(C4ObjectList *pPrev, C4LSector **ppSct)
+C4LSectorList *C4LArea::NextObjects(C4LSectorList *pPrev, C4LSector **ppSct)
 {
 	// get next sector
 	if (!*ppSct)
@@ -314,7 +463,7 @@ C4ObjectList *C4LArea::NextObjects(C4ObjectList *pPrev, C4LSector **ppSct)
 	return &(*ppSct)->Objects;
 }
 
-C4ObjectList *C4LArea::NextObjectShapes(C4ObjectList *pPrev, C4LSector **ppSct)
+C4LSectorList *C4LArea::NextObjectShapes(C4LSectorList *pPrev, C4LSector **ppSct)
 {
 	// get next sector
 	if (!*ppSct)
@@ -23,6 +23,7 @@
 #include "object/C4ObjectList.h"
 
 // class predefs
+class C4LSectorList;
 class C4LSector;
 class C4LSectors;
 class C4LArea;
@@ -31,6 +32,64 @@ class C4LArea;
 const int32_t C4LSectorWdt = 50,
                              C4LSectorHgt = 50;
 
+// Flat object list of a sector. Objects are kept in the order of the main
+// object list (by C4Object::SortOrder), so searches through several sectors
+// find the same objects first as a search through the main list would.
+class C4LSectorList
+{
+public:
+	C4LSectorList() = default;
+	C4LSectorList(const C4LSectorList &) = delete;
+	~C4LSectorList() { assert(!FirstIter); }
+	C4LSectorList &operator = (const C4LSectorList &) = delete;
+
+	// An iterator which survives if objects are added to or removed from the list
+	// (objects inserted after the current position are visited, like in C4ObjectList)
+	class iterator
+	{
+	public:
+		iterator(const iterator &iter);
+		~iterator();
+		iterator &operator ++ ();
+		C4Object *operator * () const { return Obj; }
+		bool operator == (const iterator &iter) const;
+		bool operator != (const iterator &iter) const { return !(*this == iter); }
+		bool atEnd() const { return Pos >= static_cast<int32_t>(List.Objects.size()); }
+		iterator &operator = (const iterator &iter) = delete;
+	private:
+		iterator(const C4LSectorList &List, int32_t Pos);
+		const C4LSectorList &List;
+		int32_t Pos; // index of the current object
+		C4Object *Obj; // current object; stays valid if it is removed from the list
+		iterator *Next; // next iterator of this list
+		bool Registered;
+		friend class C4LSectorList;
+	};
+	iterator begin() const { return iterator(*this, 0); }
+	iterator end() const { return iterator(*this, INT32_MAX); }
+	iterator FindNext(const C4Object *pObj) const; // first object behind pObj in main list order, whether pObj is listed or not
+
+	bool Add(C4Object *pObj); // insert sorted by main list order
+	bool Remove(C4Object *pObj);
+	void Clear();
+	void Sort(); // restore sorting after the main list order has been changed
+
+	bool IsContained(const C4Object *pObj) const;
+	int ObjectCount() const; // number of objects with Status set
+	int32_t GetSize() const { return Objects.size(); } // number of objects including deleted ones
+	bool CheckSort() const;
+
+	void CompileFunc(StdCompiler *pComp); // for debug dumps only
+
+private:
+	std::vector<C4Object *> Objects;
+	mutable iterator *FirstIter{nullptr};
+
+	int32_t Find(const C4Object *pObj) const; // index of object or -1
+	void AddIter(iterator *iter) const;
+	void RemoveIter(iterator *iter) const;
+};
+
 // one of those object list sectors
 class C4LSector
 {
@@ -45,10 +104,10 @@ protected:
 public:
 	int x, y; // pos
 
-	C4ObjectList Objects; // objects within this sector
-	C4ObjectList ObjectShapes; // objects with shapes that overlap this sector
+	C4LSectorList Objects; // objects within this sector
+	C4LSectorList ObjectShapes; // objects with shapes that overlap this sector
 
-	void CompileFunc(StdCompiler *pComp, C4ValueNumbers * numbers);
+	void CompileFunc(StdCompiler *pComp);
 	void ClearObjects(); // remove all objects from object lists
 
 	friend class C4LSectors;
@@ -69,10 +128,11 @@ public:
 	void Clear(); // free map sectors
 	C4LSector *SectorAt(int ix, int iy); // get sector at pos
 
-	void Add(C4Object *pObj, C4ObjectList *pMainList);
-	void Update(C4Object *pObj, C4ObjectList *pMainList); // does not update object order!
+	void Add(C4Object *pObj);
+	void Update(C4Object *pObj); // does not update object order!
 	void Remove(C4Object *pObj);
 	void ClearObjects(); // remove all objects from object lists
+	void Sort(); // resort all sector lists after the main list order changed
 
 	void AssertObjectNotInList(C4Object *pObj); // searches all sector lists for object, and assert if it's inside a list
 
@@ -115,13 +175,13 @@ public:
 
 	bool Contains(C4LSector *pSct) const; // return whether sector is contained in area
 
-	inline C4ObjectList *FirstObjects(C4LSector **ppSct) // get first object list of this area
+	inline C4LSectorList *FirstObjects(C4LSector **ppSct) // get first object list of this area
 	{ *ppSct=nullptr; return NextObjects(nullptr, ppSct); }
-	C4ObjectList *NextObjects(C4ObjectList *pPrev, C4LSector **ppSct); // get next object list of this area
+	C4LSectorList *NextObjects(C4LSectorList *pPrev, C4LSector **ppSct); // get next object list of this area
 
-	inline C4ObjectList *FirstObjectShapes(C4LSector **ppSct) // get first object shapes list of this area
+	inline C4LSectorList *FirstObjectShapes(C4LSector **ppSct) // get first object shapes list of this area
 	{ *ppSct=nullptr; return NextObjectShapes(nullptr, ppSct); }
-	C4ObjectList *NextObjectShapes(C4ObjectList *pPrev, C4LSector **ppSct); // get next object shapes list of this area
+	C4LSectorList *NextObjectShapes(C4LSectorList *pPrev, C4LSector **ppSct); // get next object shapes list of this area
 
 	void DebugRec(class C4Object *pObj, char cMarker);
 };
@@ -1131,6 +1131,17 @@ void C4Player::CompileFunc(StdCompiler *pComp, C4ValueNumbers * numbers)
 
 bool C4Player::LoadRuntimeData(C4Group &hGroup, C4ValueNumbers * numbers)
 {
+	// Binary runtime data: Stored by unique player ID as well
+	if (Game.GameBinaryLoaded)
+	{
+		assert(ID);
+		auto PlayerData = Game.PlayerRuntimeData.find(ID);
+		if (PlayerData == Game.PlayerRuntimeData.end()) return false;
+		if (!CompileFromBuf_LogWarn<StdCompilerBinRead>(mkParAdapt(*this, numbers), PlayerData->second, C4CFN_GameBinary))
+			return false;
+		DenumeratePointers();
+		return true;
+	}
 	const char *pSource;
 	// Use loaded game text component
 	if (!(pSource = Game.GameText.GetData())) return false;
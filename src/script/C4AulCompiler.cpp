@@ -198,6 +198,7 @@ class C4AulCompiler::CodegenAstVisitor : public ::aul::DefaultRecursiveVisitor
 
 	static int GetStackValue(C4AulBCCType eType, intptr_t X);
 	void RemoveLastBCC();
+	void FuseSuperInstructions();
 	C4AulBCC MakeSetter(const char *SPos, bool fLeaveValue);
 
 	void HandleError(const C4AulError &e)
@@ -709,6 +710,12 @@ int C4AulCompiler::CodegenAstVisitor::GetStackValue(C4AulBCCType eType, intptr_t
 
 	case AB_ARRAY_SLICE_SET:
 		return -3;
+
+	case AB_LOCALN_PROP:
+	case AB_INT_Sum:
+	case AB_DUP_INT_LessThan_COND:
+		// superinstructions are only formed after code generation
+		break;
 	}
 	assert(0 && "GetStackValue: unexpected bytecode not handled");
 	return 0;
@@ -845,6 +852,55 @@ void C4AulCompiler::CodegenAstVisitor::RemoveLastBCC()
 	Fn->RemoveLastBCC();
 }
 
+void C4AulCompiler::CodegenAstVisitor::FuseSuperInstructions()
+{
+	// Replace common chunk sequences by superinstructions. Only the type of the
+	// first chunk changes; the others stay in place to supply their parameters,
+	// so jump offsets and code positions remain valid, and the interpreter can
+	// fall back to executing the remaining chunks one by one.
+	std::vector<C4AulBCC> &Code = Fn->Code;
+	// Chunks inside a sequence must not be entered from anywhere else
+	std::vector<bool> is_target(Code.size() + 2, false);
+	for (size_t i = 0; i < Code.size(); ++i)
+	{
+		if (IsJump(Code[i].bccType))
+			is_target[i + Code[i].Par.i] = true;
+		else if (Code[i].bccType == AB_FOREACH_NEXT)
+			is_target[i + 2] = true;
+	}
+	auto matches = [&](size_t i, std::initializer_list<C4AulBCCType> seq)
+	{
+		if (i + seq.size() > Code.size()) return false;
+		size_t j = i;
+		for (C4AulBCCType eType : seq)
+		{
+			if (Code[j].bccType != eType) return false;
+			if (j != i && is_target[j]) return false;
+			++j;
+		}
+		return true;
+	};
+	for (size_t i = 0; i < Code.size(); ++i)
+	{
+		if (matches(i, { AB_DUP, AB_INT, AB_LessThan, AB_CONDN }) || matches(i, { AB_DUP, AB_INT, AB_LessThan, AB_COND }))
+		{
+			// loop conditions like i < 10
+			Code[i].bccType = AB_DUP_INT_LessThan_COND;
+			i += 3;
+		}
+		else if (matches(i, { AB_LOCALN, AB_PROP }))
+		{
+			Code[i].bccType = AB_LOCALN_PROP;
+			i += 1;
+		}
+		else if (matches(i, { AB_INT, AB_Sum }))
+		{
+			Code[i].bccType = AB_INT_Sum;
+			i += 1;
+		}
+	}
+}
+
 int C4AulCompiler::CodegenAstVisitor::AddBCC(const char *SPos, const C4AulBCC &bcc)
 {
 	return AddBCC(SPos, bcc.bccType, bcc.Par.X);
@@ -1531,6 +1587,7 @@ void C4AulCompiler::CodegenAstVisitor::EmitFunctionCode(const ::aul::ast::Functi
 		AddBCC(n->loc, AB_NIL);
 		AddBCC(n->loc, AB_RETURN);
 	}
+	FuseSuperInstructions();
 	Fn->DumpByteCode();
 	// This instruction should never be reached but we'll add it just in
 	// case.
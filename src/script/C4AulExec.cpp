@@ -19,6 +19,7 @@
 #include "script/C4AulExec.h"
 
 #include "control/C4Record.h"
+#include "lib/C4Trace.h"
 #include "object/C4Def.h"
 #include "object/C4Object.h"
 #include "script/C4Aul.h"
@@ -28,6 +29,18 @@
 
 C4AulExec AulExec;
 
+// Dispatch the byte code with computed gotos where the compiler supports them
+#if defined(__GNUC__) && !defined(NO_AUL_COMPUTED_GOTO)
+#define AUL_COMPUTED_GOTO
+#define AUL_OP(op) case op: op_##op
+#define AUL_DISPATCH goto *DispatchTable[pCPos->bccType]
+#else
+#define AUL_OP(op) case op
+#define AUL_DISPATCH continue
+#endif
+// continue with the next chunk
+#define AUL_NEXT { ++pCPos; AUL_DISPATCH; }
+
 C4AulExecError::C4AulExecError(const char *szError)
 {
 	assert(szError);
@@ -192,88 +205,107 @@ C4Value C4AulExec::Exec(C4AulScriptFunc *pSFunc, C4PropList * p, C4Value *pnPars
 
 C4Value C4AulExec::Exec(C4AulBCC *pCPos)
 {
+#ifdef AUL_COMPUTED_GOTO
+	// in the order of C4AulBCCType
+	static void *const DispatchTable[] =
+	{
+		&&op_AB_ARRAYA, &&op_AB_ARRAYA_SET, &&op_AB_PROP, &&op_AB_PROP_SET, &&op_AB_ARRAY_SLICE, &&op_AB_ARRAY_SLICE_SET,
+		&&op_AB_DUP, &&op_AB_DUP_CONTEXT, &&op_AB_STACK_SET, &&op_AB_POP_TO, &&op_AB_LOCALN, &&op_AB_LOCALN_SET,
+		&&op_AB_GLOBALN, &&op_AB_GLOBALN_SET, &&op_AB_PAR, &&op_AB_THIS, &&op_AB_FUNC,
+		&&op_AB_Inc, &&op_AB_Dec, &&op_AB_BitNot, &&op_AB_Not, &&op_AB_Neg,
+		&&op_AB_Pow, &&op_AB_Div, &&op_AB_Mul, &&op_AB_Mod, &&op_AB_Sub, &&op_AB_Sum, &&op_AB_LeftShift, &&op_AB_RightShift,
+		&&op_AB_LessThan, &&op_AB_LessThanEqual, &&op_AB_GreaterThan, &&op_AB_GreaterThanEqual, &&op_AB_Equal, &&op_AB_NotEqual,
+		&&op_AB_BitAnd, &&op_AB_BitXOr, &&op_AB_BitOr,
+		&&op_AB_CALL, &&op_AB_CALLFS, &&op_AB_STACK, &&op_AB_INT, &&op_AB_BOOL, &&op_AB_STRING, &&op_AB_CPROPLIST,
+		&&op_AB_CARRAY, &&op_AB_CFUNCTION, &&op_AB_NIL, &&op_AB_NEW_ARRAY, &&op_AB_NEW_PROPLIST,
+		&&op_AB_JUMP, &&op_AB_JUMPAND, &&op_AB_JUMPOR, &&op_AB_JUMPNNIL, &&op_AB_CONDN, &&op_AB_COND,
+		&&op_AB_FOREACH_NEXT, &&op_AB_RETURN, &&op_AB_ERR, &&op_AB_DEBUG, &&op_AB_EOFN,
+		&&op_AB_LOCALN_PROP, &&op_AB_INT_Sum, &&op_AB_DUP_INT_LessThan_COND
+	};
+	static_assert(sizeof(DispatchTable) / sizeof(*DispatchTable) == AB_DUP_INT_LessThan_COND + 1, "DispatchTable doesn't match C4AulBCCType");
+#endif
 	try
 	{
 
 		for (;;)
 		{
-
-			bool fJump = false;
+			// Without computed gotos, each chunk continues the loop; otherwise, the
+			// switch is only used to enter the first chunk
 			switch (pCPos->bccType)
 			{
-			case AB_INT:
+			AUL_OP(AB_INT):
 				PushInt(pCPos->Par.i);
-				break;
+				AUL_NEXT;
 
-			case AB_BOOL:
+			AUL_OP(AB_BOOL):
 				PushBool(!!pCPos->Par.i);
-				break;
+				AUL_NEXT;
 
-			case AB_STRING:
+			AUL_OP(AB_STRING):
 				PushString(pCPos->Par.s);
-				break;
+				AUL_NEXT;
 
-			case AB_CPROPLIST:
+			AUL_OP(AB_CPROPLIST):
 				PushPropList(pCPos->Par.p);
-				break;
+				AUL_NEXT;
 
-			case AB_CARRAY:
+			AUL_OP(AB_CARRAY):
 				PushArray(pCPos->Par.a);
-				break;
+				AUL_NEXT;
 
-			case AB_CFUNCTION:
+			AUL_OP(AB_CFUNCTION):
 				PushFunction(pCPos->Par.f);
-				break;
+				AUL_NEXT;
 
-			case AB_NIL:
+			AUL_OP(AB_NIL):
 				PushValue(C4VNull);
-				break;
+				AUL_NEXT;
 
-			case AB_DUP:
+			AUL_OP(AB_DUP):
 				PushValue(pCurVal[pCPos->Par.i]);
-				break;
-			case AB_STACK_SET:
+				AUL_NEXT;
+			AUL_OP(AB_STACK_SET):
 				pCurVal[pCPos->Par.i] = pCurVal[0];
-				break;
-			case AB_POP_TO:
+				AUL_NEXT;
+			AUL_OP(AB_POP_TO):
 				pCurVal[pCPos->Par.i] = pCurVal[0];
 				PopValue();
-				break;
+				AUL_NEXT;
 
-			case AB_EOFN:
+			AUL_OP(AB_EOFN):
 				throw C4AulExecError("internal error: function didn't return");
 
-			case AB_ERR:
+			AUL_OP(AB_ERR):
 				if (pCPos->Par.s)
 					throw C4AulExecError((std::string("syntax error: ") + pCPos->Par.s->GetCStr()).c_str());
 				else
 					throw C4AulExecError("syntax error: see above for details");
 
-			case AB_DUP_CONTEXT:
+			AUL_OP(AB_DUP_CONTEXT):
 				PushValue(AulExec.GetContext(AulExec.GetContextDepth()-2)->Pars[pCPos->Par.i]);
-				break;
+				AUL_NEXT;
 
-			case AB_LOCALN:
+			AUL_OP(AB_LOCALN):
 				if (!pCurCtx->Obj)
 					throw C4AulExecError("can't access local variables without this");
 				PushNullVals(1);
-				pCurCtx->Obj->GetPropertyByS(pCPos->Par.s, pCurVal);
-				break;
-			case AB_LOCALN_SET:
+				pCurCtx->Obj->GetPropertyByS(pCPos->Par.s, pCurVal, pCPos->PropertyHint);
+				AUL_NEXT;
+			AUL_OP(AB_LOCALN_SET):
 				if (!pCurCtx->Obj)
 					throw C4AulExecError("can't access local variables without this");
 				if (pCurCtx->Obj->IsFrozen())
 					throw C4AulExecError("local variable: this is readonly");
 				pCurCtx->Obj->SetPropertyByS(pCPos->Par.s, pCurVal[0]);
-				break;
+				AUL_NEXT;
 
-			case AB_PROP:
+			AUL_OP(AB_PROP):
 				if (!pCurVal->CheckConversion(C4V_PropList))
 					throw C4AulExecError(FormatString("proplist access: proplist expected, got %s", pCurVal->GetTypeName()).getData());
-				if (!pCurVal->_getPropList()->GetPropertyByS(pCPos->Par.s, pCurVal))
+				if (!pCurVal->_getPropList()->GetPropertyByS(pCPos->Par.s, pCurVal, pCPos->PropertyHint))
 					pCurVal->Set0();
-				break;
-			case AB_PROP_SET:
+				AUL_NEXT;
+			AUL_OP(AB_PROP_SET):
 			{
 				C4Value *pPropList = pCurVal - 1;
 				if (!pPropList->CheckConversion(C4V_PropList))
@@ -283,46 +315,46 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos)
 				pPropList->_getPropList()->SetPropertyByS(pCPos->Par.s, pCurVal[0]);
 				pPropList->Set(pCurVal[0]);
 				PopValue();
-				break;
+				AUL_NEXT;
 			}
 
-			case AB_GLOBALN:
+			AUL_OP(AB_GLOBALN):
 				PushValue(*::ScriptEngine.GlobalNamed.GetItem(pCPos->Par.i));
-				break;
-			case AB_GLOBALN_SET:
+				AUL_NEXT;
+			AUL_OP(AB_GLOBALN_SET):
 				::ScriptEngine.GlobalNamed.GetItem(pCPos->Par.i)->Set(pCurVal[0]);
-				break;
+				AUL_NEXT;
 				
 			// prefix
-			case AB_BitNot: // ~
+			AUL_OP(AB_BitNot): // ~
 				CheckOpPar(C4V_Int, "~");
 				pCurVal->SetInt(~pCurVal->_getInt());
-				break;
-			case AB_Not:  // !
+				AUL_NEXT;
+			AUL_OP(AB_Not):  // !
 				pCurVal->SetBool(!pCurVal->getBool());
-				break;
-			case AB_Neg:  // -
+				AUL_NEXT;
+			AUL_OP(AB_Neg):  // -
 				CheckOpPar(C4V_Int, "-");
 				pCurVal->SetInt(-pCurVal->_getInt());
-				break;
-			case AB_Inc: // ++
+				AUL_NEXT;
+			AUL_OP(AB_Inc): // ++
 				CheckOpPar(C4V_Int, "++");
 				pCurVal->SetInt(pCurVal->_getInt() + 1);
-				break;
-			case AB_Dec: // --
+				AUL_NEXT;
+			AUL_OP(AB_Dec): // --
 				CheckOpPar(C4V_Int, "--");
 				pCurVal->SetInt(pCurVal->_getInt() - 1);
-				break;
+				AUL_NEXT;
 			// postfix
-			case AB_Pow:  // **
+			AUL_OP(AB_Pow):  // **
 			{
 				CheckOpPars(C4V_Int, C4V_Int, "**");
 				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
 				pPar1->SetInt(Pow(pPar1->_getInt(), pPar2->_getInt()));
 				PopValue();
-				break;
+				AUL_NEXT;
 			}
-			case AB_Div:  // /
+			AUL_OP(AB_Div):  // /
 			{
 				CheckOpPars(C4V_Int, C4V_Int, "/");
 				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
@@ -333,17 +365,17 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos)
 					throw C4AulExecError("division overflow");
 				pPar1->SetInt(pPar1->_getInt() / pPar2->_getInt());
 				PopValue();
-				break;
+				AUL_NEXT;
 			}
-			case AB_Mul:  // *
+			AUL_OP(AB_Mul):  // *
 			{
 				CheckOpPars(C4V_Int, C4V_Int, "*");
 				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
 				pPar1->SetInt(pPar1->_getInt() * pPar2->_getInt());
 				PopValue();
-				break;
+				AUL_NEXT;
 			}
-			case AB_Mod:  // %
+			AUL_OP(AB_Mod):  // %
 			{
 				CheckOpPars(C4V_Int, C4V_Int, "%");
 				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
@@ -355,112 +387,112 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos)
 				else
 					pPar1->Set0();
 				PopValue();
-				break;
+				AUL_NEXT;
 			}
-			case AB_Sub:  // -
+			AUL_OP(AB_Sub):  // -
 			{
 				CheckOpPars(C4V_Int, C4V_Int, "-");
 				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
 				pPar1->SetInt(pPar1->_getInt() - pPar2->_getInt());
 				PopValue();
-				break;
+				AUL_NEXT;
 			}
-			case AB_Sum:  // +
+			AUL_OP(AB_Sum):  // +
 			{
 				CheckOpPars(C4V_Int, C4V_Int, "+");
 				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
 				pPar1->SetInt(pPar1->_getInt() + pPar2->_getInt());
 				PopValue();
-				break;
+				AUL_NEXT;
 			}
-			case AB_LeftShift:  // <<
+			AUL_OP(AB_LeftShift):  // <<
 			{
 				CheckOpPars(C4V_Int, C4V_Int, "<<");
 				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
 				pPar1->SetInt(pPar1->_getInt() << pPar2->_getInt());
 				PopValue();
-				break;
+				AUL_NEXT;
 			}
-			case AB_RightShift: // >>
+			AUL_OP(AB_RightShift): // >>
 			{
 				CheckOpPars(C4V_Int, C4V_Int, ">>");
 				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
 				pPar1->SetInt(pPar1->_getInt() >> pPar2->_getInt());
 				PopValue();
-				break;
+				AUL_NEXT;
 			}
-			case AB_LessThan: // <
+			AUL_OP(AB_LessThan): // <
 			{
 				CheckOpPars(C4V_Int, C4V_Int, "<");
 				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
 				pPar1->SetBool(pPar1->_getInt() < pPar2->_getInt());
 				PopValue();
-				break;
+				AUL_NEXT;
 			}
-			case AB_LessThanEqual:  // <=
+			AUL_OP(AB_LessThanEqual):  // <=
 			{
 				CheckOpPars(C4V_Int, C4V_Int, "<=");
 				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
 				pPar1->SetBool(pPar1->_getInt() <= pPar2->_getInt());
 				PopValue();
-				break;
+				AUL_NEXT;
 			}
-			case AB_GreaterThan:  // >
+			AUL_OP(AB_GreaterThan):  // >
 			{
 				CheckOpPars(C4V_Int, C4V_Int, ">");
 				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
 				pPar1->SetBool(pPar1->_getInt() > pPar2->_getInt());
 				PopValue();
-				break;
+				AUL_NEXT;
 			}
-			case AB_GreaterThanEqual: // >=
+			AUL_OP(AB_GreaterThanEqual): // >=
 			{
 				CheckOpPars(C4V_Int, C4V_Int, ">=");
 				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
 				pPar1->SetBool(pPar1->_getInt() >= pPar2->_getInt());
 				PopValue();
-				break;
+				AUL_NEXT;
 			}
-			case AB_Equal:  // ==
+			AUL_OP(AB_Equal):  // ==
 			{
 				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
 				pPar1->SetBool(pPar1->IsIdenticalTo(*pPar2));
 				PopValue();
-				break;
+				AUL_NEXT;
 			}
-			case AB_NotEqual: // !=
+			AUL_OP(AB_NotEqual): // !=
 			{
 				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
 				pPar1->SetBool(!pPar1->IsIdenticalTo(*pPar2));
 				PopValue();
-				break;
+				AUL_NEXT;
 			}
-			case AB_BitAnd: // &
+			AUL_OP(AB_BitAnd): // &
 			{
 				CheckOpPars(C4V_Int, C4V_Int, "&");
 				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
 				pPar1->SetInt(pPar1->_getInt() & pPar2->_getInt());
 				PopValue();
-				break;
+				AUL_NEXT;
 			}
-			case AB_BitXOr: // ^
+			AUL_OP(AB_BitXOr): // ^
 			{
 				CheckOpPars(C4V_Int, C4V_Int, "^");
 				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
 				pPar1->SetInt(pPar1->_getInt() ^ pPar2->_getInt());
 				PopValue();
-				break;
+				AUL_NEXT;
 			}
-			case AB_BitOr:  // |
+			AUL_OP(AB_BitOr):  // |
 			{
 				CheckOpPars(C4V_Int, C4V_Int, "|");
 				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
 				pPar1->SetInt(pPar1->_getInt() | pPar2->_getInt());
 				PopValue();
-				break;
+				AUL_NEXT;
 			}
 
-			case AB_NEW_ARRAY:
+			AUL_OP(AB_NEW_ARRAY):
 			{
 				// Create array
 				C4ValueArray *pArray = new C4ValueArray(pCPos->Par.i);
@@ -473,10 +505,10 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos)
 				PopValues(pCPos->Par.i);
 				PushArray(pArray);
 
-				break;
+				AUL_NEXT;
 			}
 
-			case AB_NEW_PROPLIST:
+			AUL_OP(AB_NEW_PROPLIST):
 			{
 				C4PropList * pPropList = C4PropList::New();
 
@@ -485,10 +517,10 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos)
 
 				PopValues(pCPos->Par.i * 2);
 				PushPropList(pPropList);
-				break;
+				AUL_NEXT;
 			}
 
-			case AB_ARRAYA:
+			AUL_OP(AB_ARRAYA):
 			{
 				C4Value *pIndex = pCurVal, *pStruct = pCurVal - 1, *pResult = pCurVal - 1;
 				// Typcheck to determine whether it's an array or a proplist
@@ -505,9 +537,9 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos)
 				}
 				// Remove index
 				PopValue();
-				break;
+				AUL_NEXT;
 			}
-			case AB_ARRAYA_SET:
+			AUL_OP(AB_ARRAYA_SET):
 			{
 				C4Value *pValue = pCurVal, *pIndex = pCurVal - 1, *pStruct = pCurVal - 2, *pResult = pCurVal - 2;
 				// Typcheck to determine whether it's an array or a proplist
@@ -528,9 +560,9 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos)
 				// Set result, remove array and index from stack
 				*pResult = *pValue;
 				PopValues(2);
-				break;
+				AUL_NEXT;
 			}
-			case AB_ARRAY_SLICE:
+			AUL_OP(AB_ARRAY_SLICE):
 			{
 				C4Value &Array = pCurVal[-2];
 				C4Value &StartIndex = pCurVal[-1];
@@ -548,10 +580,10 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos)
 
 				// Remove both indices
 				PopValues(2);
-				break;
+				AUL_NEXT;
 			}
 
-			case AB_ARRAY_SLICE_SET:
+			AUL_OP(AB_ARRAY_SLICE_SET):
 			{
 				C4Value &Array = pCurVal[-3];
 				C4Value &StartIndex = pCurVal[-2];
@@ -573,78 +605,66 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos)
 				// Set value as result, remove both indices and first copy of value
 				Array = Value;
 				PopValues(3);
-				break;
+				AUL_NEXT;
 			}
 
-			case AB_STACK:
+			AUL_OP(AB_STACK):
 				if (pCPos->Par.i < 0)
 					PopValues(-pCPos->Par.i);
 				else
 					PushNullVals(pCPos->Par.i);
-				break;
+				AUL_NEXT;
 
-			case AB_JUMP:
-				fJump = true;
+			AUL_OP(AB_JUMP):
 				pCPos += pCPos->Par.i;
-				break;
+				AUL_DISPATCH;
 
-			case AB_JUMPAND:
+			AUL_OP(AB_JUMPAND):
 				if (!pCurVal[0])
 				{
-					fJump = true;
 					pCPos += pCPos->Par.i;
+					AUL_DISPATCH;
 				}
-				else
-				{
-					PopValue();
-				}
-				break;
+				PopValue();
+				AUL_NEXT;
 
-			case AB_JUMPOR:
+			AUL_OP(AB_JUMPOR):
 				if (!!pCurVal[0])
 				{
-					fJump = true;
 					pCPos += pCPos->Par.i;
+					AUL_DISPATCH;
 				}
-				else
-				{
-					PopValue();
-				}
-				break;
+				PopValue();
+				AUL_NEXT;
 
-			case AB_JUMPNNIL: // ??
+			AUL_OP(AB_JUMPNNIL): // ??
 			{
 				if (pCurVal[0].GetType() != C4V_Nil)
 				{
-					fJump = true;
 					pCPos += pCPos->Par.i;
+					AUL_DISPATCH;
 				}
-				else
-				{
-					PopValue();
-				}
-				break;
+				PopValue();
+				AUL_NEXT;
 			}
 
-			case AB_CONDN:
-				if (!pCurVal[0])
-				{
-					fJump = true;
-					pCPos += pCPos->Par.i;
-				}
+			AUL_OP(AB_CONDN):
+			{
+				bool fJump = !pCurVal[0];
 				PopValue();
-				break;
+				pCPos += fJump ? pCPos->Par.i : 1;
+				AUL_DISPATCH;
+			}
 
-			case AB_COND:
-				if (pCurVal[0])
-				{
-					fJump = true;
-					pCPos += pCPos->Par.i;
-				}
+			AUL_OP(AB_COND):
+			{
+				bool fJump = !!pCurVal[0];
 				PopValue();
-				break;
+				pCPos += fJump ? pCPos->Par.i : 1;
+				AUL_DISPATCH;
+			}
 
-			case AB_RETURN:
+			AUL_OP(AB_RETURN):
 			{
 				// Trace
 				if (iTraceStart >= 0)
@@ -678,12 +698,10 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos)
 
 				// Jump back, continue.
 				pCPos = pCurCtx->CPos + 1;
-				fJump = true;
-
-				break;
+				AUL_DISPATCH;
 			}
 
-			case AB_FUNC:
+			AUL_OP(AB_FUNC):
 			{
 				// Get function call data
 				C4AulFunc *pFunc = pCPos->Par.f;
@@ -696,12 +714,12 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos)
 				if (pJump)
 				{
 					pCPos = pJump;
-					fJump = true;
+					AUL_DISPATCH;
 				}
-				break;
+				AUL_NEXT;
 			}
 
-			case AB_PAR:
+			AUL_OP(AB_PAR):
 				if (!pCurVal->CheckConversion(C4V_Int))
 					throw C4AulExecError(FormatString("Par: index of type %s, int expected", pCurVal->GetTypeName()).getData());
 				// Push reference to parameter on the stack
@@ -709,16 +727,16 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos)
 					pCurVal->Set(pCurCtx->Pars[pCurVal->_getInt()]);
 				else
 					pCurVal->Set0();
-				break;
+				AUL_NEXT;
 
-			case AB_THIS:
+			AUL_OP(AB_THIS):
 				if (!pCurCtx->Obj || !pCurCtx->Obj->Status)
 					PushNullVals(1);
 				else
 					PushPropList(pCurCtx->Obj);
-				break;
+				AUL_NEXT;
 
-			case AB_FOREACH_NEXT:
+			AUL_OP(AB_FOREACH_NEXT):
 			{
 				// This should always hold
 				assert(pCurVal->CheckConversion(C4V_Int));
@@ -732,19 +750,18 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos)
 				C4ValueArray *pArray = pCurVal[-1]._getArray();
 				// No more entries?
 				if (pCurVal->_getInt() >= pArray->GetSize())
-					break;
+					AUL_NEXT;
 				// Get next
 				pCurVal[pCPos->Par.i] = pArray->GetItem(iItem);
 				// Save position
 				pCurVal->SetInt(iItem + 1);
 				// Jump over next instruction
 				pCPos += 2;
-				fJump = true;
-				break;
+				AUL_DISPATCH;
 			}
 
-			case AB_CALL:
-			case AB_CALLFS:
+			AUL_OP(AB_CALL):
+			AUL_OP(AB_CALLFS):
 			{
 
 				C4Value *pPars = pCurVal - C4AUL_MAX_Par + 1;
@@ -759,12 +776,12 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos)
 					throw C4AulExecError(FormatString("'->': invalid target type %s, expected proplist", pTargetVal->GetTypeName()).getData());
 
 				// Search function for given context
-				C4AulFunc * pFunc = pDest->GetFunc(pCPos->Par.s);
+				C4AulFunc * pFunc = pDest->GetFunc(pCPos->Par.s, pCPos->PropertyHint);
 				if (!pFunc && pCPos->bccType == AB_CALLFS)
 				{
 					PopValuesUntil(pTargetVal);
 					pTargetVal->Set0();
-					break;
+					AUL_NEXT;
 				}
 
 				// Function not found?
@@ -787,23 +804,64 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos)
 				{
 					// Jump
 					pCPos = pNewCPos;
-					fJump = true;
+					AUL_DISPATCH;
+				}
+
+				AUL_NEXT;
+			}
+
+			// superinstructions
+			AUL_OP(AB_LOCALN_PROP):
+				if (!pCurCtx->Obj)
+					throw C4AulExecError("can't access local variables without this");
+				PushNullVals(1);
+				pCurCtx->Obj->GetPropertyByS(pCPos->Par.s, pCurVal, pCPos->PropertyHint);
+				// PROP
+				++pCPos;
+				if (!pCurVal->CheckConversion(C4V_PropList))
+					throw C4AulExecError(FormatString("proplist access: proplist expected, got %s", pCurVal->GetTypeName()).getData());
+				if (!pCurVal->_getPropList()->GetPropertyByS(pCPos->Par.s, pCurVal, pCPos->PropertyHint))
+					pCurVal->Set0();
+				AUL_NEXT;
+
+			AUL_OP(AB_INT_Sum):
+				// let Sum report type errors
+				if (!pCurVal->CheckParConversion(C4V_Int))
+				{
+					PushInt(pCPos->Par.i);
+					AUL_NEXT;
 				}
+				pCurVal->SetInt(pCurVal->_getInt() + pCPos->Par.i);
+				pCPos += 2;
+				AUL_DISPATCH;
 
-				break;
+			AUL_OP(AB_DUP_INT_LessThan_COND):
+			{
+				// let LessThan report type errors
+				const C4Value &Val = pCurVal[pCPos->Par.i];
+				if (!Val.CheckParConversion(C4V_Int))
+				{
+					PushValue(Val);
+					AUL_NEXT;
+				}
+				bool fCond = Val._getInt() < pCPos[1].Par.i;
+				// COND or CONDN
+				pCPos += 3;
+				pCPos += fCond == (pCPos->bccType == AB_COND) ? pCPos->Par.i : 1;
+				AUL_DISPATCH;
 			}
 
-			case AB_DEBUG:
+			AUL_OP(AB_DEBUG):
 #ifndef NOAULDEBUG
 				if (C4AulDebug *pDebug = C4AulDebug::GetDebugger())
 					pDebug->DebugStep(pCPos, pCurVal);
 #endif
-				break;
+				AUL_NEXT;
 			}
 
-			// Continue
-			if (!fJump)
-				pCPos++;
+			// All chunks continue by themselves
+			assert(!"C4AulExec::Exec: unknown bytecode");
+			throw C4AulExecError("internal error: unknown bytecode");
 		}
 
 	}
@@ -885,6 +943,7 @@ C4AulBCC *C4AulExec::Call(C4AulFunc *pFunc, C4Value *pReturn, C4Value *pPars, C4
 #ifdef _DEBUG
 		C4AulScriptContext *pCtx = pCurCtx;
 #endif
+		C4TraceScope TraceScope("Engine", pFunc->GetName(), true);
 		if (pReturn > pCurVal)
 			PushValue(pFunc->Exec(pContext, pPars, true));
 		else
@@ -936,6 +995,9 @@ void C4AulExec::PushContext(const C4AulScriptContext &rContext)
 	}
 	// Profiler: Safe time to measure difference afterwards
 	if (fProfiling) pCurCtx->tTime = C4TimeMilliseconds::Now();
+	// Trace span per script function call
+	pCurCtx->Traced = C4Trace::IsEnabled();
+	if (pCurCtx->Traced) C4Trace::BeginSpan("Script", pCurCtx->Func ? pCurCtx->Func->GetName() : "DirectExec", true);
 }
 
 void C4AulExec::PopContext()
@@ -957,6 +1019,7 @@ void C4AulExec::PopContext()
 			iTraceStart = -1;
 		}
 	}
+	if (pCurCtx->Traced) C4Trace::EndSpan();
 	pCurCtx--;
 }
 
@@ -46,6 +46,7 @@ struct C4AulScriptContext
 	C4AulScriptFunc *Func;
 	C4AulBCC *CPos;
 	C4TimeMilliseconds tTime; // initialized only by profiler if active
+	bool Traced; // set by PushContext if a trace span was opened for this call
 
 	void dump(StdStrBuf Dump = StdStrBuf(""));
 	StdStrBuf ReturnDump(StdStrBuf Dump = StdStrBuf(""));
@@ -589,6 +589,10 @@ static const char * GetTTName(C4AulBCCType e)
 	case AB_ERR: return "ERR";      // parse error at this position
 	case AB_DEBUG: return "DEBUG";      // debug break
 	case AB_EOFN: return "EOFN";    // end of function
+
+	case AB_LOCALN_PROP: return "LOCALN_PROP";
+	case AB_INT_Sum: return "INT_Sum";
+	case AB_DUP_INT_LessThan_COND: return "DUP_INT_LessThan_COND";
 	}
 	assert(false); return "UNKNOWN";
 }
@@ -622,6 +626,7 @@ void C4AulScriptFunc::DumpByteCode()
 			case AB_ERR:
 				if (bcc.Par.s)
 			case AB_CALL: case AB_CALLFS: case AB_LOCALN: case AB_LOCALN_SET: case AB_PROP: case AB_PROP_SET:
+			case AB_LOCALN_PROP:
 				fprintf(stderr, "\t%s\n", bcc.Par.s->GetCStr()); break;
 			case AB_STRING:
 			{
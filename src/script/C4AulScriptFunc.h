@@ -90,6 +90,13 @@ enum C4AulBCCType : int
 	AB_ERR,     // parse error at this position
 	AB_DEBUG,   // debug break
 	AB_EOFN,    // end of function
+
+// superinstructions: formed by C4AulCompiler after code generation from the
+// chunk sequence they are named after. The following chunks of the sequence
+// stay in place and supply the remaining parameters.
+	AB_LOCALN_PROP, // LOCALN + PROP
+	AB_INT_Sum, // INT + Sum
+	AB_DUP_INT_LessThan_COND, // DUP + INT + LessThan + COND or CONDN
 };
 
 // byte code chunk
@@ -97,6 +104,7 @@ class C4AulBCC
 {
 public:
 	C4AulBCCType bccType{AB_EOFN}; // chunk type
+	unsigned int PropertyHint{0}; // table slot of the last property lookup by this chunk
 	union
 	{
 		intptr_t X;
@@ -144,6 +152,7 @@ private:
 		case AB_ERR:
 			if (Par.s)
 		case AB_STRING: case AB_CALL: case AB_CALLFS: case AB_LOCALN: case AB_LOCALN_SET: case AB_PROP: case AB_PROP_SET:
+		case AB_LOCALN_PROP:
 			Par.s->IncRef();
 			break;
 		case AB_CARRAY:
@@ -159,6 +168,7 @@ private:
 		case AB_ERR:
 			if (Par.s)
 		case AB_STRING: case AB_CALL: case AB_CALLFS: case AB_LOCALN: case AB_LOCALN_SET: case AB_PROP: case AB_PROP_SET:
+		case AB_LOCALN_PROP:
 			Par.s->DecRef();
 			break;
 		case AB_CARRAY:
@@ -772,6 +772,24 @@ bool C4PropList::GetPropertyByS(const C4String * k, C4Value *pResult) const
 		return false;
 }
 
+bool C4PropList::GetPropertyByS(const C4String * k, C4Value *pResult, unsigned int & hint) const
+{
+	// Engine-defined properties can be overloaded by derived classes
+	if (k >= &Strings.P[0] && k < &Strings.P[P_LAST])
+		return GetPropertyByS(k, pResult);
+	// The slot is verified by its key, so a stale hint merely costs the hash lookup
+	for (const C4PropList * p = this; p; p = p->GetPrototype())
+	{
+		const C4Property * prop = p->Properties.GetWithHint(k, hint);
+		if (prop)
+		{
+			*pResult = prop->Value;
+			return true;
+		}
+	}
+	return false;
+}
+
 C4String * C4PropList::GetPropertyStr(C4PropertyName n) const
 {
 	C4String * k = &Strings.P[n];
@@ -814,6 +832,18 @@ C4AulFunc * C4PropList::GetFunc(C4String * k) const
 	return nullptr;
 }
 
+C4AulFunc * C4PropList::GetFunc(C4String * k, unsigned int & hint) const
+{
+	assert(k);
+	for (const C4PropList * p = this; p; p = p->GetPrototype())
+	{
+		const C4Property * prop = p->Properties.GetWithHint(k, hint);
+		if (prop)
+			return prop->Value.getFunction();
+	}
+	return nullptr;
+}
+
 C4AulFunc * C4PropList::GetFunc(const char * s) const
 {
 	assert(s);
@@ -96,6 +96,10 @@ public:
 	// not allowed on frozen proplists
 	virtual void SetPropertyByS(C4String * k, const C4Value & to);
 	virtual void ResetProperty(C4String * k);
+	// Lookup for script byte code: hint remembers the table slot where the property
+	// was found last time, so that repeated reads from proplists with the same
+	// layout (e.g. objects of one definition) usually skip hashing.
+	bool GetPropertyByS(const C4String *k, C4Value *pResult, unsigned int & hint) const;
 
 	// helper functions to get dynamic properties from other parts of the engine
 	bool GetProperty(C4PropertyName k, C4Value *pResult) const
@@ -105,6 +109,7 @@ public:
 	C4AulFunc * GetFunc(C4PropertyName k) const
 	{ return GetFunc(&Strings.P[k]); }
 	C4AulFunc * GetFunc(C4String * k) const;
+	C4AulFunc * GetFunc(C4String * k, unsigned int & hint) const;
 	C4AulFunc * GetFunc(const char * k) const;
 	C4String * EnumerateOwnFuncs(C4String * prev = nullptr) const;
 	C4Value Call(C4PropertyName k, C4AulParSet *pPars=nullptr, bool fPassErrors=false)
@@ -216,6 +216,22 @@ public:
 		}
 		return !!*r;
 	}
+	// Like Get, but tries the slot remembered in hint before hashing, and
+	// remembers the slot where e was found. Returns nullptr if e is not in the set.
+	template<typename H> T * GetWithHint(H e, unsigned int & hint) const
+	{
+		if (hint < Capacity && Table[hint] && Equals(Table[hint], e))
+			return &Table[hint];
+		unsigned int h = Hash(e);
+		T * r = &Table[h % Capacity];
+		while (*r && !Equals(*r, e))
+		{
+			r = &Table[++h % Capacity];
+		}
+		if (!*r) return nullptr;
+		hint = r - Table;
+		return r;
+	}
 	unsigned int GetSize() const { return Size; }
 	T * Add(T const & e)
 	{
@@ -382,6 +382,14 @@ void C4Value::CompileFunc(StdCompiler *pComp, C4ValueNumbers * numbers)
 				assert(p->GetFunc(Data.Fn->GetName()) == Data.Fn);
 				assert(p->IsStatic());
 			}
+			if (!pComp->hasNaming())
+			{
+				// binary compilers have no separators to stop at
+				int32_t iParts = getFunction() ? 2 : 1;
+				for (const C4PropListStatic *pParent = p->IsStatic()->GetParent(); pParent; pParent = pParent->GetParent())
+					++iParts;
+				pComp->Value(iParts);
+			}
 			p->IsStatic()->RefCompileFunc(pComp, numbers);
 			if (getFunction())
 			{
@@ -394,10 +402,13 @@ void C4Value::CompileFunc(StdCompiler *pComp, C4ValueNumbers * numbers)
 		{
 			StdStrBuf s;
 			C4Value temp;
+			int32_t iParts = 0;
+			if (!pComp->hasNaming())
+				pComp->Value(iParts);
 			pComp->Value(mkParAdapt(s, StdCompiler::RCT_ID));
 			if (!::ScriptEngine.GetGlobalConstant(s.getData(), &temp))
 				pComp->excCorrupt("Cannot find global constant %s", s.getData());
-			while(pComp->Separator(StdCompiler::SEP_PART))
+			while(pComp->hasNaming() ? pComp->Separator(StdCompiler::SEP_PART) : --iParts > 0)
 			{
 				C4PropList * p = temp.getPropList();
 				if (!p)
@@ -0,0 +1,160 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2016, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+// Micro-benchmarks of the C4Aul interpreter. Not run as part of the test
+// suite; build the aul_benchmark target and run it directly.
+
+#include <C4Include.h>
+
+#include <chrono>
+#include <gtest/gtest.h>
+
+#include "script/C4ScriptHost.h"
+#include "lib/C4Random.h"
+
+class AulBenchmark : public ::testing::Test
+{
+protected:
+	// Runs Main() of the script a few times and reports the best time per loop iteration
+	C4Value Measure(const std::string &code, int iterations);
+
+	static const int Iterations = 1000000;
+	static const int Repetitions = 5;
+};
+
+C4Value AulBenchmark::Measure(const std::string &code, int iterations)
+{
+	InitCoreFunctionMap(&ScriptEngine);
+	FixedRandom(0x40490fdb);
+
+	auto test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+	std::string src = std::string("<") + test_info->test_case_name() + "::" + test_info->name() + ">";
+	std::string script = "static const Iterations = " + std::to_string(iterations) + ";\n" + code;
+	GameScript.LoadData(src.c_str(), script.c_str(), nullptr);
+	ScriptEngine.Link(nullptr);
+
+	C4Value result;
+	double best = 0;
+	for (int i = 0; i < Repetitions; ++i)
+	{
+		auto start = std::chrono::steady_clock::now();
+		result = GameScript.Call("Main", nullptr, true);
+		std::chrono::duration<double, std::nano> time = std::chrono::steady_clock::now() - start;
+		if (!i || time.count() < best)
+			best = time.count();
+	}
+
+	GameScript.Clear();
+	ScriptEngine.Clear();
+
+	double per_iteration = best / iterations;
+	std::cout << test_info->name() << ": " << per_iteration << " ns per iteration" << std::endl;
+	RecordProperty("ns_per_iteration", std::to_string(per_iteration));
+	return result;
+}
+
+TEST_F(AulBenchmark, EmptyLoop)
+{
+	EXPECT_EQ(C4VInt(Iterations), Measure(R"(
+func Main() {
+	var i;
+	for (i = 0; i < Iterations; ++i);
+	return i;
+})", Iterations));
+}
+
+TEST_F(AulBenchmark, Arithmetic)
+{
+	Measure(R"(
+func Main() {
+	var x = 0;
+	for (var i = 0; i < Iterations; ++i)
+		x = (x + 7) * 3 % 1000 - i / 3;
+	return x;
+})", Iterations);
+}
+
+TEST_F(AulBenchmark, LocalProperty)
+{
+	EXPECT_EQ(C4VInt(2 * Iterations), Measure(R"(
+local data;
+func Main() {
+	data = { value = 2 };
+	var sum = 0;
+	for (var i = 0; i < Iterations; ++i)
+		sum += data.value;
+	return sum;
+})", Iterations));
+}
+
+TEST_F(AulBenchmark, PrototypeProperty)
+{
+	EXPECT_EQ(C4VInt(2 * Iterations), Measure(R"(
+func Main() {
+	var proto = { value = 2, a = 0, b = 0, c = 0 };
+	var objs = [new proto { x = 0 }, new proto { x = 1 }, new proto { x = 2 }, new proto { x = 3 }];
+	var sum = 0;
+	for (var i = 0; i < Iterations; ++i)
+		sum += objs[i % 4].value;
+	return sum;
+})", Iterations));
+}
+
+TEST_F(AulBenchmark, ArrayAccess)
+{
+	Measure(R"(
+func Main() {
+	var a = [1, 2, 3, 4, 5, 6, 7, 8], sum = 0;
+	for (var i = 0; i < Iterations; ++i)
+		sum += a[i % 8];
+	return sum;
+})", Iterations);
+}
+
+TEST_F(AulBenchmark, ForEach)
+{
+	Measure(R"(
+func Main() {
+	var a = CreateArray(1000), sum = 0;
+	for (var i = 0; i < 1000; ++i) a[i] = i;
+	for (var j = 0; j < Iterations / 1000; ++j)
+		for (var v in a)
+			sum += v;
+	return sum;
+})", Iterations);
+}
+
+TEST_F(AulBenchmark, ScriptCall)
+{
+	Measure(R"(
+func Add(a, b) { return a + b; }
+func Main() {
+	var sum = 0;
+	for (var i = 0; i < Iterations; ++i)
+		sum = Add(sum, 1);
+	return sum;
+})", Iterations);
+}
+
+TEST_F(AulBenchmark, EngineCall)
+{
+	Measure(R"(
+func Main() {
+	var sum = 0;
+	for (var i = 0; i < Iterations; ++i)
+		sum += Abs(i - 500);
+	return sum;
+})", Iterations);
+}
@@ -285,3 +285,40 @@ TEST_F(AulTest, Conditionals)
 	EXPECT_EQ(C4VInt(1), RunCode("if (true) return 1; else return 2;"));
 	EXPECT_EQ(C4VInt(2), RunCode("if (false) return 1; else return 2;"));
 }
+
+TEST_F(AulTest, Superinstructions)
+{
+	// DUP + INT + LessThan + CONDN/COND
+	EXPECT_EQ(C4VInt(10), RunCode("var j = 0; for (var i = -5; i < 5; ++i) ++j; return j;"));
+	EXPECT_EQ(C4VInt(1), RunCode("var i; if (i < 5) return 1; return 0;"));
+	EXPECT_EQ(C4VInt(1), RunCode("var i = true; if (i < 5) return 1; return 0;"));
+	EXPECT_EQ(C4VInt(0), RunCode("var i = 5; if (i < 5) return 1; return 0;"));
+	EXPECT_EQ(C4VInt(5), RunCode("var i = 0; do ++i; while (i < 5); return i;"));
+	EXPECT_THROW(RunCode("var i = \"a\"; if (i < 5) return 1; return 0;"), C4AulExecError);
+	// INT + Sum
+	EXPECT_EQ(C4VInt(7), RunCode("var a = 3; return a + 4;"));
+	EXPECT_EQ(C4VInt(4), RunCode("var a; return a + 4;"));
+	EXPECT_EQ(C4VINT_MIN, RunCode("var a = 2147483647; return a + 1 + 0;"));
+	EXPECT_THROW(RunCode("var a = \"x\"; return a + 4;"), C4AulExecError);
+	// a jump target inside the sequence prevents fusing
+	EXPECT_EQ(C4VInt(3), RunCode("var a = 1, b = 2; return a + (b ?? 5);"));
+	EXPECT_EQ(C4VInt(6), RunCode("var a = 1, b; return a + (b ?? 5);"));
+	// LOCALN + PROP
+	EXPECT_EQ(C4VInt(42), RunScript("local p = { i = 42 }; func Main() { return p.i + 0; }"));
+	EXPECT_EQ(C4Value(), RunScript("local p = { }; func Main() { return p.i; }"));
+	EXPECT_THROW(RunScript("local p; func Main() { return p.i; }"), C4AulExecError);
+}
+
+TEST_F(AulTest, PropertyHints)
+{
+	// the same PROP chunk reads from differently laid out proplists
+	EXPECT_EQ(C4VInt(6), RunCode("var r = 0; for (var p in [{ a = 1 }, { b = 0, a = 2 }, { c = 0, d = 0, e = 0, a = 3 }]) r += p.a; return r;"));
+	// property is first found in the prototype, then added to the proplist itself
+	EXPECT_EQ(C4VInt(432), RunCode("var proto = { a = 4 }; var p = new proto { }; var r = 0; for (var i = 0; i < 3; ++i) { r = r * 10 + p.a; if (i == 0) p.a = 3; if (i == 1) p.a = 2; } return r;"));
+	// prototype is replaced
+	EXPECT_EQ(C4VInt(12), RunCode("var proto = { a = 1 }; var p = new proto { }; var r = 0; for (var i = 0; i < 2; ++i) { r = r * 10 + p.a; p.Prototype = { b = 0, a = 2 }; } return r;"));
+	// function calls
+	EXPECT_EQ(C4VInt(3), RunScript("local a = { F = func() { return 1; } }, b = { G = 0, F = func() { return 2; } }; func Main() { var r = 0; for (var p in [a, b]) r += p->F(); return r; }"));
+	// engine-defined property names take the regular lookup
+	EXPECT_EQ(C4VString("Test"), RunCode("var p = { Name = \"Test\" }; return p.Name;"));
+}
@@ -0,0 +1,234 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2016, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+// Micro-benchmark of the particle calculation kernels against the previous
+// layout of one heap-allocated particle with its own value providers each.
+// Not run as part of the test suite; build the particle_benchmark target and
+// run it directly.
+
+#include <C4Include.h>
+
+#include <chrono>
+#include <gtest/gtest.h>
+
+#include "landscape/C4ParticleKernels.h"
+
+namespace
+{
+	const size_t ParticleCount = 100000;
+	const int Frames = 50;
+	const int Repetitions = 5;
+	const size_t BlockSize = 64;
+
+	const float KeyFrameData[] = { -500.f, 0.f, 0.f, 0.f, 0.2f, 1.f, 1.f, 0.f, 1500.f, 0.f };
+	const size_t KeyFrameCount = 5;
+
+	// resembles the old per-particle value provider, including the members that made it large
+	struct LegacyProvider
+	{
+		float startValue = 0.f, endValue = 0.f, currentValue = 0.f;
+		int parameters[2] = { 0, 0 };
+		uint64_t rng[2] = { 0, 0 };
+		size_t keyFrameCount = 0;
+		std::vector<float> keyFrames;
+		float (LegacyProvider::*valueFunction)(float relativeAge) = &LegacyProvider::Const;
+		bool isConstant = true;
+		std::vector<LegacyProvider*> children;
+
+		float GetValue(float relativeAge) { return (this->*valueFunction)(relativeAge); }
+		float Const(float) { return startValue; }
+		float Linear(float relativeAge) { return startValue + (endValue - startValue) * relativeAge; }
+		float KeyFrames(float relativeAge)
+		{
+			float value;
+			C4ParticleKernels::KeyFrames(&relativeAge, &keyFrames[0], keyFrameCount, startValue, &value, 1);
+			return value;
+		}
+	};
+
+	struct LegacyParticle
+	{
+		float speedX, speedY, positionX, positionY, lifetime, startingLifetime;
+		float offsetX, offsetY;
+		// size, stretch, forces, dampings, colors, rotation, phase and collision
+		LegacyProvider size, stretch, forceX, forceY, dampingX, dampingY, r, g, b, alpha, rotation, phase, collisionVertex, collisionDensity;
+		C4ParticleVertex *vertices;
+	};
+
+	struct ParticleSetup
+	{
+		float speedX, speedY, positionX, positionY, lifetime;
+	};
+
+	std::vector<ParticleSetup> MakeSetup()
+	{
+		std::vector<ParticleSetup> setup(ParticleCount);
+		for (size_t i = 0; i < ParticleCount; ++i)
+		{
+			setup[i].speedX = static_cast<float>(i % 17) - 8.f;
+			setup[i].speedY = static_cast<float>(i % 13) - 6.f;
+			setup[i].positionX = static_cast<float>(i % 1000);
+			setup[i].positionY = static_cast<float>(i / 1000);
+			setup[i].lifetime = 100.f + static_cast<float>(i % 50);
+		}
+		return setup;
+	}
+
+	template<class Func>
+	double BestTime(Func &&func)
+	{
+		double best = 0;
+		for (int i = 0; i < Repetitions; ++i)
+		{
+			auto start = std::chrono::steady_clock::now();
+			func();
+			std::chrono::duration<double, std::nano> time = std::chrono::steady_clock::now() - start;
+			if (!i || time.count() < best)
+				best = time.count();
+		}
+		return best;
+	}
+
+	void Report(const char *name, double time)
+	{
+		double perParticle = time / (double(ParticleCount) * Frames);
+		std::cout << name << ": " << perParticle << " ns per particle and frame" << std::endl;
+		::testing::Test::RecordProperty(name, std::to_string(perParticle));
+	}
+}
+
+TEST(ParticleBenchmark, Simulation)
+{
+	const std::vector<ParticleSetup> setup = MakeSetup();
+	const float timeDelta = 1.f;
+
+	// old layout
+	std::vector<LegacyParticle*> legacyParticles(ParticleCount);
+	std::vector<C4ParticleVertex> legacyVertices(ParticleCount * C4ParticleKernels::VerticesPerParticle);
+	auto resetLegacy = [&]()
+	{
+		for (size_t i = 0; i < ParticleCount; ++i)
+		{
+			LegacyParticle *particle = legacyParticles[i];
+			particle->speedX = setup[i].speedX; particle->speedY = setup[i].speedY;
+			particle->positionX = setup[i].positionX; particle->positionY = setup[i].positionY;
+			particle->lifetime = particle->startingLifetime = setup[i].lifetime;
+		}
+	};
+	for (size_t i = 0; i < ParticleCount; ++i)
+	{
+		LegacyParticle *particle = new LegacyParticle();
+		particle->forceY.startValue = 0.1f;
+		particle->dampingX.startValue = particle->dampingY.startValue = 0.95f;
+		particle->size.valueFunction = &LegacyProvider::Linear;
+		particle->size.startValue = 2.f; particle->size.endValue = 10.f;
+		particle->alpha.valueFunction = &LegacyProvider::KeyFrames;
+		particle->alpha.keyFrames.assign(KeyFrameData, KeyFrameData + 2 * KeyFrameCount);
+		particle->alpha.keyFrameCount = KeyFrameCount;
+		particle->r.startValue = particle->g.startValue = particle->b.startValue = 1.f;
+		particle->stretch.startValue = 1.f;
+		particle->vertices = &legacyVertices[i * C4ParticleKernels::VerticesPerParticle];
+		legacyParticles[i] = particle;
+	}
+
+	double legacyTime = BestTime([&]()
+	{
+		resetLegacy();
+		for (int frame = 0; frame < Frames; ++frame)
+		{
+			for (LegacyParticle *particle : legacyParticles)
+			{
+				particle->lifetime -= timeDelta;
+				const float relativeAge = 1.0f - particle->lifetime / particle->startingLifetime;
+				particle->speedX = (particle->speedX + particle->forceX.GetValue(relativeAge)) * particle->dampingX.GetValue(relativeAge);
+				particle->speedY = (particle->speedY + particle->forceY.GetValue(relativeAge)) * particle->dampingY.GetValue(relativeAge);
+				particle->positionX += timeDelta * particle->speedX;
+				particle->positionY += timeDelta * particle->speedY;
+				const float size = particle->size.GetValue(relativeAge);
+				const float rotation = particle->rotation.GetValue(relativeAge);
+				C4ParticleKernels::QuadPositions(&particle->positionX, &particle->positionY, &size, &size, &rotation, &particle->offsetX, &particle->offsetY, nullptr, particle->vertices, 1);
+				const float r = particle->r.GetValue(relativeAge), g = particle->g.GetValue(relativeAge), b = particle->b.GetValue(relativeAge), alpha = particle->alpha.GetValue(relativeAge);
+				C4ParticleKernels::QuadColors(&r, &g, &b, &alpha, particle->vertices, 1);
+			}
+		}
+	});
+	Report("Legacy", legacyTime);
+
+	// structure-of-arrays layout, calculated in blocks
+	std::vector<float> speedX(ParticleCount), speedY(ParticleCount), positionX(ParticleCount), positionY(ParticleCount), lifetime(ParticleCount), startingLifetime(ParticleCount);
+	std::vector<float> offset(ParticleCount, 0.f);
+	std::vector<C4ParticleVertex> vertices(ParticleCount * C4ParticleKernels::VerticesPerParticle);
+	std::vector<uint8_t> blocked(BlockSize, 0);
+
+	double batchedTime = BestTime([&]()
+	{
+		for (size_t i = 0; i < ParticleCount; ++i)
+		{
+			speedX[i] = setup[i].speedX; speedY[i] = setup[i].speedY;
+			positionX[i] = setup[i].positionX; positionY[i] = setup[i].positionY;
+			lifetime[i] = startingLifetime[i] = setup[i].lifetime;
+		}
+		float age[BlockSize], relativeAge[BlockSize], values[BlockSize], size[BlockSize], rotation[BlockSize];
+		float r[BlockSize], g[BlockSize], b[BlockSize], alpha[BlockSize];
+		for (int frame = 0; frame < Frames; ++frame)
+		{
+			for (size_t first = 0; first < ParticleCount; first += BlockSize)
+			{
+				const size_t count = std::min(BlockSize, ParticleCount - first);
+				C4ParticleKernels::Subtract(&lifetime[first], timeDelta, count);
+				C4ParticleKernels::Age(&lifetime[first], &startingLifetime[first], age, relativeAge, count);
+				C4ParticleKernels::Fill(values, 0.1f, count);
+				C4ParticleKernels::Add(&speedY[first], values, count);
+				C4ParticleKernels::Fill(values, 0.95f, count);
+				C4ParticleKernels::Multiply(&speedX[first], values, count);
+				C4ParticleKernels::Multiply(&speedY[first], values, count);
+				C4ParticleKernels::Move(&positionX[first], &speedX[first], &blocked[0], timeDelta, count);
+				C4ParticleKernels::Move(&positionY[first], &speedY[first], &blocked[0], timeDelta, count);
+				C4ParticleKernels::Linear(relativeAge, 2.f, 10.f, size, count);
+				C4ParticleKernels::Fill(rotation, 0.f, count);
+				C4ParticleKernels::QuadPositions(&positionX[first], &positionY[first], size, size, rotation, &offset[first], &offset[first], nullptr, &vertices[first * C4ParticleKernels::VerticesPerParticle], count);
+				C4ParticleKernels::Fill(r, 1.f, count);
+				C4ParticleKernels::Fill(g, 1.f, count);
+				C4ParticleKernels::Fill(b, 1.f, count);
+				C4ParticleKernels::KeyFrames(relativeAge, KeyFrameData, KeyFrameCount, 0.f, alpha, count);
+				C4ParticleKernels::QuadColors(r, g, b, alpha, &vertices[first * C4ParticleKernels::VerticesPerParticle], count);
+			}
+		}
+	});
+	Report("Batched", batchedTime);
+
+	// both have to arrive at the same result
+	for (size_t i = 0; i < ParticleCount; i += 997)
+	{
+		EXPECT_NEAR(legacyParticles[i]->positionX, positionX[i], 1e-3f);
+		EXPECT_NEAR(legacyParticles[i]->positionY, positionY[i], 1e-3f);
+		EXPECT_FLOAT_EQ(legacyVertices[i * 4 + 2].x, vertices[i * 4 + 2].x);
+		EXPECT_FLOAT_EQ(legacyVertices[i * 4 + 3].alpha, vertices[i * 4 + 3].alpha);
+	}
+
+	for (LegacyParticle *particle : legacyParticles)
+		delete particle;
+}
+
+TEST(ParticleBenchmark, KeyFrames)
+{
+	// the kernel has to match a straightforward interpolation between the key frames
+	const float ages[] = { 0.f, 0.1f, 0.2f, 0.6f, 1.f };
+	const float expected[] = { 0.f, 0.5f, 1.f, 0.5f, 0.f };
+	float values[5];
+	C4ParticleKernels::KeyFrames(ages, KeyFrameData, KeyFrameCount, -1.f, values, 5);
+	for (size_t i = 0; i < 5; ++i)
+		EXPECT_FLOAT_EQ(expected[i], values[i]);
+}